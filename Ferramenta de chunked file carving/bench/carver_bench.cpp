@@ -0,0 +1,533 @@
+#include "file_signature.h"
+#include "chunk_reader.h"
+#include "cpu_features.h"
+#include "gap_carver.h"
+#include "thread_pool.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+#include <memory>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Parâmetros da execução dos benchmarks
+ */
+struct BenchConfig {
+    size_t buffer_size = 64 << 20;      // Tamanho dos buffers sintéticos
+    size_t io_size = 256 << 20;         // Tamanho do arquivo dos benchmarks de I/O
+    size_t repeat = 5;                  // Repetições por medida
+    std::string temp_dir = fs::temp_directory_path().string();
+    std::string output_file;            // Vazio = saída padrão
+    std::string filter;                 // Executa só kernels cujo nome contém o filtro
+    bool run_io = true;
+};
+
+/**
+ * @brief Resultado de uma medida
+ */
+struct BenchResult {
+    std::string kernel;
+    std::string dataset;
+    std::string variant;
+    size_t bytes;
+    size_t candidates;
+    double best_seconds;
+    double median_seconds;
+};
+
+/**
+ * @brief Executa uma função repetidas vezes e mede o tempo de cada execução
+ * @param repeat Número de repetições
+ * @param body Função medida
+ * @param best Menor tempo, em segundos
+ * @param median Tempo mediano, em segundos
+ */
+void time_runs(size_t repeat, const std::function<void()>& body, double& best, double& median) {
+    std::vector<double> samples;
+    for (size_t i = 0; i < std::max<size_t>(repeat, 1); ++i) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    best = samples.front();
+    median = samples[samples.size() / 2];
+}
+
+/**
+ * @brief Gera um buffer sintético com densidade de cabeçalhos controlada
+ * @param name "zero", "random" ou "jpeg-dense"
+ * @param size Tamanho em bytes
+ * @return Buffer gerado (semente fixa, repetível)
+ */
+std::vector<uint8_t> make_dataset(const std::string& name, size_t size) {
+    std::vector<uint8_t> data(size, 0);
+    if (name == "zero") {
+        return data;
+    }
+
+    std::mt19937_64 rng(42);
+    for (size_t i = 0; i + 8 <= size; i += 8) {
+        uint64_t value = rng();
+        std::copy(reinterpret_cast<const uint8_t*>(&value), reinterpret_cast<const uint8_t*>(&value) + 8, data.begin() + i);
+    }
+
+    if (name == "jpeg-dense") {
+        // Um cabeçalho JPEG a cada 4KB e um footer a cada 16KB
+        for (size_t i = 0; i + 4096 <= size; i += 4096) {
+            data[i] = 0xFF;
+            data[i + 1] = 0xD8;
+            data[i + 2] = 0xFF;
+            if ((i / 4096) % 4 == 3) {
+                data[i + 4094] = 0xFF;
+                data[i + 4095] = 0xD9;
+            }
+        }
+    }
+    return data;
+}
+
+/**
+ * @brief Benchmarks de busca de cabeçalhos (autômato + pré-filtro) e de detect_header
+ */
+void bench_headers(const BenchConfig& config, const std::string& dataset_name,
+                   const std::vector<uint8_t>& data, std::vector<BenchResult>& results) {
+    FileSignatureDetector detector;
+
+    for (int level = 0; level <= static_cast<int>(detect_simd_level()); ++level) {
+        detector.set_simd_level(static_cast<SimdLevel>(level));
+
+        std::vector<HeaderMatch> matches;
+        double best, median;
+        time_runs(config.repeat, [&]() {
+            detector.scan_headers(data.data(), data.size(), matches);
+        }, best, median);
+        results.push_back({"scan_headers", dataset_name, simd_level_name(detector.get_simd_level()),
+                           data.size(), matches.size(), best, median});
+    }
+
+    // Modo --block-size: só os offsets alinhados são testados
+    for (size_t block : {512, 4096}) {
+        std::vector<HeaderMatch> matches;
+        double best, median;
+        time_runs(config.repeat, [&]() {
+            detector.scan_headers_aligned(data.data(), data.size(), 0, block, matches);
+        }, best, median);
+        results.push_back({"scan_headers", dataset_name, "bloco_" + std::to_string(block),
+                           data.size(), matches.size(), best, median});
+    }
+
+    // detect_header é chamado em cada posição candidata; mede o custo por chamada
+    std::vector<HeaderMatch> matches;
+    detector.scan_headers(data.data(), data.size(), matches);
+    std::vector<size_t> positions;
+    for (const auto& match : matches) {
+        if (positions.empty() || positions.back() != match.offset) {
+            positions.push_back(match.offset);
+        }
+    }
+    if (positions.empty()) {
+        // Sem cabeçalhos: mede posições igualmente espaçadas (caminho de rejeição)
+        for (size_t i = 0; i < data.size() && positions.size() < 100000; i += 4096) {
+            positions.push_back(i);
+        }
+    }
+
+    size_t found = 0;
+    double best, median;
+    time_runs(config.repeat, [&]() {
+        found = 0;
+        for (size_t position : positions) {
+            if (detector.detect_header(data.data() + position, data.size() - position)) {
+                found++;
+            }
+        }
+    }, best, median);
+    results.push_back({"detect_header", dataset_name, "por_candidato", data.size(), positions.size(), best, median});
+}
+
+/**
+ * @brief Benchmarks de busca de footer (primeira ocorrência, repetida até o fim do buffer)
+ */
+void bench_find_pattern(const BenchConfig& config, const std::string& dataset_name,
+                        const std::vector<uint8_t>& data, std::vector<BenchResult>& results) {
+    const std::vector<std::pair<std::string, std::vector<uint8_t>>> footers = {
+        {"JPEG", {0xFF, 0xD9}},
+        {"PDF", {0x25, 0x25, 0x45, 0x4F, 0x46}},
+        {"PNG", {0x49, 0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60, 0x82}},
+    };
+
+    for (const auto& footer : footers) {
+        for (int level = 0; level <= static_cast<int>(detect_simd_level()); ++level) {
+            PatternSearcher searcher(footer.second);
+            searcher.set_simd_level(static_cast<SimdLevel>(level));
+
+            size_t hits = 0;
+            double best, median;
+            time_runs(config.repeat, [&]() {
+                hits = 0;
+                size_t position = 0;
+                while (position < data.size()) {
+                    size_t found = searcher.find(data.data() + position, data.size() - position);
+                    if (found == SIZE_MAX) break;
+                    hits++;
+                    position += found + 1;
+                }
+            }, best, median);
+            results.push_back({"find_pattern", dataset_name,
+                               footer.first + "/" + simd_level_name(searcher.get_simd_level()),
+                               data.size(), hits, best, median});
+        }
+    }
+}
+
+/**
+ * @brief Benchmarks de leitura em chunks e de extração (cópia de faixa) sobre um arquivo temporário
+ */
+void bench_io(const BenchConfig& config, std::vector<BenchResult>& results) {
+    std::string path = (fs::path(config.temp_dir) / "carver_bench.dat").string();
+    std::string copy_path = (fs::path(config.temp_dir) / "carver_bench.out").string();
+
+    {
+        std::vector<uint8_t> block = make_dataset("random", 1 << 20);
+        std::ofstream file(path, std::ios::binary);
+        for (size_t written = 0; written < config.io_size; written += block.size()) {
+            file.write(reinterpret_cast<const char*>(block.data()),
+                       static_cast<std::streamsize>(std::min(block.size(), config.io_size - written)));
+        }
+        if (!file) {
+            std::cerr << "Erro ao criar arquivo temporário: " << path << std::endl;
+            return;
+        }
+    }
+
+    struct ReadVariant {
+        const char* name;
+        ReaderBackend backend;
+        size_t io_depth;
+        bool view;
+    };
+    const ReadVariant variants[] = {
+        {"stream", ReaderBackend::STREAM, 0, false},
+        {"stream/io_depth=4", ReaderBackend::STREAM, 4, true},
+        {"mmap", ReaderBackend::MMAP, 0, true},
+        {"direct", ReaderBackend::DIRECT, 0, true},
+    };
+
+    for (const auto& variant : variants) {
+        size_t chunks = 0;
+        size_t bytes = 0;
+        double best, median;
+        time_runs(config.repeat, [&]() {
+            ChunkReader reader;
+            reader.set_verbose(false);
+            reader.set_backend(variant.backend);
+            reader.set_io_depth(variant.io_depth);
+            if (!reader.open(path)) return;
+
+            chunks = 0;
+            bytes = 0;
+            if (variant.view) {
+                ChunkView view;
+                while (reader.read_chunk_view(view)) {
+                    chunks++;
+                    bytes += view.size;
+                }
+            } else {
+                std::vector<uint8_t> data;
+                size_t bytes_read;
+                while (reader.read_chunk(data, bytes_read)) {
+                    chunks++;
+                    bytes += bytes_read;
+                }
+            }
+        }, best, median);
+        results.push_back({variant.view ? "read_chunk_view" : "read_chunk", "random", variant.name,
+                           bytes, chunks, best, median});
+    }
+
+    // extract_file usa ChunkReader::copy_range
+    {
+        ChunkReader reader;
+        reader.set_verbose(false);
+        if (reader.open(path)) {
+            size_t copied = 0;
+            double best, median;
+            time_runs(config.repeat, [&]() {
+                copied = reader.copy_range(0, config.io_size, copy_path);
+            }, best, median);
+            results.push_back({"extract_file", "random", "copy_range", copied, 1, best, median});
+        }
+    }
+
+    std::error_code error;
+    fs::remove(path, error);
+    fs::remove(copy_path, error);
+}
+
+/**
+ * @brief Monta um JPEG baseline mínimo com dados comprimidos aleatórios
+ * @param entropy_size Bytes de dados comprimidos (FF sempre escapado como FF00)
+ * @return Arquivo completo, do SOI ao EOI (semente fixa, repetível)
+ */
+std::vector<uint8_t> make_jpeg(size_t entropy_size) {
+    std::vector<uint8_t> jpeg = {
+        0xFF, 0xD8,
+        0xFF, 0xE0, 0x00, 0x10, 'J', 'F', 'I', 'F', 0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00,
+        0xFF, 0xDB, 0x00, 0x43, 0x00,
+    };
+    jpeg.insert(jpeg.end(), 64, 0x01);
+    const uint8_t frame[] = {
+        0xFF, 0xC0, 0x00, 0x0B, 0x08, 0x00, 0x10, 0x00, 0x10, 0x01, 0x01, 0x11, 0x00,
+        0xFF, 0xC4, 0x00, 0x14, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0xFF, 0xDA, 0x00, 0x08, 0x01, 0x01, 0x00, 0x00, 0x3F, 0x00,
+    };
+    jpeg.insert(jpeg.end(), frame, frame + sizeof(frame));
+
+    std::mt19937_64 rng(7);
+    for (size_t i = 0; i < entropy_size; ++i) {
+        uint8_t byte = static_cast<uint8_t>(rng());
+        jpeg.push_back(byte);
+        if (byte == 0xFF) {
+            jpeg.push_back(0x00);
+        }
+    }
+    jpeg.push_back(0xFF);
+    jpeg.push_back(0xD9);
+    return jpeg;
+}
+
+/**
+ * @brief Recuperação de um JPEG em dois fragmentos (GapCarver)
+ *
+ * O intervalo entre os fragmentos contém um par FFC0 com comprimento
+ * plausível logo no início: um marcador que não pode seguir um scan não
+ * deve mover o ponto confirmado para dentro dos dados de outro arquivo.
+ * A variante informa se os fragmentos encontrados são os esperados.
+ */
+void bench_gap_carving(const BenchConfig& config, std::vector<BenchResult>& results) {
+    const size_t cluster = 4096;
+    const size_t cut = 3 * cluster;
+    const size_t gap = 2 * cluster;
+    std::string path = (fs::path(config.temp_dir) / "carver_bench_gap.dat").string();
+
+    std::vector<uint8_t> jpeg = make_jpeg(8 * cluster);
+    std::vector<uint8_t> foreign = make_dataset("random", gap);
+    std::replace(foreign.begin(), foreign.begin() + 64, uint8_t(0xFF), uint8_t(0xFE));
+    const uint8_t marker[] = {0xFF, 0xC0, 0x00, 0x11};
+    std::copy(marker, marker + sizeof(marker), foreign.begin() + 64);
+
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(jpeg.data()), static_cast<std::streamsize>(cut));
+        file.write(reinterpret_cast<const char*>(foreign.data()), static_cast<std::streamsize>(foreign.size()));
+        file.write(reinterpret_cast<const char*>(jpeg.data() + cut), static_cast<std::streamsize>(jpeg.size() - cut));
+        file.write(reinterpret_cast<const char*>(foreign.data()), static_cast<std::streamsize>(cluster));
+        if (!file) {
+            std::cerr << "Erro ao criar arquivo temporário: " << path << std::endl;
+            return;
+        }
+    }
+
+    FileSignatureDetector detector;
+    const FileSignature* signature = detector.get_signature("JPEG");
+    ThreadPool pool(std::thread::hardware_concurrency());
+    std::vector<std::unique_ptr<ChunkReader>> readers;
+    std::vector<ChunkReader*> worker_readers;
+    for (size_t i = 0; i < pool.size(); ++i) {
+        readers.push_back(std::make_unique<ChunkReader>());
+        readers.back()->set_verbose(false);
+        if (!readers.back()->open(path)) return;
+        worker_readers.push_back(readers.back().get());
+    }
+
+    const std::vector<std::pair<size_t, size_t>> expected = {{0, cut}, {cut + gap, jpeg.size() + gap}};
+    std::vector<std::pair<size_t, size_t>> fragments;
+    double best, median;
+    time_runs(config.repeat, [&]() {
+        // Um GapCarver novo por repetição: o cache de hipóteses não é reaproveitado
+        LengthResolver resolver(*worker_readers.front(), 1 << 20);
+        size_t end;
+        fragments.clear();
+        if (resolver.resolve(StructureFormat::JPEG, 0, end)) return;
+
+        GapCarver carver(detector, pool, worker_readers, cluster, 0, 16 * cluster, 1 << 20);
+        carver.carve(signature, 0, resolver.get_verified_offset(), resolver.get_failure_offset(), fragments);
+    }, best, median);
+
+    bool recovered = fragments == expected;
+    if (!recovered) {
+        std::cerr << "Erro: fragmentos do JPEG não recuperados no intervalo com marcador falso" << std::endl;
+    }
+    results.push_back({"gap_carve", "jpeg-bifragmento", recovered ? "recuperado" : "nao_recuperado",
+                       jpeg.size(), fragments.size(), best, median});
+
+    std::error_code error;
+    fs::remove(path, error);
+}
+
+/**
+ * @brief Escapa uma string para JSON
+ */
+std::string json_string(const std::string& text) {
+    std::ostringstream oss;
+    oss << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') oss << '\\';
+        oss << c;
+    }
+    oss << '"';
+    return oss.str();
+}
+
+/**
+ * @brief Escreve os resultados em JSON
+ */
+void write_json(std::ostream& out, const BenchConfig& config, const std::vector<BenchResult>& results) {
+    out << std::fixed;
+    out << "{\n";
+    out << "  \"simd_detected\": " << json_string(simd_level_name(detect_simd_level())) << ",\n";
+    out << "  \"buffer_size\": " << config.buffer_size << ",\n";
+    out << "  \"io_size\": " << config.io_size << ",\n";
+    out << "  \"repeat\": " << config.repeat << ",\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        double bytes_per_second = r.best_seconds > 0 ? r.bytes / r.best_seconds : 0.0;
+        out << "    {\"kernel\": " << json_string(r.kernel)
+            << ", \"dataset\": " << json_string(r.dataset)
+            << ", \"variant\": " << json_string(r.variant)
+            << ", \"bytes\": " << r.bytes
+            << ", \"candidates\": " << r.candidates
+            << std::setprecision(6)
+            << ", \"best_seconds\": " << r.best_seconds
+            << ", \"median_seconds\": " << r.median_seconds
+            << std::setprecision(0)
+            << ", \"bytes_per_second\": " << bytes_per_second
+            << std::setprecision(2)
+            << ", \"ns_per_candidate\": ";
+        // Sem candidatos o custo por candidato não é definido
+        if (r.candidates > 0) {
+            out << r.best_seconds * 1e9 / r.candidates;
+        } else {
+            out << "null";
+        }
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+/**
+ * @brief Exibe as opções do benchmark
+ */
+void print_usage(const char* program) {
+    std::cout << "Uso: " << program << " [opções]" << std::endl;
+    std::cout << "  --size <MB>        Tamanho dos buffers sintéticos (padrão: 64)" << std::endl;
+    std::cout << "  --io-size <MB>     Tamanho do arquivo dos benchmarks de I/O (padrão: 256)" << std::endl;
+    std::cout << "  --repeat <n>       Repetições por medida; reporta a melhor e a mediana (padrão: 5)" << std::endl;
+    std::cout << "  --temp-dir <dir>   Diretório do arquivo temporário de I/O" << std::endl;
+    std::cout << "  --filter <texto>   Executa só kernels cujo nome contém o texto" << std::endl;
+    std::cout << "  --no-io            Não executa os benchmarks de I/O" << std::endl;
+    std::cout << "  --output <arquivo> Grava o JSON em arquivo (padrão: saída padrão)" << std::endl;
+}
+
+/**
+ * @brief Lê um argumento numérico
+ */
+bool parse_number(const char* text, size_t& value) {
+    try {
+        size_t used = 0;
+        unsigned long long parsed = std::stoull(text, &used);
+        if (text[used] != '\0') return false;
+        value = static_cast<size_t>(parsed);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t value = 0;
+        bool has_value = i + 1 < argc;
+
+        if (arg == "--size" && has_value && parse_number(argv[++i], value) && value > 0) {
+            config.buffer_size = value << 20;
+        } else if (arg == "--io-size" && has_value && parse_number(argv[++i], value) && value > 0) {
+            config.io_size = value << 20;
+        } else if (arg == "--repeat" && has_value && parse_number(argv[++i], value) && value > 0) {
+            config.repeat = value;
+        } else if (arg == "--temp-dir" && has_value) {
+            config.temp_dir = argv[++i];
+        } else if (arg == "--filter" && has_value) {
+            config.filter = argv[++i];
+        } else if (arg == "--output" && has_value) {
+            config.output_file = argv[++i];
+        } else if (arg == "--no-io") {
+            config.run_io = false;
+        } else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else {
+            std::cerr << "Erro: argumento inválido: " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    auto selected = [&config](const std::string& kernel) {
+        return config.filter.empty() || kernel.find(config.filter) != std::string::npos;
+    };
+
+    std::vector<BenchResult> results;
+    for (const char* name : {"zero", "random", "jpeg-dense"}) {
+        std::vector<uint8_t> data = make_dataset(name, config.buffer_size);
+        if (selected("scan_headers") || selected("detect_header")) {
+            bench_headers(config, name, data, results);
+        }
+        if (selected("find_pattern")) {
+            bench_find_pattern(config, name, data, results);
+        }
+    }
+
+    if (config.run_io && (selected("read_chunk") || selected("extract_file"))) {
+        bench_io(config, results);
+    }
+
+    if (selected("gap_carve")) {
+        bench_gap_carving(config, results);
+    }
+
+    results.erase(std::remove_if(results.begin(), results.end(), [&selected](const BenchResult& r) {
+        return !selected(r.kernel);
+    }), results.end());
+
+    if (config.output_file.empty()) {
+        write_json(std::cout, config, results);
+    } else {
+        std::ofstream out(config.output_file);
+        if (!out.is_open()) {
+            std::cerr << "Erro ao criar arquivo: " << config.output_file << std::endl;
+            return 1;
+        }
+        write_json(out, config, results);
+    }
+
+    return 0;
+}
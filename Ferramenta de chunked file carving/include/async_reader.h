@@ -0,0 +1,89 @@
+#pragma once
+
+#include "chunk_reader.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+class ReadEngine;
+
+/**
+ * @brief Pipeline de leitura antecipada de chunks
+ *
+ * Mantém até io_depth leituras em andamento enquanto o chunk atual é
+ * varrido, de modo que disco e CPU trabalhem ao mesmo tempo. As leituras
+ * usam io_uring quando o kernel permite e, caso contrário, um pequeno
+ * conjunto de threads com pread.
+ *
+ * Cada chunk é lido já com o seu overlap (os bytes finais do chunk anterior),
+ * então nenhum dado é copiado entre buffers.
+ */
+class AsyncChunkPipeline {
+private:
+    struct Slot {
+        std::vector<uint8_t> buffer;
+        size_t offset;          // Offset absoluto de buffer[0]
+        size_t length;          // Bytes solicitados
+        bool pending;           // Leitura em andamento
+    };
+
+    int fd_;
+    size_t file_size_;
+    size_t chunk_size_;
+    size_t overlap_size_;
+    size_t start_position_;
+    size_t next_submit_;        // Índice do próximo chunk a enviar
+    size_t next_consume_;       // Índice do próximo chunk a entregar
+    size_t held_slot_;          // Slot entregue ao consumidor (SIZE_MAX = nenhum)
+    std::vector<Slot> slots_;
+    std::unique_ptr<ReadEngine> engine_;
+
+    bool submit_next();
+    void drain();
+
+public:
+    /**
+     * @brief Construtor
+     * @param chunk_size Bytes novos por chunk
+     * @param overlap_size Bytes repetidos do chunk anterior
+     * @param io_depth Número máximo de leituras em andamento
+     */
+    AsyncChunkPipeline(size_t chunk_size, size_t overlap_size, size_t io_depth);
+
+    /**
+     * @brief Destrutor - aguarda leituras pendentes e fecha o descritor
+     */
+    ~AsyncChunkPipeline();
+
+    // Não permite cópia
+    AsyncChunkPipeline(const AsyncChunkPipeline&) = delete;
+    AsyncChunkPipeline& operator=(const AsyncChunkPipeline&) = delete;
+
+    /**
+     * @brief Abre o arquivo e escolhe o mecanismo de I/O
+     * @param filename Caminho do arquivo
+     * @param file_size Tamanho do arquivo em bytes
+     * @return true se o pipeline está pronto
+     */
+    bool open(const std::string& filename, size_t file_size);
+
+    /**
+     * @brief Reinicia a leitura antecipada a partir de uma posição
+     * @param position Offset do primeiro byte novo (sem overlap)
+     */
+    void restart(size_t position);
+
+    /**
+     * @brief Entrega o próximo chunk (válido até a próxima chamada)
+     * @param view Visão do chunk, incluindo o overlap
+     * @return false no fim do arquivo ou em erro de leitura
+     */
+    bool next(ChunkView& view);
+
+    /**
+     * @brief Retorna o nome do mecanismo de I/O em uso
+     * @return "io_uring" ou "threads"
+     */
+    const char* engine_name() const;
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "cpu_features.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Classe de um bloco da imagem
+ */
+enum class BlockClass : uint8_t {
+    DATA = 0,           // Conteúdo comum (ou bloco não classificado)
+    ZERO = 1,           // Todos os bytes 0x00
+    UNIFORM = 2,        // Um único byte repetido (ex: área apagada com 0xFF)
+    HIGH_ENTROPY = 3    // Histograma próximo do uniforme (cifrado ou comprimido)
+};
+
+/**
+ * @brief Sequência de blocos consecutivos da mesma classe
+ */
+struct BlockRun {
+    size_t begin;       // Inclusivo
+    size_t end;         // Exclusivo
+    BlockClass type;
+};
+
+/**
+ * @brief Nome de uma classe de bloco (ex: "ZERO")
+ */
+const char* block_class_name(BlockClass type);
+
+/**
+ * @brief Classificador de blocos executado antes da busca de cabeçalhos
+ *
+ * O teste de bloco uniforme compara o bloco inteiro com o primeiro byte
+ * em registradores vetoriais (SSE2, AVX2 ou AVX-512) e termina na primeira
+ * diferença, de modo que blocos de dados custam poucas instruções. A
+ * entropia, quando pedida, é estimada pelo histograma de bytes do bloco.
+ */
+class BlockClassifier {
+private:
+    size_t block_size_;
+    bool entropy_;
+    double entropy_threshold_;          // Bits por byte a partir dos quais o bloco é de alta entropia
+    std::vector<float> weighted_log_;   // n * log2(n) para cada contagem possível
+    SimdLevel simd_level_;
+
+    bool is_uniform(const uint8_t* data) const;
+    bool is_high_entropy(const uint8_t* data) const;
+
+public:
+    BlockClassifier();
+
+    /**
+     * @brief Define o tamanho do bloco
+     * @param block_size Tamanho em bytes (a entropia só é estimada a partir de 512)
+     */
+    void set_block_size(size_t block_size);
+
+    /**
+     * @brief Retorna o tamanho do bloco
+     */
+    size_t get_block_size() const;
+
+    /**
+     * @brief Define se a alta entropia é estimada (sem ela, só DATA, ZERO e UNIFORM)
+     */
+    void set_entropy(bool entropy);
+
+    /**
+     * @brief Força um nível SIMD (limitado ao suportado pela CPU)
+     */
+    void set_simd_level(SimdLevel level);
+
+    /**
+     * @brief Classifica um bloco completo
+     * @param data Início do bloco (get_block_size() bytes)
+     */
+    BlockClass classify(const uint8_t* data) const;
+};
+
+/**
+ * @brief Grava o mapa de blocos em CSV (Inicio,Fim,Tipo), uma linha por sequência
+ * @param path Arquivo de saída
+ * @param runs Sequências em ordem de offset
+ * @return true se gravado com sucesso
+ */
+bool write_block_map(const std::string& path, const std::vector<BlockRun>& runs);
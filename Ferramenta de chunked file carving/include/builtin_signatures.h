@@ -0,0 +1,152 @@
+#pragma once
+
+#include "cpu_features.h"
+#include <initializer_list>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+/**
+ * @brief Assinatura embutida, definida em tempo de compilação
+ *
+ * Cabeçalhos de até 16 bytes e footers de até 8 bytes, em arrays fixos,
+ * para que as tabelas de comparação sejam montadas pelo compilador.
+ */
+struct BuiltinSignature {
+    const char* name;
+    const char* extension;
+    uint8_t header[16];
+    size_t header_length;
+    uint8_t footer[8];
+    size_t footer_length;
+    size_t max_size;
+    bool has_footer;
+};
+
+/**
+ * @brief Monta uma assinatura embutida a partir das listas de bytes
+ */
+constexpr BuiltinSignature make_builtin_signature(const char* name, const char* extension,
+                                                  std::initializer_list<uint8_t> header,
+                                                  std::initializer_list<uint8_t> footer,
+                                                  size_t max_size, bool has_footer) {
+    BuiltinSignature signature{name, extension, {}, 0, {}, 0, max_size, has_footer};
+    for (uint8_t byte : header) signature.header[signature.header_length++] = byte;
+    for (uint8_t byte : footer) signature.footer[signature.footer_length++] = byte;
+    return signature;
+}
+
+/**
+ * @brief Assinaturas comuns carregadas por padrão (a ordem define os índices)
+ */
+constexpr BuiltinSignature BUILTIN_SIGNATURES[] = {
+    make_builtin_signature("JPEG", ".jpg", {0xFF, 0xD8, 0xFF}, {0xFF, 0xD9}, 0, true),
+    make_builtin_signature("PNG", ".png",
+        {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A},
+        {0x49, 0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60, 0x82}, 0, true),
+    make_builtin_signature("GIF87a", ".gif", {0x47, 0x49, 0x46, 0x38, 0x37, 0x61}, {0x00, 0x3B}, 0, true),
+    make_builtin_signature("GIF89a", ".gif", {0x47, 0x49, 0x46, 0x38, 0x39, 0x61}, {0x00, 0x3B}, 0, true),
+    make_builtin_signature("PDF", ".pdf",
+        {0x25, 0x50, 0x44, 0x46, 0x2D},     // %PDF-
+        {0x25, 0x25, 0x45, 0x4F, 0x46},     // %%EOF
+        0, true),
+    make_builtin_signature("ZIP", ".zip", {0x50, 0x4B, 0x03, 0x04}, {0x50, 0x4B, 0x05, 0x06}, 0, true),
+    make_builtin_signature("RAR", ".rar", {0x52, 0x61, 0x72, 0x21, 0x1A, 0x07, 0x00}, {}, 0, false),
+    make_builtin_signature("7ZIP", ".7z", {0x37, 0x7A, 0xBC, 0xAF, 0x27, 0x1C}, {}, 0, false),
+    // Microsoft Office (DOCX, XLSX, PPTX)
+    make_builtin_signature("DOCX", ".docx", {0x50, 0x4B, 0x03, 0x04, 0x14, 0x00, 0x06, 0x00}, {}, 0, false),
+    make_builtin_signature("MP3", ".mp3", {0x49, 0x44, 0x33}, {}, 0, false),     // ID3
+    make_builtin_signature("MP3_ALT", ".mp3", {0xFF, 0xFB}, {}, 0, false),
+    make_builtin_signature("MP4", ".mp4", {0x00, 0x00, 0x00, 0x20, 0x66, 0x74, 0x79, 0x70}, {}, 0, false),
+    make_builtin_signature("AVI", ".avi", {0x52, 0x49, 0x46, 0x46}, {}, 0, false), // RIFF
+    make_builtin_signature("BMP", ".bmp", {0x42, 0x4D}, {}, 0, false),
+    make_builtin_signature("TIFF_LE", ".tiff", {0x49, 0x49, 0x2A, 0x00}, {}, 0, false),
+    make_builtin_signature("TIFF_BE", ".tiff", {0x4D, 0x4D, 0x00, 0x2A}, {}, 0, false),
+    make_builtin_signature("DOC", ".doc", {0xD0, 0xCF, 0x11, 0xE0, 0xA1, 0xB1, 0x1A, 0xE1}, {}, 0, false),
+    make_builtin_signature("EXE", ".exe", {0x4D, 0x5A}, {}, 0, false),           // MZ
+    make_builtin_signature("SQLITE", ".db",
+        {0x53, 0x51, 0x4C, 0x69, 0x74, 0x65, 0x20, 0x66, 0x6F, 0x72, 0x6D, 0x61, 0x74, 0x20, 0x33, 0x00},
+        {}, 0, false),
+};
+
+constexpr size_t BUILTIN_SIGNATURE_COUNT = sizeof(BUILTIN_SIGNATURES) / sizeof(BUILTIN_SIGNATURES[0]);
+
+static_assert(BUILTIN_SIGNATURE_COUNT <= 32, "as máscaras de resultado têm 32 bits");
+
+/**
+ * @brief Tabelas de comparação das assinaturas embutidas
+ *
+ * Cada cabeçalho vira até dois pares valor/máscara de 64 bits (bytes em
+ * ordem little-endian), de forma que a confirmação em uma posição é uma
+ * carga de 8 bytes e uma comparação mascarada por assinatura. As
+ * assinaturas são agrupadas pelo primeiro byte: só as do grupo são testadas.
+ */
+struct BuiltinHeaderTables {
+    uint32_t by_first_byte[256];                    // Assinaturas por primeiro byte
+    uint64_t value[BUILTIN_SIGNATURE_COUNT][2];
+    uint64_t mask[BUILTIN_SIGNATURE_COUNT][2];
+    uint8_t length[BUILTIN_SIGNATURE_COUNT];
+    uint32_t wide_mask;                             // Assinaturas com mais de 8 bytes
+};
+
+constexpr BuiltinHeaderTables make_builtin_header_tables() {
+    BuiltinHeaderTables tables{};
+    for (size_t id = 0; id < BUILTIN_SIGNATURE_COUNT; ++id) {
+        const BuiltinSignature& signature = BUILTIN_SIGNATURES[id];
+        tables.by_first_byte[signature.header[0]] |= 1u << id;
+        tables.length[id] = static_cast<uint8_t>(signature.header_length);
+        for (size_t k = 0; k < signature.header_length; ++k) {
+            tables.value[id][k / 8] |= static_cast<uint64_t>(signature.header[k]) << (8 * (k % 8));
+            tables.mask[id][k / 8] |= static_cast<uint64_t>(0xFF) << (8 * (k % 8));
+        }
+        if (signature.header_length > 8) {
+            tables.wide_mask |= 1u << id;
+        }
+    }
+    return tables;
+}
+
+constexpr BuiltinHeaderTables BUILTIN_HEADER_TABLES = make_builtin_header_tables();
+
+/**
+ * @brief Lê 8 bytes como inteiro little-endian (completa com zeros se faltar dado)
+ */
+inline uint64_t load_le64(const uint8_t* data, size_t size) {
+    uint64_t word = 0;
+    std::memcpy(&word, data, size < 8 ? size : 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);     // Tabelas são montadas em little-endian
+#endif
+    return word;
+}
+
+/**
+ * @brief Reporta as assinaturas embutidas cujo cabeçalho começa em data[0]
+ * @param data Buffer com os dados
+ * @param size Tamanho do buffer
+ * @return Máscara com um bit por índice de BUILTIN_SIGNATURES
+ */
+inline uint32_t match_builtin_headers(const uint8_t* data, size_t size) {
+    if (size == 0) return 0;
+
+    uint32_t group = BUILTIN_HEADER_TABLES.by_first_byte[data[0]];
+    if (!group) return 0;
+
+    const uint64_t low = load_le64(data, size);
+    uint32_t result = 0;
+    while (group) {
+        unsigned id = count_trailing_zeros(group);
+        group &= group - 1;
+
+        if ((low & BUILTIN_HEADER_TABLES.mask[id][0]) != BUILTIN_HEADER_TABLES.value[id][0] ||
+            BUILTIN_HEADER_TABLES.length[id] > size) {
+            continue;
+        }
+        if ((BUILTIN_HEADER_TABLES.wide_mask >> id) & 1u) {
+            uint64_t high = load_le64(data + 8, size - 8);
+            if ((high & BUILTIN_HEADER_TABLES.mask[id][1]) != BUILTIN_HEADER_TABLES.value[id][1]) continue;
+        }
+        result |= 1u << id;
+    }
+    return result;
+}
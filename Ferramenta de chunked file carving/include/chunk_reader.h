@@ -1,10 +1,35 @@
 #pragma once
 
+#include "ring_buffer.h"
 #include <string>
 #include <vector>
 #include <fstream>
 #include <cstdint>
 #include <memory>
+#include <functional>
+
+/**
+ * @brief Estratégias de acesso ao arquivo de entrada
+ */
+enum class ReaderBackend {
+    STREAM,     // std::ifstream com cópia para buffer (portável)
+    MMAP,       // Mapeamento em memória, visões sem cópia
+    DIRECT      // O_DIRECT com buffers alinhados, sem passar pelo cache de páginas
+};
+
+/**
+ * @brief Visão somente leitura de uma região do arquivo
+ *
+ * Os dados pertencem ao ChunkReader e permanecem válidos até a próxima
+ * chamada de leitura no mesmo leitor (ou até o fechamento, no modo MMAP).
+ */
+struct ChunkView {
+    const uint8_t* data;    // Primeiro byte da região
+    size_t size;            // Número de bytes disponíveis
+    size_t offset;          // Offset absoluto de data[0] no arquivo
+};
+
+class AsyncChunkPipeline;
 
 /**
  * @brief Classe para leitura eficiente de dados em chunks
@@ -18,12 +43,54 @@ private:
     size_t chunk_size_;
     std::vector<uint8_t> buffer_;
     bool is_open_;
+    bool verbose_;
+    size_t chunk_offset_;
     
     // Buffer para overlap entre chunks
     std::vector<uint8_t> overlap_buffer_;
     size_t overlap_size_;
     
+    // Backend mapeado em memória
+    ReaderBackend backend_;
+    int fd_;
+    const uint8_t* mapping_;
+    size_t carried_overlap_;        // Bytes de overlap que antecedem o próximo chunk
+    std::vector<uint8_t> scratch_;  // Destino de view_at_position no modo STREAM
+    
+    // Backend O_DIRECT: leituras alinhadas ao setor em buffers alinhados
+    struct AlignedFree {
+        void operator()(uint8_t* pointer) const;
+    };
+    using AlignedBuffer = std::unique_ptr<uint8_t[], AlignedFree>;
+    
+    int direct_fd_;
+    size_t alignment_;
+    size_t direct_chunk_size_;          // chunk_size_ arredondado para múltiplo de alignment_
+    AlignedBuffer direct_buffer_;       // Chunks (overlap + dados novos)
+    size_t direct_capacity_;
+    AlignedBuffer direct_scratch_;      // Leituras em posições arbitrárias
+    size_t direct_scratch_capacity_;
+    
+    // Leitura antecipada assíncrona (modo STREAM)
+    size_t io_depth_;
+    std::unique_ptr<AsyncChunkPipeline> pipeline_;
+    
+    // Leitura síncrona (modo STREAM): chunks no offset do arquivo dentro do buffer circular
+    RingBuffer ring_;
+    bool huge_pages_;
+    bool ring_unavailable_;         // Sem espelhamento: usa buffer_ com cópia do overlap
+    
+    // Arquivos esparsos: os buracos são saltados em vez de lidos
+    bool sparse_;                   // Arquivo regular com menos blocos alocados que o tamanho
+    size_t allocated_size_;
+    size_t data_begin_;             // Último extent de dados encontrado: [data_begin_, data_end_)
+    size_t data_end_;
+    size_t skipped_bytes_;          // Bytes de buracos não lidos
+    
 public:
+    // Recebe cada bloco copiado por copy_range, na ordem do arquivo
+    using CopyObserver = std::function<void(const uint8_t*, size_t)>;
+    
     /**
      * @brief Construtor
      * @param chunk_size Tamanho do chunk em bytes (padrão: 64KB)
@@ -56,6 +123,16 @@ public:
      */
     bool read_chunk(std::vector<uint8_t>& data, size_t& bytes_read);
     
+    /**
+     * @brief Lê o próximo chunk como visão sem cópia
+     * @param view Visão do chunk (inclui o overlap do chunk anterior)
+     * @return true se a leitura foi bem-sucedida
+     *
+     * No modo MMAP a visão aponta diretamente para o mapeamento; no modo
+     * STREAM aponta para o buffer interno do leitor.
+     */
+    bool read_chunk_view(ChunkView& view);
+    
     /**
      * @brief Lê dados de uma posição específica
      * @param position Posição no arquivo
@@ -65,6 +142,34 @@ public:
      */
     size_t read_at_position(size_t position, size_t size, std::vector<uint8_t>& data);
     
+    /**
+     * @brief Obtém uma visão de dados a partir de uma posição específica
+     * @param position Posição no arquivo
+     * @param size Número de bytes desejados
+     * @param view Visão resultante
+     * @return Número de bytes efetivamente disponíveis na visão
+     */
+    size_t view_at_position(size_t position, size_t size, ChunkView& view);
+    
+    /**
+     * @brief Copia uma região do arquivo para um novo arquivo de saída
+     * @param position Posição inicial no arquivo
+     * @param size Número de bytes a copiar
+     * @param output_path Caminho do arquivo de saída
+     * @param append true para acrescentar ao final (fragmentos seguintes);
+     *        false sobrescreve o arquivo
+     * @param observer Recebe os bytes à medida que são gravados (opcional)
+     * @return Número de bytes copiados (0 em caso de erro)
+     *
+     * Usa copy_file_range e, na falta dele, sendfile, de modo que os dados
+     * não passam pelo espaço de usuário; caso contrário copia em blocos de
+     * tamanho limitado. A memória usada não depende do tamanho da região.
+     * Com observer a cópia é sempre por blocos, e cada bloco é entregue ao
+     * observer enquanto ainda está no cache (ex: hash na mesma passada).
+     */
+    size_t copy_range(size_t position, size_t size, const std::string& output_path, bool append = false,
+                      const CopyObserver& observer = nullptr);
+    
     /**
      * @brief Move para uma posição específica no arquivo
      * @param position Nova posição
@@ -72,6 +177,12 @@ public:
      */
     bool seek(size_t position);
     
+    /**
+     * @brief Retorna o offset absoluto do primeiro byte do último chunk lido
+     * @return Offset no arquivo (inclui o overlap copiado do chunk anterior)
+     */
+    size_t get_chunk_offset() const;
+    
     /**
      * @brief Retorna a posição atual no arquivo
      * @return Posição atual
@@ -114,6 +225,90 @@ public:
      */
     void set_chunk_size(size_t new_chunk_size);
     
+    /**
+     * @brief Retorna o tamanho do chunk
+     * @return Tamanho do chunk em bytes
+     */
+    size_t get_chunk_size() const;
+    
+    /**
+     * @brief Retorna o tamanho do overlap
+     * @return Tamanho do overlap em bytes
+     */
+    size_t get_overlap_size() const;
+    
+    /**
+     * @brief Define o backend de leitura (tem efeito no próximo open)
+     * @param backend Backend desejado
+     */
+    void set_backend(ReaderBackend backend);
+    
+    /**
+     * @brief Retorna o backend efetivamente em uso
+     * @return Backend atual
+     */
+    ReaderBackend get_backend() const;
+    
+    /**
+     * @brief Define quantas leituras de chunk ficam em andamento (tem efeito no próximo open)
+     * @param io_depth Profundidade da fila (0 = leitura síncrona)
+     *
+     * Só se aplica ao backend STREAM; no modo MMAP a leitura antecipada fica
+     * a cargo do kernel e no modo DIRECT as leituras são síncronas.
+     */
+    void set_io_depth(size_t io_depth);
+    
+    /**
+     * @brief Retorna a profundidade de leitura antecipada configurada
+     * @return Profundidade da fila (0 = leitura síncrona)
+     */
+    size_t get_io_depth() const;
+    
+    /**
+     * @brief Pede páginas enormes para o buffer circular de leitura
+     * @param huge_pages true para tentar páginas de 2MB (recua para páginas normais)
+     */
+    void set_huge_pages(bool huge_pages);
+    
+    /**
+     * @brief Retorna se páginas enormes foram pedidas
+     */
+    bool get_huge_pages() const;
+    
+    /**
+     * @brief Retorna o mecanismo de leitura antecipada em uso
+     * @return "io_uring", "threads" ou nullptr se a leitura é síncrona
+     */
+    const char* get_io_engine_name() const;
+    
+    /**
+     * @brief Verifica se o arquivo aberto tem buracos (blocos não alocados)
+     * @return true se os buracos são saltados na leitura de chunks
+     *
+     * Os extents de dados são localizados com lseek(SEEK_DATA/SEEK_HOLE) à
+     * medida que a leitura avança; um buraco só contém zeros, então nenhum
+     * chunk lido depois do salto difere do que seria lido sem ele.
+     */
+    bool is_sparse() const;
+    
+    /**
+     * @brief Retorna o espaço efetivamente alocado pelo arquivo
+     * @return Bytes alocados (igual ao tamanho se o arquivo não é esparso)
+     */
+    size_t get_allocated_size() const;
+    
+    /**
+     * @brief Retorna quantos bytes de buracos foram saltados sem leitura
+     * @return Bytes saltados desde a abertura
+     */
+    size_t get_skipped_bytes() const;
+    
+    /**
+     * @brief Define se mensagens de abertura de arquivo devem ser exibidas
+     * @param verbose true para exibir
+     */
+    void set_verbose(bool verbose);
+    
     /**
      * @brief Redefine o tamanho do overlap
      * @param new_overlap_size Novo tamanho do overlap
@@ -140,4 +335,65 @@ private:
      * @brief Calcula o tamanho do arquivo
      */
     void calculate_file_size();
+    
+    /**
+     * @brief Mapeia o arquivo em memória
+     * @return true se mapeado com sucesso
+     */
+    bool open_mapping();
+    
+    /**
+     * @brief Abre o arquivo sem cache de páginas e detecta o alinhamento exigido
+     * @return true se o modo DIRECT está ativo
+     */
+    bool open_direct();
+    
+    /**
+     * @brief Fecha o descritor O_DIRECT
+     */
+    void close_direct();
+    
+    /**
+     * @brief Lê uma região alinhada no modo DIRECT
+     * @param position Posição inicial (qualquer alinhamento)
+     * @param size Número de bytes desejados
+     * @param buffer Buffer alinhado de destino (cresce se necessário)
+     * @param capacity Capacidade atual do buffer
+     * @param buffer_offset Posição alinhada do buffer onde a leitura começa
+     * @param data Ponteiro para o byte em position dentro do buffer
+     * @return Número de bytes disponíveis a partir de data
+     */
+    size_t read_direct(size_t position, size_t size, AlignedBuffer& buffer, size_t& capacity,
+                       size_t buffer_offset, const uint8_t*& data);
+    
+    /**
+     * @brief Abre (uma única vez) o descritor bruto do arquivo
+     * @return true se o descritor está disponível
+     */
+    bool open_descriptor();
+    
+    /**
+     * @brief Desfaz o mapeamento e fecha o descritor
+     */
+    void close_mapping();
+    
+    /**
+     * @brief Verifica pelos blocos alocados se o arquivo tem buracos
+     */
+    void detect_sparse();
+    
+    /**
+     * @brief Salta o buraco que começa na posição atual, se houver
+     *
+     * A leitura recomeça overlap bytes antes do próximo extent de dados, e só
+     * se os últimos overlap bytes já lidos também estão no buraco: cabeçalhos
+     * que cruzam a fronteira entre buraco e dados continuam sendo encontrados.
+     */
+    void skip_hole();
+    
+    /**
+     * @brief Reserva (na primeira leitura) o buffer circular do modo STREAM
+     * @return true se os chunks podem ser lidos no buffer circular
+     */
+    bool prepare_ring();
 };
\ No newline at end of file
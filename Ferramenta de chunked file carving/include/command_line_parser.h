@@ -3,6 +3,8 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <utility>
+#include "cpu_features.h"
 
 /**
  * @brief Estrutura para configurações da aplicação
@@ -11,18 +13,45 @@ struct CarverConfig {
     std::string input_file;
     std::string output_directory = "output";
     std::vector<std::string> file_types;
+    std::string signatures_file; // Vazio = apenas assinaturas embutidas
     size_t min_file_size = 512;
     size_t max_file_size = 0; // 0 = sem limite
     size_t chunk_size = 65536; // 64KB
     size_t overlap_size = 4096; // 4KB
     size_t search_window = 1048576; // 1MB
     bool extract_files = true;
+    bool hash_files = false; // XXH3 do conteúdo de cada arquivo
+    bool hash_sha256 = false; // SHA-256 nos relatórios (implica hash_files)
+    std::string dedup; // Vazio = grava duplicatas; "skip" ou "link"
+    std::string known_hashes_file; // Banco de carver-hashdb (vazio = nenhum)
     bool use_footers = true;
+    bool use_structure = true;
+    bool bifragment = false;
+    size_t max_gap = 1048576; // 1MB
+    bool skip_carved = false; // false = mantém arquivos embutidos, marcados no relatório
+    SimdLevel simd_level = detect_simd_level();
+    size_t threads = 1; // 0 = número de núcleos
+    size_t writers = 2; // Threads de gravação (0 = extração na thread de varredura)
+    size_t write_queue = 64; // Arquivos aguardando gravação antes de a varredura esperar
+    bool use_mmap = false;
+    bool use_direct = false;
+    size_t io_depth = 0; // 0 = leitura síncrona
+    bool huge_pages = false; // Buffer circular de leitura em páginas de 2MB
+    size_t block_size = 0; // 0 = cabeçalhos em qualquer offset
+    size_t block_offset = 0; // Base do alinhamento (início da partição)
+    std::vector<std::pair<size_t, size_t>> unaligned_regions; // [início, fim) varridos byte a byte
+    bool skip_uniform_blocks = false; // Blocos zerados/uniformes fora da busca de cabeçalhos
+    bool skip_entropy_blocks = false; // Blocos de alta entropia fora da busca de cabeçalhos
+    std::string block_map_file; // CSV com a classe de cada faixa de blocos (vazio = nenhum)
     bool verbose = false;
     bool generate_report = true;
     bool generate_csv = false;
+    bool generate_ndjson = false;
+    bool generate_store = false;
     std::string report_file = "carving_report.txt";
     std::string csv_file = "carving_report.csv";
+    std::string ndjson_file = "carving_report.ndjson";
+    std::string store_file = "carving_results.crv";
 };
 
 /**
@@ -38,6 +67,7 @@ private:
     void print_help() const;
     void print_version() const;
     bool parse_size_argument(const std::string& arg, size_t& value) const;
+    bool parse_region_argument(const std::string& arg, std::pair<size_t, size_t>& region) const;
     std::vector<std::string> split_string(const std::string& str, char delimiter) const;
     
 public:
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief XXH3 de 64 bits incremental (semente 0, segredo padrão)
+ *
+ * Identifica os arquivos extraídos com conteúdo idêntico. Processa 64
+ * bytes por passo em oito acumuladores independentes (o compilador os
+ * vetoriza), bem mais rápido que o XXH64; o resultado é o mesmo do
+ * XXH3_64bits de referência.
+ */
+class Xxh3 {
+private:
+    static const size_t BUFFER_SIZE = 256;
+
+    uint64_t accumulators_[8];
+    uint8_t buffer_[BUFFER_SIZE];
+    size_t buffered_;
+    uint64_t total_length_;
+    size_t stripes_in_block_;           // Faixas de 64 bytes do bloco atual já acumuladas
+
+    void consume_stripes(const uint8_t* input, size_t stripes);
+
+public:
+    Xxh3();
+
+    /**
+     * @brief Acrescenta bytes ao hash
+     */
+    void update(const void* data, size_t size);
+
+    /**
+     * @brief Hash dos bytes acrescentados até agora
+     */
+    uint64_t digest() const;
+};
+
+/**
+ * @brief SHA-256 em bytes, na ordem do hexadecimal
+ */
+using Sha256Digest = std::array<uint8_t, 32>;
+
+/**
+ * @brief SHA-256 incremental (FIPS 180-4), para relatórios e hashes conhecidos
+ */
+class Sha256 {
+private:
+    uint32_t state_[8];
+    uint8_t buffer_[64];
+    size_t buffered_;
+    uint64_t total_length_;
+
+    void process_block(const uint8_t* block);
+
+public:
+    Sha256();
+
+    /**
+     * @brief Acrescenta bytes ao hash
+     */
+    void update(const void* data, size_t size);
+
+    /**
+     * @brief Hash dos bytes acrescentados até agora
+     */
+    Sha256Digest digest() const;
+
+    /**
+     * @brief Hash dos bytes acrescentados até agora, em hexadecimal minúsculo
+     */
+    std::string hex_digest() const;
+};
+
+/**
+ * @brief Formata um SHA-256 com 64 dígitos hexadecimais minúsculos
+ */
+std::string format_sha256(const Sha256Digest& digest);
+
+/**
+ * @brief Converte 64 dígitos hexadecimais (maiúsculos ou minúsculos) em SHA-256
+ * @return false se o texto não tem exatamente 64 dígitos hexadecimais
+ */
+bool parse_sha256(const std::string& hex, Sha256Digest& digest);
+
+/**
+ * @brief Formata um hash de 64 bits com 16 dígitos hexadecimais
+ */
+std::string format_hash64(uint64_t hash);
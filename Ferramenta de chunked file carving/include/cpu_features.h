@@ -0,0 +1,83 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Kernels vetoriais x86 são compilados com atributos de alvo por função,
+// de modo que o binário roda em qualquer CPU e escolhe o kernel em tempo de execução
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CARVER_X86_SIMD 1
+#define CARVER_TARGET(isa) __attribute__((target(isa)))
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define CARVER_X86_SIMD 1
+#define CARVER_TARGET(isa)
+#else
+#define CARVER_X86_SIMD 0
+#define CARVER_TARGET(isa)
+#endif
+
+/**
+ * @brief Níveis de instruções vetoriais suportados pelos kernels de busca
+ */
+enum class SimdLevel {
+    SCALAR = 0,
+    SSE2 = 1,
+    AVX2 = 2,
+    AVX512 = 3
+};
+
+/**
+ * @brief Detecta em tempo de execução o melhor nível SIMD disponível na CPU
+ * @return Nível SIMD suportado (resultado é calculado uma única vez)
+ */
+SimdLevel detect_simd_level();
+
+/**
+ * @brief Verifica se a CPU suporta SSSE3 (pshufb de 128 bits)
+ * @return true se suportado (resultado é calculado uma única vez)
+ *
+ * Não é um nível próprio: os kernels do nível SSE2 que dependem de pshufb
+ * consultam esta função e escolhem outro caminho em CPUs só com SSE2.
+ */
+bool cpu_supports_ssse3();
+
+/**
+ * @brief Limita um nível SIMD desejado ao que a CPU realmente suporta
+ * @param requested Nível desejado
+ * @return Menor valor entre o nível desejado e o detectado
+ */
+SimdLevel clamp_simd_level(SimdLevel requested);
+
+/**
+ * @brief Retorna o nome legível de um nível SIMD
+ * @param level Nível SIMD
+ * @return Nome (ex: "AVX2")
+ */
+const char* simd_level_name(SimdLevel level);
+
+/**
+ * @brief Converte um nome (scalar, sse2, avx2, avx512, auto) em nível SIMD
+ * @param name Nome do nível (maiúsculas ou minúsculas)
+ * @param level Nível resultante
+ * @return true se o nome for reconhecido
+ */
+bool parse_simd_level(const std::string& name, SimdLevel& level);
+
+/**
+ * @brief Conta os bits zero menos significativos de uma máscara não nula
+ * @param mask Máscara (deve ser diferente de zero)
+ * @return Índice do primeiro bit ligado
+ */
+inline unsigned count_trailing_zeros(uint64_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "file_carver.h"
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+class ChunkReader;
+
+/**
+ * @brief Fila limitada de extrações atendida por threads de gravação
+ *
+ * O varredor enfileira cada arquivo aceito e segue lendo a imagem enquanto
+ * as threads de gravação copiam os bytes, cada uma com o seu leitor. Os
+ * arquivos são devolvidos (retire) na ordem em que foram enfileirados, já
+ * com o resultado da extração, sempre na thread que chama submit/drain.
+ * Com a fila cheia, submit bloqueia até o arquivo mais antigo terminar.
+ *
+ * Antes da extração cada arquivo pode passar por uma preparação, feita em
+ * paralelo (ex: hash do conteúdo), e por uma etapa ordenada, executada um
+ * arquivo por vez na ordem de envio (ex: decidir se é duplicata), com o
+ * leitor da thread que a executa.
+ */
+class ExtractionQueue {
+public:
+    using Prepare = std::function<void(CarvedFile&, ChunkReader&)>;
+    using Claim = std::function<void(CarvedFile&, ChunkReader&)>;
+    using Extractor = std::function<bool(CarvedFile&, ChunkReader&)>;
+    using Retire = std::function<void(CarvedFile&)>;
+
+private:
+    struct Job {
+        CarvedFile file;
+        size_t sequence;                // Ordem de envio
+        bool done;
+    };
+
+    std::deque<Job> jobs_;              // Em andamento, na ordem de envio
+    std::deque<Job*> waiting_;          // Ainda não pegos por uma thread
+    std::vector<std::thread> writers_;
+    std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable job_done_;
+    std::condition_variable claim_turn_;
+    size_t capacity_;
+    size_t next_sequence_;              // Próximo número de envio
+    size_t next_claim_;                 // Envio que pode entrar na etapa ordenada
+    bool stopping_;
+    Prepare prepare_;
+    Claim claim_;
+    Extractor extract_;
+    Retire retire_;
+
+    void writer_loop(ChunkReader& reader);
+
+    /**
+     * @brief Devolve o arquivo mais antigo (já concluído), sem o lock durante o retire
+     */
+    void retire_front(std::unique_lock<std::mutex>& lock);
+
+public:
+    /**
+     * @brief Construtor - inicia uma thread de gravação por leitor
+     * @param readers Leitores abertos na imagem (um por thread, devem viver mais que a fila)
+     * @param capacity Máximo de arquivos em andamento
+     * @param extract Extração de um arquivo (preenche os bytes no destino)
+     * @param retire Recebe cada arquivo concluído, em ordem
+     * @param prepare Preparação em paralelo, antes da etapa ordenada (opcional)
+     * @param claim Etapa ordenada, antes da extração (opcional)
+     */
+    ExtractionQueue(const std::vector<ChunkReader*>& readers, size_t capacity, Extractor extract, Retire retire,
+                    Prepare prepare = nullptr, Claim claim = nullptr);
+
+    /**
+     * @brief Destrutor - conclui as extrações pendentes e encerra as threads
+     */
+    ~ExtractionQueue();
+
+    // Não permite cópia
+    ExtractionQueue(const ExtractionQueue&) = delete;
+    ExtractionQueue& operator=(const ExtractionQueue&) = delete;
+
+    /**
+     * @brief Enfileira um arquivo (bloqueia enquanto a fila está cheia)
+     * @param file Arquivo já nomeado
+     */
+    void submit(CarvedFile file);
+
+    /**
+     * @brief Aguarda todas as extrações e devolve os arquivos restantes
+     */
+    void drain();
+};
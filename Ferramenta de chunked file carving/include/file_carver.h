@@ -2,12 +2,23 @@
 
 #include "file_signature.h"
 #include "chunk_reader.h"
+#include "footer_tracker.h"
+#include "interval_index.h"
+#include "result_sink.h"
+#include "known_hashes.h"
+#include "content_hash.h"
+#include "block_classifier.h"
 #include <string>
 #include <vector>
 #include <memory>
 #include <map>
+#include <set>
 #include <functional>
 
+class GapCarver;
+class ThreadPool;
+class ExtractionQueue;
+
 /**
  * @brief Estrutura que representa um arquivo encontrado
  */
@@ -17,8 +28,25 @@ struct CarvedFile {
     size_t start_offset;           // Posição inicial no arquivo fonte
     size_t end_offset;             // Posição final no arquivo fonte
     size_t file_size;              // Tamanho do arquivo carved
-    bool has_valid_footer;         // Se foi encontrado footer válido
+    bool has_valid_footer;         // Se o fim foi confirmado (footer ou estrutura)
+    bool structure_resolved;       // Se o tamanho veio da estrutura do formato
     bool extracted;                // Se foi extraído com sucesso
+    std::vector<std::pair<size_t, size_t>> fragments;  // [início, fim) de cada fragmento (vazio = contíguo)
+    size_t parent_offset;          // Cabeçalho do arquivo que contém este (SIZE_MAX = nenhum)
+    bool hashed = false;           // Se content_hash (e sha256, se pedido) foram calculados
+    uint64_t content_hash = 0;     // XXH3 do conteúdo extraído
+    std::string sha256;            // SHA-256 em hexadecimal (vazio = não calculado)
+    std::string duplicate_of;      // Arquivo anterior com o mesmo conteúdo (vazio = nenhum)
+    bool known = false;            // Hash no banco de arquivos conhecidos (descartado)
+};
+
+/**
+ * @brief Tratamento dos arquivos com conteúdo idêntico a um anterior
+ */
+enum class DedupMode {
+    NONE,       // Grava todos (a duplicata só é indicada no relatório)
+    SKIP,       // Não grava a duplicata
+    LINK        // Cria um hard link para o arquivo anterior
 };
 
 /**
@@ -29,22 +57,80 @@ private:
     std::unique_ptr<FileSignatureDetector> signature_detector_;
     std::unique_ptr<ChunkReader> chunk_reader_;
     std::string output_directory_;
-    std::vector<CarvedFile> carved_files_;
+    std::vector<std::unique_ptr<ResultSink>> result_sinks_;
     
     // Configurações
     size_t min_file_size_;
     size_t max_file_size_;
     bool extract_files_;
     bool use_footers_;
+    bool use_structure_;
+    bool bifragment_;
+    size_t max_gap_;                // Maior intervalo testado entre dois fragmentos
+    bool skip_carved_;              // Não procura cabeçalhos dentro de arquivos já extraídos
     size_t search_window_;
+    size_t num_threads_;
+    size_t extraction_writers_;     // 0 = extração na própria thread de varredura
+    size_t extraction_queue_depth_; // Máximo de arquivos aguardando gravação
+    bool hash_files_;               // Calcula o XXH3 do conteúdo de cada arquivo
+    bool hash_sha256_;              // Calcula também o SHA-256 (relatório e hashes conhecidos)
+    DedupMode dedup_mode_;
+    std::unique_ptr<KnownHashSet> known_hashes_;   // Arquivos conhecidos, descartados sem gravar
+    size_t block_size_;             // 0 = testa cabeçalhos em todos os offsets
+    size_t block_offset_;           // Base do alinhamento (início da partição)
+    std::vector<std::pair<size_t, size_t>> unaligned_regions_;  // [início, fim) varridos byte a byte
+    BlockClassifier block_classifier_;
+    bool skip_uniform_blocks_;      // Sem busca de cabeçalhos em blocos zerados/uniformes
+    bool skip_entropy_blocks_;      // Sem busca de cabeçalhos em blocos de alta entropia
+    std::string block_map_file_;    // Vazio = sem mapa de blocos
+    std::map<std::string, int> filename_counters_;
+    
+    // Conteúdo já visto: o hash rápido só escolhe os candidatos, a igualdade é
+    // confirmada pelo SHA-256 (se calculado) ou comparando os bytes na imagem
+    struct ContentEntry {
+        std::string filename;                               // Primeiro arquivo com esse conteúdo
+        std::string sha256;                                 // Vazio sem --sha256
+        std::vector<std::pair<size_t, size_t>> ranges;      // Trechos [início, fim) na imagem, em ordem
+    };
+    // (XXH3, tamanho) -> conteúdos distintos com essa chave.
+    // Só acessado na etapa ordenada (claim_content), um arquivo por vez
+    std::map<std::pair<uint64_t, size_t>, std::vector<ContentEntry>> content_index_;
+    // Originais gravados, alvos válidos de hard link (só na thread que registra)
+    std::set<std::string> link_targets_;
     
     // Estatísticas
     size_t files_found_;
     size_t files_extracted_;
+    size_t files_duplicated_;
+    size_t files_known_;
     size_t bytes_processed_;
+    std::map<std::string, TypeTotals> type_totals_;
+    BlockTotals block_totals_;
     
     // Callback para progresso
     std::function<void(double)> progress_callback_;
+    int last_progress_step_;
+    
+    /**
+     * @brief Arquivo detectado durante a varredura, ainda sem nome ou extração
+     */
+    struct ScanHit {
+        CarvedFile file;
+        const FileSignature* signature;
+        size_t structure_failure;       // != 0: estrutura falhou no meio, candidato a dois fragmentos
+        size_t structure_verified;
+    };
+    
+    /**
+     * @brief Classificação dos blocos de uma varredura (ou de um worker)
+     */
+    struct BlockSurvey {
+        BlockTotals totals;
+        std::vector<BlockRun> runs;     // Só com mapa de blocos
+        size_t next_block = 0;          // Próximo bloco a registrar
+        size_t read_end = 0;            // Fim do último chunk classificado
+        size_t zero_tail = 0;           // Zeros no fim dele (até um bloco)
+    };
     
 public:
     /**
@@ -82,12 +168,134 @@ public:
      */
     void set_use_footers(bool use_footers);
     
+    /**
+     * @brief Define se o tamanho é resolvido pela estrutura dos formatos conhecidos
+     * @param use_structure true para ler campos de tamanho / percorrer a estrutura
+     */
+    void set_use_structure(bool use_structure);
+    
+    /**
+     * @brief Habilita a busca do segundo fragmento de JPEG, ZIP e PDF cuja estrutura falha no meio
+     * @param bifragment true para testar pontos de corte e intervalos (requer a estrutura)
+     * @param max_gap Maior intervalo, em bytes, entre os dois fragmentos
+     *
+     * Os pontos de corte e intervalos são múltiplos do tamanho de bloco
+     * (set_block_alignment) ou de 4096 bytes, se não definido.
+     */
+    void set_bifragment(bool bifragment, size_t max_gap);
+    
+    /**
+     * @brief Define o tratamento de cabeçalhos dentro de arquivos já extraídos
+     * @param skip_carved true para pular as regiões de arquivos com fim
+     *        confirmado (footer ou estrutura); false mantém os arquivos
+     *        embutidos (miniaturas, membros de ZIP), marcados no relatório
+     *        com o arquivo que os contém
+     */
+    void set_skip_carved(bool skip_carved);
+    
     /**
      * @brief Define janela de busca para footers
      * @param window_size Tamanho da janela em bytes
      */
     void set_search_window(size_t window_size);
     
+    /**
+     * @brief Configura o tamanho dos chunks de leitura
+     * @param chunk_size Tamanho em bytes (arredondado ao setor no modo DIRECT)
+     */
+    void set_chunk_size(size_t chunk_size);
+    
+    /**
+     * @brief Configura o overlap entre chunks consecutivos
+     * @param overlap_size Tamanho em bytes
+     */
+    void set_overlap_size(size_t overlap_size);
+    
+    /**
+     * @brief Define o nível SIMD usado na busca de cabeçalhos
+     * @param level Nível desejado (limitado ao suportado pela CPU)
+     */
+    void set_simd_level(SimdLevel level);
+    
+    /**
+     * @brief Define o backend de leitura do arquivo de entrada
+     * @param backend STREAM (cópia via ifstream), MMAP (visões sem cópia) ou DIRECT (sem cache de páginas)
+     */
+    void set_reader_backend(ReaderBackend backend);
+    
+    /**
+     * @brief Define quantas leituras de chunk ficam em andamento durante a varredura
+     * @param io_depth Profundidade da fila (0 = leitura síncrona)
+     */
+    void set_io_depth(size_t io_depth);
+    
+    /**
+     * @brief Pede páginas enormes para o buffer circular de leitura síncrona
+     * @param huge_pages true para tentar páginas de 2MB
+     */
+    void set_huge_pages(bool huge_pages);
+    
+    /**
+     * @brief Restringe a busca de cabeçalhos a offsets alinhados a blocos
+     * @param block_size Tamanho do bloco (0 ou 1 = todos os offsets)
+     * @param block_offset Base do alinhamento: são testados os offsets
+     *        congruentes a block_offset módulo block_size
+     */
+    void set_block_alignment(size_t block_size, size_t block_offset);
+    
+    /**
+     * @brief Adiciona uma região varrida em todos os offsets mesmo no modo alinhado
+     * @param begin Início da região (inclusivo)
+     * @param end Fim da região (exclusivo)
+     */
+    void add_unaligned_region(size_t begin, size_t end);
+    
+    /**
+     * @brief Habilita a classificação de blocos antes da busca de cabeçalhos
+     * @param skip_uniform true para não procurar cabeçalhos em blocos zerados ou de um só byte
+     * @param skip_entropy true para não procurar cabeçalhos em blocos de alta entropia
+     * @param map_file Mapa de blocos em CSV (vazio = sem mapa)
+     *
+     * Os blocos têm o tamanho de set_block_alignment (4096 se não definido)
+     * e os footers continuam sendo procurados em todos eles. A alta entropia
+     * só é estimada com skip_entropy ou com o mapa.
+     */
+    void set_block_classification(bool skip_uniform, bool skip_entropy, const std::string& map_file);
+    
+    /**
+     * @brief Define o número de threads de varredura
+     * @param num_threads Número de threads (0 = número de núcleos, 1 = sequencial)
+     */
+    void set_num_threads(size_t num_threads);
+    
+    /**
+     * @brief Define as threads de gravação dos arquivos aceitos
+     * @param writers Número de threads (0 = extrai na thread que emite os
+     *        resultados: a de varredura, ou a principal no modo paralelo)
+     * @param queue_depth Máximo de arquivos enfileirados antes de a varredura esperar
+     */
+    void set_extraction_writers(size_t writers, size_t queue_depth);
+    
+    /**
+     * @brief Habilita o hash do conteúdo dos arquivos aceitos
+     * @param hash_files true para calcular o XXH3 (usado na deduplicação)
+     * @param sha256 true para calcular também o SHA-256 para os relatórios
+     *
+     * Funciona também sem extração (set_extract_files(false)): os arquivos
+     * são lidos e identificados, mas nada é gravado.
+     */
+    void set_hashing(bool hash_files, bool sha256);
+    
+    /**
+     * @brief Define o tratamento de conteúdos repetidos (requer o hash)
+     * @param mode NONE grava todos, SKIP não grava as duplicatas, LINK cria hard links
+     *
+     * O original é sempre o primeiro arquivo, em ordem de offset, com o
+     * mesmo conteúdo: XXH3 e tamanho iguais, confirmados pelo SHA-256 (se
+     * calculado) ou pela comparação dos bytes.
+     */
+    void set_dedup(DedupMode mode);
+    
     /**
      * @brief Define callback para atualizações de progresso
      * @param callback Função que recebe percentual (0.0-100.0)
@@ -100,6 +308,30 @@ public:
      */
     void add_custom_signature(const FileSignature& signature);
     
+    /**
+     * @brief Adiciona várias assinaturas customizadas de uma vez
+     * @param signatures Assinaturas a serem adicionadas
+     */
+    void add_custom_signatures(const std::vector<FileSignature>& signatures);
+    
+    /**
+     * @brief Carrega assinaturas adicionais de um arquivo de configuração
+     * @param filename Arquivo no formato de signatures.conf
+     * @return true se carregado com sucesso
+     */
+    bool load_signatures(const std::string& filename);
+    
+    /**
+     * @brief Carrega o banco de hashes de arquivos conhecidos (carver-hashdb)
+     * @param filename Banco mapeado em memória (não é lido por inteiro)
+     * @return true se carregado com sucesso
+     *
+     * Habilita o hash do conteúdo, inclusive o SHA-256; arquivos cujo
+     * SHA-256 está no banco são descartados antes de qualquer gravação e
+     * ficam fora dos relatórios.
+     */
+    bool load_known_hashes(const std::string& filename);
+    
     /**
      * @brief Executa o processo de carving em um arquivo
      * @param input_file Caminho para o arquivo de entrada
@@ -116,10 +348,18 @@ public:
     bool carve_file_types(const std::string& input_file, const std::vector<std::string>& file_types);
     
     /**
-     * @brief Retorna lista de arquivos encontrados
-     * @return Vetor com arquivos carved
+     * @brief Adiciona um destino de relatório, alimentado à medida que os arquivos são aceitos
+     * @param sink Destino já criado (ResultSink::create)
+     *
+     * Os destinos recebem o resumo e são fechados ao fim do próximo carving.
+     */
+    void add_result_sink(std::unique_ptr<ResultSink> sink);
+    
+    /**
+     * @brief Retorna os totais por tipo de arquivo da última execução
+     * @return Quantidade e bytes por tipo
      */
-    const std::vector<CarvedFile>& get_carved_files() const;
+    const std::map<std::string, TypeTotals>& get_type_totals() const;
     
     /**
      * @brief Retorna estatísticas do processo
@@ -130,50 +370,300 @@ public:
     void get_statistics(size_t& files_found, size_t& files_extracted, size_t& bytes_processed) const;
     
     /**
-     * @brief Gera relatório em formato texto
-     * @param output_file Arquivo de saída para o relatório
-     * @return true se o relatório foi gerado com sucesso
+     * @brief Limpa resultados anteriores
+     */
+    void clear_results();
+
+private:
+    /**
+     * @brief Varredura sequencial do arquivo inteiro com o leitor principal
+     * @param input_file Caminho para o arquivo de entrada (leitores das threads de gravação)
+     * @param file_types Tipos de arquivo para procurar (vazio = todos)
      */
-    bool generate_report(const std::string& output_file) const;
+    void carve_sequential(const std::string& input_file, const std::vector<std::string>& file_types);
     
     /**
-     * @brief Gera relatório em formato CSV
-     * @param output_file Arquivo de saída para o relatório CSV
-     * @return true se o relatório foi gerado com sucesso
+     * @brief Abre um leitor adicional com a mesma configuração do principal
+     * @param input_file Caminho para o arquivo de entrada
+     * @param read_ahead Se usa a leitura antecipada (só leitores que varrem chunks)
+     * @return Leitor aberto (lança std::runtime_error se falhar)
      */
-    bool generate_csv_report(const std::string& output_file) const;
+    std::unique_ptr<ChunkReader> open_worker_reader(const std::string& input_file, bool read_ahead) const;
     
     /**
-     * @brief Limpa resultados anteriores
+     * @brief Varredura paralela em faixas sobrepostas com pool de threads
+     * @param input_file Caminho para o arquivo de entrada
+     * @param file_types Tipos de arquivo para procurar (vazio = todos)
      */
-    void clear_results();
-
-private:
+    void carve_parallel(const std::string& input_file, const std::vector<std::string>& file_types);
+    
+    /**
+     * @brief Cria a fila de gravação da varredura, com um leitor por thread de gravação
+     * @param input_file Caminho para o arquivo de entrada
+     * @param readers Recebe os leitores das threads (devem viver mais que a fila)
+     * @return Fila, ou nullptr sem extração nem hash ou com zero threads de gravação
+     */
+    std::unique_ptr<ExtractionQueue> make_extraction_queue(const std::string& input_file,
+                                                            std::vector<std::unique_ptr<ChunkReader>>& readers);
+    
+    /**
+     * @brief Varre uma faixa do arquivo, lendo além do fim o suficiente para
+     *        cobrir cabeçalhos que começam dentro dela
+     * @param reader Leitor exclusivo da thread atual
+     * @param range_begin Início da faixa (inclusivo)
+     * @param range_end Fim da faixa (exclusivo)
+     * @param file_types Tipos de arquivo para procurar (vazio = todos)
+     * @param survey Classificação de blocos do worker (nullptr = desabilitada)
+     * @param hits Arquivos detectados, em ordem de offset
+     */
+    void scan_range(ChunkReader& reader, size_t range_begin, size_t range_end,
+                    const std::vector<std::string>& file_types, BlockSurvey* survey,
+                    std::vector<ScanHit>& hits) const;
+    
     /**
      * @brief Processa um chunk de dados
+     * @param tracker Candidatos aguardando footer nesta varredura
      * @param data Buffer com os dados
      * @param chunk_size Tamanho do chunk
      * @param file_offset Offset do chunk no arquivo original
+     * @param owned_begin Menor offset de cabeçalho aceito
+     * @param owned_end Offset de cabeçalho a partir do qual os hits são ignorados
      * @param file_types Tipos de arquivo para procurar (vazio = todos)
+     * @param carved Regiões de arquivos já aceitos a pular (nullptr = varre o chunk inteiro)
+     * @param survey Classificação de blocos da varredura (nullptr = desabilitada)
+     * @param hits Arquivos cujo fim já foi resolvido, na ordem de detecção
+     */
+    void process_chunk(FooterTracker& tracker, const uint8_t* data, size_t chunk_size,
+                      size_t file_offset, size_t owned_begin, size_t owned_end,
+                      const std::vector<std::string>& file_types, const IntervalIndex* carved,
+                      BlockSurvey* survey, std::vector<ScanHit>& hits) const;
+    
+    /**
+     * @brief Classifica os blocos completos de um chunk
+     * @param data Buffer com os dados
+     * @param chunk_size Tamanho do chunk
+     * @param file_offset Offset do chunk no arquivo original
+     * @param owned_end Fim da região do chunk
+     * @param survey Totais e mapa (blocos ainda não contados com início antes de owned_end)
+     * @param skipped Regiões [início, fim) sem busca de cabeçalhos, em ordem
+     *
+     * O fim de cada região pulada é encurtado pelo maior cabeçalho menos um
+     * byte: um cabeçalho que começa ali termina no bloco seguinte.
+     */
+    void classify_blocks(const uint8_t* data, size_t chunk_size, size_t file_offset,
+                         size_t owned_end, BlockSurvey& survey,
+                         std::vector<std::pair<size_t, size_t>>& skipped) const;
+    
+    /**
+     * @brief Primeiro início de bloco em ou após um offset
+     */
+    size_t first_block_at(size_t offset) const;
+    
+    /**
+     * @brief Conta os blocos de [begin, end) em uma classe (e no mapa, se pedido)
+     */
+    void record_blocks(BlockSurvey& survey, size_t begin, size_t end, BlockClass type) const;
+    
+    /**
+     * @brief Registra os blocos ainda não contados antes de end
+     * @param survey Classificação do worker
+     * @param end Início do próximo bloco a registrar
+     * @param resumed Offset em que a leitura recomeçou (além de read_end: buraco saltado)
+     * @param data Chunk lido em resumed (zeros iniciais ainda fazem parte do buraco)
+     * @param size Bytes de data a examinar
+     *
+     * Blocos inteiros no buraco e nos zeros que o cercam contam como zerados;
+     * os demais (que nenhum chunk conteve por inteiro) como dados.
+     */
+    void fill_block_gap(BlockSurvey& survey, size_t end, size_t resumed, const uint8_t* data, size_t size) const;
+    
+    /**
+     * @brief Posiciona a classificação no início de uma varredura
+     * @param survey Classificação do worker
+     * @param begin Início da faixa varrida
+     */
+    void start_block_survey(BlockSurvey& survey, size_t begin) const;
+    
+    /**
+     * @brief Registra os blocos da faixa que o leitor não entregou
+     * @param survey Classificação do worker
+     * @param end Fim da faixa varrida
+     * @param resumed Offset do primeiro chunk lido depois dela (ou o tamanho do arquivo)
+     *
+     * São os buracos de arquivos esparsos, saltados sem leitura: contam como
+     * blocos zerados, de modo que totais e mapa são os de uma leitura completa.
+     */
+    void close_block_survey(BlockSurvey& survey, size_t end, size_t resumed) const;
+    
+    /**
+     * @brief Junta as classificações dos workers, grava o mapa e exibe os totais
+     * @param surveys Uma por varredura (consumidas)
+     */
+    void finish_block_survey(std::vector<BlockSurvey>& surveys);
+    
+    /**
+     * @brief Verifica se os blocos são classificados durante a varredura
+     */
+    bool classifying_blocks() const;
+    
+    /**
+     * @brief Fim da região de cabeçalhos que pertence a um chunk
+     * @param chunk Chunk atual (inclui o overlap do anterior)
+     * @param reader Leitor que produziu o chunk
+     * @return Primeiro offset de cabeçalho deixado para o próximo chunk
+     *         (SIZE_MAX no último chunk)
+     *
+     * Um cabeçalho pertence ao primeiro chunk que o contém por inteiro: os
+     * offsets finais, cujo cabeçalho mais longo passaria do fim do chunk,
+     * ficam para o próximo, que os recebe no overlap. Assim cada cabeçalho
+     * abre um único candidato, e o overlap não gera buscas de footer nem
+     * extrações repetidas.
+     */
+    size_t header_claim_end(const ChunkView& chunk, const ChunkReader& reader) const;
+    
+    /**
+     * @brief Procura os cabeçalhos de um chunk conforme o modo de alinhamento
+     * @param data Buffer com os dados
+     * @param chunk_size Tamanho do chunk
+     * @param file_offset Offset do chunk no arquivo original
+     * @param matches Ocorrências (offsets relativos ao chunk), ordenadas por offset e padrão
+     */
+    void find_headers(const uint8_t* data, size_t chunk_size, size_t file_offset,
+                      std::vector<HeaderMatch>& matches) const;
+    
+    /**
+     * @brief Converte os candidatos resolvidos em hits, aplicando os filtros de tamanho
+     * @param tracker Candidatos da varredura atual
+     * @param hits Arquivos aceitos (acrescentados ao final)
      */
-    void process_chunk(const std::vector<uint8_t>& data, size_t chunk_size, 
-                      size_t file_offset, const std::vector<std::string>& file_types);
+    void collect_resolved(FooterTracker& tracker, std::vector<ScanHit>& hits) const;
     
     /**
-     * @brief Procura por footers para delimitar arquivo
-     * @param start_offset Posição inicial do arquivo
+     * @brief Verifica os limites de tamanho globais e o MAX_SIZE da assinatura
      * @param signature Assinatura do arquivo
-     * @param max_search_size Tamanho máximo para procurar
-     * @return Posição do footer ou SIZE_MAX se não encontrado
+     * @param file_size Tamanho do arquivo
+     * @return true se o tamanho é aceito
      */
-    size_t find_footer(size_t start_offset, const FileSignature* signature, size_t max_search_size);
+    bool within_size_limits(const FileSignature* signature, size_t file_size) const;
+    
+    /**
+     * @brief Procura o segundo fragmento dos hits cuja estrutura falhou e aplica os filtros de tamanho
+     * @param gap_carver Validador de hipóteses de dois fragmentos
+     * @param hits Hits da varredura (os descartados pelos filtros são removidos)
+     */
+    void carve_gaps(GapCarver& gap_carver, std::vector<ScanHit>& hits) const;
+    
+    /**
+     * @brief Conclui um lote de hits: fragmentos, arquivos embutidos, nomes, hash e extração
+     * @param hits Hits em ordem de offset, posteriores aos lotes anteriores (esvaziado)
+     * @param gap_carver Validador de dois fragmentos (nullptr = desabilitado)
+     * @param carved Regiões dos arquivos já aceitos
+     * @param extraction Fila de gravação (nullptr = hash e extração nesta thread, com o leitor principal)
+     */
+    void emit_hits(std::vector<ScanHit>& hits, GapCarver* gap_carver, IntervalIndex& carved,
+                   ExtractionQueue* extraction);
+    
+    /**
+     * @brief Marca (ou descarta, com skip_carved) os hits contidos em arquivos já aceitos
+     * @param carved Regiões dos arquivos aceitos (os hits com fim confirmado são acrescentados)
+     * @param hits Hits em ordem de offset
+     */
+    void classify_nested(IntervalIndex& carved, std::vector<ScanHit>& hits) const;
+    
+    /**
+     * @brief Cria o GapCarver da varredura, com um pool próprio e um leitor por worker
+     * @param input_file Caminho para o arquivo de entrada
+     * @param pool Recebe o pool que executa as hipóteses (uma thread por núcleo)
+     * @param readers Recebe os leitores dos workers (devem viver mais que o GapCarver)
+     * @return GapCarver, ou nullptr se a busca de fragmentos está desabilitada
+     */
+    std::unique_ptr<GapCarver> make_gap_carver(const std::string& input_file, std::unique_ptr<ThreadPool>& pool,
+                                               std::vector<std::unique_ptr<ChunkReader>>& readers) const;
     
     /**
      * @brief Extrai arquivo para disco
-     * @param carved_file Informações do arquivo a ser extraído
+     * @param carved_file Informações do arquivo a ser extraído (recebe o
+     *        hash quando ele é calculado durante a cópia)
+     * @param reader Leitor a ser usado
      * @return true se extraído com sucesso
      */
-    bool extract_file(CarvedFile& carved_file);
+    bool extract_file(CarvedFile& carved_file, ChunkReader& reader) const;
+    
+    /**
+     * @brief Calcula o hash do conteúdo (todos os fragmentos, em ordem)
+     * @param carved_file Arquivo aceito (recebe content_hash e sha256)
+     * @param reader Leitor a ser usado
+     */
+    void hash_file(CarvedFile& carved_file, ChunkReader& reader) const;
+    
+    /**
+     * @brief Guarda no arquivo o resultado dos hashes do seu conteúdo
+     * @param carved_file Arquivo cujo conteúdo inteiro passou pelos hashes
+     * @param xxh Hash rápido do conteúdo
+     * @param sha SHA-256 do conteúdo (usado só com hash_sha256_)
+     */
+    void store_hashes(CarvedFile& carved_file, const Xxh3& xxh, const Sha256& sha) const;
+    
+    /**
+     * @brief Verifica se o conteúdo dos arquivos aceitos deve ser lido e identificado
+     * @return true com --hash, --dedup ou banco de hashes conhecidos
+     */
+    bool hashing_enabled() const;
+    
+    /**
+     * @brief Verifica se o hash precisa ser calculado antes da extração
+     * @return true se o hash decide o que é gravado (duplicatas, arquivos
+     *         conhecidos) ou se não há extração para aproveitar
+     *
+     * Caso contrário o hash é calculado durante a cópia, na mesma leitura
+     * dos bytes, e a busca de duplicatas fica para depois da extração.
+     */
+    bool hash_before_extract() const;
+    
+    /**
+     * @brief Procura um arquivo anterior com o mesmo conteúdo
+     * @param carved_file Arquivo já com hash (recebe duplicate_of)
+     * @param reader Leitor usado para comparar os bytes quando não há SHA-256
+     *
+     * Deve ser chamado na ordem de offset: o primeiro arquivo de cada
+     * conteúdo é o original, independentemente de qual termina antes. Um
+     * XXH3 e tamanho iguais não bastam: sem o SHA-256 os bytes dos dois
+     * arquivos são comparados antes de apontar a duplicata.
+     */
+    void claim_content(CarvedFile& carved_file, ChunkReader& reader);
+    
+    /**
+     * @brief Compara o conteúdo de dois conjuntos de trechos da imagem
+     * @param a Trechos [início, fim) do primeiro arquivo, em ordem
+     * @param b Trechos [início, fim) do segundo arquivo, em ordem
+     * @param reader Leitor da imagem
+     * @return true se os bytes concatenados são iguais
+     */
+    bool same_content(const std::vector<std::pair<size_t, size_t>>& a,
+                      const std::vector<std::pair<size_t, size_t>>& b, ChunkReader& reader) const;
+    
+    /**
+     * @brief Conclui a deduplicação de um arquivo já extraído (ou pulado)
+     * @param carved_file Arquivo na ordem de registro; duplicatas recebem o hard link
+     */
+    void link_duplicate(CarvedFile& carved_file);
+    
+    /**
+     * @brief Registra um arquivo aceito nas estatísticas e nos destinos de relatório
+     * @param carved_file Arquivo já nomeado (e extraído, se for o caso)
+     */
+    void record_carved_file(const CarvedFile& carved_file);
+    
+    /**
+     * @brief Grava o resumo nos destinos de relatório e os fecha
+     */
+    void finish_result_sinks();
+    
+    /**
+     * @brief Atualiza o progresso e exibe marcos de 5%
+     * @param progress Progresso atual (0.0-100.0)
+     */
+    void report_progress(double progress);
     
     /**
      * @brief Gera nome único para arquivo
@@ -4,6 +4,11 @@
 #include <string>
 #include <unordered_map>
 #include <cstdint>
+#include "builtin_signatures.h"
+#include "header_matcher.h"
+#include "header_prefilter.h"
+#include "length_resolver.h"
+#include "pattern_searcher.h"
 
 /**
  * @brief Estrutura que representa uma assinatura de arquivo
@@ -17,15 +22,34 @@ struct FileSignature {
     bool has_footer;            // Se o arquivo tem rodapé conhecido
 };
 
+/**
+ * @brief Compara nomes de tipo sem diferenciar maiúsculas (ex: "gif89a" e "GIF89a")
+ * @return true se os nomes designam o mesmo tipo
+ */
+bool same_signature_name(const std::string& a, const std::string& b);
+
 /**
  * @brief Classe para detectar e gerenciar assinaturas de arquivos
  */
 class FileSignatureDetector {
 private:
+    static constexpr uint32_t NO_FOOTER = UINT32_MAX;
+    
     std::vector<FileSignature> signatures_;
-    std::unordered_map<std::string, size_t> name_to_index_;
+    std::unordered_map<std::string, size_t> name_to_index_;  // Nome em maiúsculas -> índice
+    HeaderMatcher header_matcher_;
+    HeaderPrefilter header_prefilter_;
+    std::vector<PatternSearcher> footer_searchers_;  // Um por footer distinto
+    std::vector<uint32_t> footer_index_;             // Por assinatura: índice em footer_searchers_
+    std::vector<StructureFormat> structure_formats_; // Por assinatura: formato para resolver o tamanho
+    size_t builtin_count_;                           // Assinaturas vindas de BUILTIN_SIGNATURES
+    bool builtin_fast_path_;                         // Conjunto atual é exatamente o embutido
+    bool loaded_from_cache_;
     
     void initialize_common_signatures();
+    void insert_signature(const FileSignature& signature);
+    void rebuild_matcher();
+    void rebuild_search_tables(const std::vector<std::vector<uint8_t>>& headers);
     
 public:
     /**
@@ -39,6 +63,12 @@ public:
      */
     void add_signature(const FileSignature& signature);
     
+    /**
+     * @brief Adiciona um lote de assinaturas reconstruindo o autômato uma única vez
+     * @param signatures Assinaturas a serem adicionadas
+     */
+    void add_signatures(const std::vector<FileSignature>& signatures);
+    
     /**
      * @brief Detecta o tipo de arquivo baseado nos primeiros bytes
      * @param data Buffer com os dados para análise
@@ -47,6 +77,57 @@ public:
      */
     const FileSignature* detect_header(const uint8_t* data, size_t size) const;
     
+    /**
+     * @brief Detecta todos os tipos cujo cabeçalho começa no início do buffer
+     * @param data Buffer com os dados para análise
+     * @param size Tamanho do buffer
+     * @param matches Assinaturas detectadas, na ordem em que foram registradas
+     */
+    void detect_headers(const uint8_t* data, size_t size, std::vector<const FileSignature*>& matches) const;
+    
+    /**
+     * @brief Procura todos os cabeçalhos conhecidos em um buffer em uma única passada
+     * @param data Buffer com os dados
+     * @param size Tamanho do buffer
+     * @param matches Ocorrências encontradas (pattern_id = índice em get_signatures())
+     */
+    void scan_headers(const uint8_t* data, size_t size, std::vector<HeaderMatch>& matches) const;
+    
+    /**
+     * @brief Procura cabeçalhos apenas em posições alinhadas (first, first + stride, ...)
+     * @param data Buffer com os dados
+     * @param size Tamanho do buffer
+     * @param first Primeira posição testada
+     * @param stride Distância entre posições testadas (tamanho do bloco)
+     * @param matches Ocorrências encontradas, ordenadas por offset e padrão
+     */
+    void scan_headers_aligned(const uint8_t* data, size_t size, size_t first, size_t stride,
+                              std::vector<HeaderMatch>& matches) const;
+    
+    /**
+     * @brief Retorna o tamanho do maior cabeçalho registrado
+     * @return Tamanho em bytes
+     */
+    size_t get_max_header_length() const;
+    
+    /**
+     * @brief Define o nível SIMD do pré-filtro de cabeçalhos
+     * @param level Nível desejado (limitado ao suportado pela CPU)
+     */
+    void set_simd_level(SimdLevel level);
+    
+    /**
+     * @brief Retorna o nível SIMD usado pelo pré-filtro
+     * @return Nível SIMD
+     */
+    SimdLevel get_simd_level() const;
+    
+    /**
+     * @brief Verifica se o pré-filtro vetorial está ativo para as assinaturas atuais
+     * @return true se ativo
+     */
+    bool is_prefilter_enabled() const;
+    
     /**
      * @brief Verifica se os dados contêm um rodapé válido
      * @param data Buffer com os dados para análise
@@ -65,6 +146,20 @@ public:
      */
     size_t find_pattern(const uint8_t* data, size_t size, const std::vector<uint8_t>& pattern) const;
     
+    /**
+     * @brief Retorna o buscador pré-calculado do footer de uma assinatura
+     * @param signature Assinatura pertencente a este detector
+     * @return Buscador do footer ou nullptr se a assinatura não tem footer
+     */
+    const PatternSearcher* get_footer_searcher(const FileSignature* signature) const;
+    
+    /**
+     * @brief Retorna o formato usado para resolver o tamanho pela estrutura
+     * @param signature Assinatura pertencente a este detector
+     * @return Formato reconhecido pelo cabeçalho da assinatura ou NONE
+     */
+    StructureFormat get_structure_format(const FileSignature* signature) const;
+    
     /**
      * @brief Retorna todas as assinaturas disponíveis
      * @return Vetor com todas as assinaturas
@@ -73,15 +168,25 @@ public:
     
     /**
      * @brief Busca uma assinatura pelo nome
-     * @param name Nome da assinatura
+     * @param name Nome da assinatura (sem diferenciar maiúsculas)
      * @return Ponteiro para a assinatura ou nullptr se não encontrada
      */
     const FileSignature* get_signature(const std::string& name) const;
     
     /**
      * @brief Carrega assinaturas de um arquivo de configuração
-     * @param filename Caminho para o arquivo de configuração
+     * @param filename Caminho para o arquivo (NOME;EXTENSAO;HEADER_HEX;FOOTER_HEX;MAX_SIZE;HAS_FOOTER)
+     * @param use_cache Usa/grava o autômato compilado em <filename>.cache
      * @return true se carregado com sucesso
+     *
+     * As assinaturas são acrescentadas às atuais; um nome já existente
+     * substitui a assinatura anterior. Em caso de erro nada é alterado.
+     */
+    bool load_signatures_from_file(const std::string& filename, bool use_cache = true);
+    
+    /**
+     * @brief Verifica se a última carga de configuração veio do cache
+     * @return true se o autômato foi mapeado do cache
      */
-    bool load_signatures_from_file(const std::string& filename);
+    bool was_loaded_from_cache() const;
 };
\ No newline at end of file
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "file_signature.h"
+#include <vector>
+#include <deque>
+#include <map>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Arquivo candidato aguardando a resolução do seu footer
+ */
+struct FooterCandidate {
+    const FileSignature* signature; // Assinatura detectada
+    size_t start_offset;            // Offset do cabeçalho
+    size_t end_offset;              // Fim do arquivo (válido quando resolvido)
+    bool has_valid_footer;          // Se o fim foi confirmado (footer ou estrutura)
+    bool structure_resolved;        // Se o fim veio da estrutura do formato
+    bool resolved;                  // Se o fim do arquivo já é conhecido
+    size_t structure_failure;       // Onde a estrutura ficou inconsistente (0 = não avaliada/falso positivo)
+    size_t structure_verified;      // Até onde a estrutura foi confirmada antes da falha
+};
+
+/**
+ * @brief Resolve footers em uma única passada sequencial
+ *
+ * Em vez de reler a janela de busca para cada cabeçalho, os candidatos
+ * ficam abertos, agrupados pelo padrão de footer, enquanto a varredura
+ * avança pelos mesmos chunks. Um candidato fecha quando o seu footer
+ * aparece ou quando a varredura ultrapassa a sua janela; os candidatos
+ * resolvidos saem na ordem em que foram abertos. Formatos com estrutura
+ * conhecida são resolvidos já na abertura pelo LengthResolver, sem busca
+ * de footer.
+ */
+class FooterTracker {
+private:
+    struct FooterGroup {
+        const PatternSearcher* searcher;  // Tabelas pré-calculadas do footer
+        size_t footer_size;
+        std::vector<size_t> open;       // Candidatos abertos (índices absolutos)
+        size_t frontier;                // Primeira posição de footer ainda não examinada
+        size_t cursor;                  // Início da última busca no chunk atual
+        size_t next_hit;                // Primeira ocorrência >= cursor no chunk atual
+    };
+
+    const FileSignatureDetector& detector_;
+    LengthResolver* resolver_;
+    size_t search_window_;
+    size_t file_size_;
+
+    std::deque<FooterCandidate> candidates_;
+    size_t first_index_;                // Índice absoluto de candidates_.front()
+    size_t open_count_;
+    std::vector<FooterGroup> groups_;
+    std::map<std::vector<uint8_t>, size_t> group_index_;
+
+    // Chunk atual
+    const uint8_t* chunk_data_;
+    size_t chunk_size_;
+    size_t chunk_offset_;
+
+    // Últimos bytes do chunk anterior (maior footer - 1): com overlap menor
+    // que o footer, a ocorrência que cruza a divisa é procurada neles
+    size_t max_footer_size_;
+    std::vector<uint8_t> tail_;
+    size_t tail_offset_;
+    std::vector<uint8_t> seam_;
+
+    size_t window_of(const FileSignature* signature) const;
+    size_t find_in_chunk(FooterGroup& group, size_t position);
+    size_t find_across_boundary(const FooterGroup& group);
+    void close(size_t index, size_t footer_position, const FooterGroup& group);
+    void expire(size_t index);
+
+public:
+    /**
+     * @brief Construtor
+     * @param detector Detector usado na busca dos footers
+     * @param search_window Janela máxima de busca a partir do cabeçalho (assinaturas
+     *        com MAX_SIZE usam o próprio limite)
+     * @param file_size Tamanho do arquivo varrido
+     * @param resolver Resolvedor de tamanho pela estrutura (nullptr = apenas footers)
+     */
+    FooterTracker(const FileSignatureDetector& detector, size_t search_window, size_t file_size,
+                  LengthResolver* resolver = nullptr);
+
+    /**
+     * @brief Avança a varredura com um novo chunk
+     * @param data Dados do chunk (válidos até a próxima chamada)
+     * @param size Tamanho do chunk
+     * @param file_offset Offset absoluto de data[0]
+     *
+     * Procura no chunk os footers dos candidatos abertos e expira os que
+     * tiveram a janela inteira examinada.
+     */
+    void feed(const uint8_t* data, size_t size, size_t file_offset);
+
+    /**
+     * @brief Abre um candidato cujo cabeçalho está no chunk atual
+     * @param signature Assinatura detectada
+     * @param start_offset Offset absoluto do cabeçalho
+     * @param use_footer false para delimitar apenas pela janela
+     *
+     * Se o formato tem estrutura conhecida e ela é consistente, o candidato
+     * já sai resolvido com o tamanho exato.
+     *
+     * @return Candidato aberto (válido até a próxima chamada de take_resolved)
+     */
+    const FooterCandidate& open(const FileSignature* signature, size_t start_offset, bool use_footer);
+
+    /**
+     * @brief Encerra a varredura, expirando todos os candidatos abertos
+     */
+    void finish();
+
+    /**
+     * @brief Verifica se ainda há candidatos aguardando footer
+     * @return true se há candidatos abertos
+     */
+    bool has_open() const;
+
+    /**
+     * @brief Retira os candidatos resolvidos, na ordem de abertura
+     * @param resolved Candidatos resolvidos (acrescentados ao final)
+     *
+     * Para no primeiro candidato ainda aberto, preservando a ordem.
+     */
+    void take_resolved(std::vector<FooterCandidate>& resolved);
+};
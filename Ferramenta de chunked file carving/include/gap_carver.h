@@ -0,0 +1,94 @@
+#pragma once
+
+#include "file_signature.h"
+#include "length_resolver.h"
+#include <vector>
+#include <map>
+#include <tuple>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+class ChunkReader;
+class ThreadPool;
+
+/**
+ * @brief Recupera arquivos gravados em dois fragmentos (bifragment gap carving)
+ *
+ * Quando o percurso da estrutura de um JPEG, ZIP ou PDF fica inconsistente no
+ * meio do arquivo, o primeiro fragmento termina em alguma fronteira de cluster
+ * entre o último ponto confirmado e a falha. Para cada ponto de corte possível
+ * são testados intervalos (múltiplos do cluster) até o início do segundo
+ * fragmento; o próprio LengthResolver, com set_gap(), serve de validador.
+ *
+ * Cada ponto de corte é uma tarefa do pool, com um resolvedor por worker. A
+ * hipótese escolhida é sempre a primeira na ordem (corte mais próximo da
+ * falha, depois menor intervalo), independentemente de qual tarefa termine
+ * antes; tarefas que só podem achar hipóteses posteriores param cedo. Os
+ * resultados ficam em cache por par de clusters (corte, continuação), de modo
+ * que cabeçalhos repetidos (overlap entre chunks, faixas paralelas) não
+ * refazem a validação.
+ */
+class GapCarver {
+private:
+    static constexpr size_t MAX_SPLITS = 256;           // Pontos de corte testados por candidato
+    static constexpr size_t MAX_EVALUATIONS = 1 << 14;  // Hipóteses (corte × intervalo) por candidato
+    static constexpr size_t MAX_CACHE_ENTRIES = 1 << 20;
+
+    struct Evaluation {
+        bool valid;
+        size_t end;         // Fim lógico (sem o intervalo)
+    };
+
+    const FileSignatureDetector& detector_;
+    ThreadPool& pool_;
+    std::vector<std::unique_ptr<LengthResolver>> resolvers_;   // Um por worker
+    size_t cluster_size_;
+    size_t cluster_base_;
+    size_t max_gap_;
+    size_t file_size_;
+
+    // (formato, início, corte, continuação) -> resultado da validação
+    std::map<std::tuple<StructureFormat, size_t, size_t, size_t>, Evaluation> cache_;
+    std::mutex cache_mutex_;
+
+    Evaluation evaluate(LengthResolver& resolver, StructureFormat format, size_t start, size_t split, size_t gap);
+
+public:
+    /**
+     * @brief Construtor
+     * @param detector Detector com os formatos estruturais das assinaturas
+     * @param pool Pool que executa as hipóteses
+     * @param readers Um leitor aberto por worker do pool (índice = worker)
+     * @param cluster_size Tamanho do cluster do sistema de arquivos
+     * @param cluster_base Offset do primeiro cluster (início da partição)
+     * @param max_gap Maior intervalo testado entre os fragmentos
+     * @param scan_limit Janela máxima examinada a partir do cabeçalho
+     */
+    GapCarver(const FileSignatureDetector& detector, ThreadPool& pool, const std::vector<ChunkReader*>& readers,
+              size_t cluster_size, size_t cluster_base, size_t max_gap, size_t scan_limit);
+
+    ~GapCarver();
+
+    /**
+     * @brief Verifica se o formato da assinatura tem validador para dois fragmentos
+     * @param signature Assinatura do candidato
+     * @return true para JPEG, ZIP e PDF
+     */
+    bool supports(const FileSignature* signature) const;
+
+    /**
+     * @brief Procura o segundo fragmento de um candidato cuja estrutura falhou
+     * @param signature Assinatura do candidato
+     * @param start Offset do cabeçalho
+     * @param verified Último offset confirmado pela estrutura
+     * @param failure Offset em que a estrutura ficou inconsistente
+     * @param fragments Intervalos [início, fim) do arquivo, em ordem (preenchido se encontrado)
+     * @return true se uma hipótese de dois fragmentos foi validada
+     *
+     * Deve ser chamado fora dos workers do pool (aguarda as tarefas).
+     */
+    bool carve(const FileSignature* signature, size_t start, size_t verified, size_t failure,
+               std::vector<std::pair<size_t, size_t>>& fragments);
+};
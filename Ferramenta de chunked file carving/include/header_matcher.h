@@ -0,0 +1,123 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Ocorrência de um cabeçalho encontrada em um buffer
+ */
+struct HeaderMatch {
+    size_t offset;          // Posição do início do cabeçalho no buffer
+    uint32_t pattern_id;    // Índice do padrão (mesmo índice da assinatura)
+};
+
+/**
+ * @brief Autômato Aho-Corasick para busca simultânea de múltiplos cabeçalhos
+ *
+ * O autômato é compilado como um DFA completo (256 transições por estado),
+ * de modo que cada byte do buffer custa uma única consulta à tabela,
+ * independentemente do número de padrões carregados.
+ *
+ * As tabelas compiladas ficam em um único bloco de palavras de 32 bits
+ * (cabeçalho + arrays), imutável e compartilhado entre cópias. O bloco
+ * pode ser salvo em disco e depois associado a uma região mapeada em
+ * memória, evitando recompilar o autômato.
+ */
+class HeaderMatcher {
+public:
+    static const size_t BLOB_HEADER_WORDS = 5;
+
+private:
+    std::shared_ptr<const void> storage_;  // Dono do bloco (vetor próprio ou mapeamento)
+    const uint32_t* blob_;                 // Início do bloco
+    size_t blob_words_;
+    const uint32_t* transitions_;          // estados x 256
+    const uint32_t* depth_;                // Profundidade de cada estado na trie
+    const uint32_t* output_begin_;         // Início da lista de saídas de cada estado
+    const uint32_t* outputs_;              // Padrões reconhecidos em cada estado
+    const uint32_t* pattern_lengths_;
+    size_t state_count_;
+    size_t max_pattern_length_;
+    size_t min_pattern_length_;
+
+public:
+    /**
+     * @brief Construtor - cria um autômato vazio
+     */
+    HeaderMatcher();
+
+    /**
+     * @brief Compila o autômato a partir de uma lista de padrões
+     * @param patterns Padrões a reconhecer (padrões vazios são ignorados)
+     */
+    void build(const std::vector<std::vector<uint8_t>>& patterns);
+
+    /**
+     * @brief Associa o autômato a um bloco compilado anteriormente
+     * @param words Bloco no formato de get_blob() (alinhado a 4 bytes)
+     * @param word_count Tamanho do bloco em palavras
+     * @param owner Mantém a memória do bloco válida enquanto o autômato existir
+     * @return true se o bloco é consistente (tamanhos e índices)
+     */
+    bool attach(const uint32_t* words, size_t word_count, std::shared_ptr<const void> owner);
+
+    /**
+     * @brief Retorna o bloco compilado, para gravação em cache
+     * @return Início do bloco
+     */
+    const uint32_t* get_blob() const;
+
+    /**
+     * @brief Retorna o tamanho do bloco compilado
+     * @return Tamanho em palavras de 32 bits
+     */
+    size_t get_blob_words() const;
+
+    /**
+     * @brief Retorna o número de padrões do autômato
+     * @return Número de padrões (inclui os vazios)
+     */
+    size_t get_pattern_count() const;
+
+    /**
+     * @brief Percorre o buffer uma única vez e reporta todas as ocorrências
+     * @param data Buffer com os dados
+     * @param size Tamanho do buffer
+     * @param matches Ocorrências encontradas, ordenadas por offset e padrão
+     */
+    void scan(const uint8_t* data, size_t size, std::vector<HeaderMatch>& matches) const;
+
+    /**
+     * @brief Reporta todos os padrões que começam exatamente no início do buffer
+     * @param data Buffer com os dados
+     * @param size Tamanho do buffer
+     * @param pattern_ids Índices dos padrões encontrados, em ordem crescente
+     */
+    void match_at(const uint8_t* data, size_t size, std::vector<uint32_t>& pattern_ids) const;
+
+    /**
+     * @brief Retorna o número de estados do autômato
+     * @return Número de estados
+     */
+    size_t get_state_count() const;
+
+    /**
+     * @brief Retorna o tamanho do maior padrão
+     * @return Tamanho em bytes
+     */
+    size_t get_max_pattern_length() const;
+
+    /**
+     * @brief Retorna o tamanho do menor padrão
+     * @return Tamanho em bytes (0 se não houver padrões)
+     */
+    size_t get_min_pattern_length() const;
+
+    /**
+     * @brief Verifica se o autômato não possui padrões
+     * @return true se vazio
+     */
+    bool empty() const;
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "cpu_features.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Pré-filtro vetorial de candidatos a cabeçalho
+ *
+ * Para cada padrão é escolhido um par de bytes "raro" (âncora). O kernel
+ * vetorial (SSE2, AVX2 ou AVX-512, escolhido em tempo de execução) procura
+ * apenas essas âncoras e devolve os offsets onde um cabeçalho pode começar;
+ * a confirmação exata fica a cargo do HeaderMatcher. No nível SSE2 o kernel
+ * usa pshufb (SSSE3) quando disponível; em CPUs só com SSE2 e muitas âncoras
+ * a varredura escalar é usada, pois é mais rápida.
+ */
+class HeaderPrefilter {
+public:
+    static const size_t MAX_ANCHORS = 32;
+
+private:
+    struct Anchor {
+        uint8_t first;                  // Primeiro byte do par
+        uint8_t second;                 // Segundo byte do par
+        bool single;                    // Âncora de um único byte (padrão de 1 byte)
+        std::vector<uint32_t> offsets;  // Posições da âncora dentro dos padrões
+    };
+
+    std::vector<Anchor> anchors_;
+    std::vector<uint8_t> first_bytes_;       // Valores distintos do primeiro byte
+    std::vector<uint8_t> second_bytes_;      // Valores distintos do segundo byte
+    uint8_t first_low_[16];                  // Grupos de âncoras por nibble (kernels vetoriais)
+    uint8_t first_high_[16];
+    uint8_t second_low_[16];
+    uint8_t second_high_[16];
+    uint32_t first_table_[256];              // Âncoras cujo primeiro byte é o índice
+    uint32_t second_table_[256];             // Âncoras cujo segundo byte é o índice
+    uint32_t single_mask_;                   // Âncoras de um único byte
+    bool enabled_;
+    SimdLevel simd_level_;
+
+    void find_anchor_positions(const uint8_t* data, size_t size, std::vector<size_t>& positions) const;
+
+public:
+    /**
+     * @brief Construtor - cria um pré-filtro desabilitado
+     */
+    HeaderPrefilter();
+
+    /**
+     * @brief Escolhe as âncoras a partir dos padrões de cabeçalho
+     * @param patterns Padrões (mesma indexação do HeaderMatcher)
+     *
+     * Se houver mais de MAX_ANCHORS âncoras distintas, o pré-filtro é
+     * desabilitado e o autômato completo deve ser usado.
+     */
+    void build(const std::vector<std::vector<uint8_t>>& patterns);
+
+    /**
+     * @brief Gera a lista de offsets onde algum cabeçalho pode começar
+     * @param data Buffer com os dados
+     * @param size Tamanho do buffer
+     * @param starts Offsets candidatos, em ordem crescente e sem repetição
+     */
+    void find_candidates(const uint8_t* data, size_t size, std::vector<size_t>& starts) const;
+
+    /**
+     * @brief Verifica se o pré-filtro está ativo para o conjunto atual de padrões
+     * @return true se ativo
+     */
+    bool is_enabled() const;
+
+    /**
+     * @brief Retorna o número de âncoras distintas
+     * @return Número de âncoras
+     */
+    size_t get_anchor_count() const;
+
+    /**
+     * @brief Força um nível SIMD (limitado ao suportado pela CPU)
+     * @param level Nível desejado
+     */
+    void set_simd_level(SimdLevel level);
+
+    /**
+     * @brief Retorna o nível SIMD em uso
+     * @return Nível SIMD
+     */
+    SimdLevel get_simd_level() const;
+};
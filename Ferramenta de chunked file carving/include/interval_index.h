@@ -0,0 +1,74 @@
+#pragma once
+
+#include <map>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Índice das regiões já extraídas
+ *
+ * Guarda duas árvores ordenadas pelo início: a união das regiões (intervalos
+ * [início, fim) disjuntos, unidos na inserção), usada para saltar o que já foi
+ * extraído em O(log n), e o intervalo de cada arquivo com o seu dono, usado
+ * para responder qual é o arquivo mais interno que contém um offset.
+ */
+class IntervalIndex {
+private:
+    struct Interval {
+        size_t end;
+        size_t owner;       // Identificação do arquivo (offset do seu cabeçalho)
+    };
+
+    std::map<size_t, size_t> coverage_;             // início -> fim (união)
+    std::multimap<size_t, Interval> files_;         // início -> intervalo de um arquivo
+
+public:
+    /**
+     * @brief Registra uma região extraída
+     * @param begin Início (inclusivo)
+     * @param end Fim (exclusivo)
+     * @param owner Identificação do arquivo dono da região
+     */
+    void insert(size_t begin, size_t end, size_t owner);
+
+    /**
+     * @brief Procura o arquivo mais interno que contém um offset estritamente depois do seu início
+     * @param offset Offset consultado
+     * @param owner Dono do arquivo (preenchido se encontrado)
+     * @return true se o offset está dentro de uma região já extraída
+     *
+     * Entre os arquivos que contêm o offset vence o de início mais próximo
+     * (e, no mesmo início, o de fim mais próximo). Um cabeçalho no mesmo
+     * offset de um arquivo extraído (ex: ZIP e DOCX) não é considerado
+     * contido nele. Só os arquivos da região que contém o offset são
+     * percorridos.
+     */
+    bool find_enclosing(size_t offset, size_t& owner) const;
+
+    /**
+     * @brief Primeiro offset a partir do qual a varredura deve continuar
+     * @param offset Offset atual
+     * @return Fim da região que contém offset, ou o próprio offset se não coberto
+     *
+     * O início de uma região não conta como coberto: outro formato pode ter
+     * cabeçalho no mesmo offset (ex: ZIP e DOCX).
+     */
+    size_t skip_covered(size_t offset) const;
+
+    /**
+     * @brief Início da próxima região a partir de um offset
+     * @param offset Offset atual
+     * @return Menor início > offset, ou SIZE_MAX se não houver
+     */
+    size_t next_region(size_t offset) const;
+
+    /**
+     * @brief Número de regiões (após as uniões)
+     */
+    size_t size() const;
+
+    /**
+     * @brief Remove todas as regiões
+     */
+    void clear();
+};
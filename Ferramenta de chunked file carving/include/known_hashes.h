@@ -0,0 +1,83 @@
+#pragma once
+
+#include "content_hash.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Cabeçalho do banco de hashes conhecidos
+ *
+ * Layout: cabeçalho, filtro de Bloom em blocos de 64 bytes (alinhado a 64)
+ * e a tabela de hashes SHA-256 (32 bytes cada, em ordem lexicográfica, sem
+ * repetições). O arquivo é mapeado como está: abrir não lê nem copia a tabela.
+ */
+struct KnownHashHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;        // Só é válido na mesma ordem de bytes
+    uint64_t hash_count;
+    uint64_t bloom_blocks;      // Blocos de 512 bits
+    uint32_t bloom_probes;      // Bits testados por consulta (todos no mesmo bloco)
+    uint32_t reserved;
+    uint64_t bloom_offset;
+    uint64_t table_offset;
+};
+
+/**
+ * @brief Conjunto de hashes de arquivos conhecidos (sistema operacional, aplicativos)
+ *
+ * As listas de referência (NSRL, sha256sum) identificam arquivos pelo
+ * SHA-256, e só um hash criptográfico descarta um arquivo sem risco de
+ * colisão. Cada consulta passa primeiro pelo filtro de Bloom, que toca uma
+ * única linha de cache e descarta quase todos os hashes ausentes; só os que
+ * passam chegam à tabela, onde a busca por interpolação nos 8 primeiros
+ * bytes (os hashes são uniformes) encontra a posição em poucos acessos.
+ */
+class KnownHashSet {
+public:
+    static const char MAGIC[8];
+    static const uint32_t FORMAT_VERSION = 2;     // 1 guardava XXH64
+    static const uint32_t BYTE_ORDER_TAG = 0x01020304;
+
+private:
+    std::shared_ptr<const void> storage_;
+    const uint64_t* bloom_;
+    const uint8_t* table_;              // count_ hashes de 32 bytes
+    uint64_t bloom_blocks_;
+    uint32_t bloom_probes_;
+    size_t count_;
+
+    bool bloom_contains(uint64_t key) const;
+
+public:
+    KnownHashSet();
+
+    /**
+     * @brief Mapeia e valida um banco de hashes
+     * @param path Caminho do arquivo (gerado por build ou carver-hashdb)
+     * @return true se o arquivo é consistente
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Verifica se um SHA-256 está no conjunto
+     */
+    bool contains(const Sha256Digest& hash) const;
+
+    /**
+     * @brief Número de hashes
+     */
+    size_t size() const;
+
+    /**
+     * @brief Grava um banco de hashes
+     * @param path Arquivo de saída
+     * @param hashes Hashes SHA-256 (ordenados e sem repetições ao retornar)
+     * @param bits_per_hash Tamanho do filtro de Bloom por hash (~1% de falsos positivos com 10)
+     * @return true se gravado com sucesso
+     */
+    static bool build(const std::string& path, std::vector<Sha256Digest>& hashes, size_t bits_per_hash = 10);
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class ChunkReader;
+
+/**
+ * @brief Formatos cujo tamanho pode ser obtido pela própria estrutura
+ */
+enum class StructureFormat : uint8_t {
+    NONE,
+    JPEG,       // Percorre os marcadores até o EOI
+    PNG,        // Percorre os chunks até o IEND
+    BMP,        // Campo de tamanho do BITMAPFILEHEADER
+    RIFF,       // Campo de tamanho do chunk RIFF (AVI, WAV, WEBP)
+    MP4,        // Cadeia de boxes de nível superior
+    SQLITE,     // page_size × page_count do cabeçalho
+    PE,         // Tabela de seções (e certificado) do executável
+    ZIP,        // Entradas locais, diretório central e EOCD
+    PDF         // startxref, tabela xref e offsets dos objetos
+};
+
+/**
+ * @brief Identifica o formato estrutural pelos bytes do cabeçalho da assinatura
+ * @param header Cabeçalho da assinatura
+ * @return Formato reconhecido ou NONE
+ */
+StructureFormat detect_structure_format(const std::vector<uint8_t>& header);
+
+/**
+ * @brief Nome do formato estrutural (para logs e relatórios)
+ */
+const char* structure_format_name(StructureFormat format);
+
+/**
+ * @brief Determina o fim de um arquivo lendo campos de tamanho ou percorrendo a estrutura
+ *
+ * Cada resolvedor lê apenas os cabeçalhos necessários (poucos KB), a partir
+ * do chunk atual quando possível e do leitor, em blocos, fora dele. Só o
+ * JPEG precisa examinar os dados comprimidos, limitado pela janela de busca.
+ * Uma estrutura inconsistente faz o resolvedor desistir, e o candidato volta
+ * a ser delimitado pelo footer ou pela janela.
+ *
+ * Com set_gap() o resolvedor enxerga um arquivo em dois fragmentos (os bytes
+ * a partir do ponto de corte são lidos adiante do intervalo), o que permite
+ * usar os mesmos percursos para validar hipóteses de fragmentação.
+ */
+class LengthResolver {
+private:
+    static constexpr size_t BLOCK_SIZE = 4096;         // Leituras de cabeçalhos fora do chunk
+    static constexpr size_t SCAN_BLOCK_SIZE = 65536;   // Leituras de dados comprimidos (JPEG)
+    static constexpr size_t MAX_STEPS = 1 << 20;       // Limite de marcadores/chunks/boxes/entradas
+    static constexpr size_t MAX_XREF_ENTRIES = 1 << 16; // Entradas xref conferidas por trailer
+
+    ChunkReader& reader_;
+    size_t physical_size_;
+    size_t file_size_;              // Tamanho visto pelos percursos (descontado o intervalo)
+    size_t scan_limit_;
+
+    // Fragmentação simulada: posições >= split_ são lidas em posição + gap_
+    size_t split_;
+    size_t gap_;
+
+    // Onde o último percurso encontrou a estrutura inconsistente
+    size_t failure_;
+    size_t verified_;
+
+    // Chunk atual da varredura (servido sem I/O)
+    const uint8_t* chunk_data_;
+    size_t chunk_size_;
+    size_t chunk_offset_;
+
+    // Último bloco lido fora do chunk
+    std::vector<uint8_t> block_;
+    size_t block_offset_;
+
+    const uint8_t* view(size_t position, size_t wanted, size_t& available);
+    bool skip_entropy_data(size_t& position, size_t limit, uint8_t& restart);
+    bool is_valid_jpeg_segment(uint8_t code, size_t position, size_t length);
+    bool read(size_t position, void* out, size_t size);
+    size_t find_text(size_t position, size_t limit, const char* text, size_t length);
+    bool fail(size_t position, size_t verified);
+    bool crc_matches(size_t position, size_t size, uint32_t expected);
+    bool is_object_at(size_t position, size_t number);
+    bool read_startxref(size_t start, size_t eof, size_t& xref);
+    bool validate_xref(size_t start, size_t xref);
+
+    bool resolve_jpeg(size_t start, size_t& end);
+    bool resolve_png(size_t start, size_t& end);
+    bool resolve_bmp(size_t start, size_t& end);
+    bool resolve_riff(size_t start, size_t& end);
+    bool resolve_mp4(size_t start, size_t& end);
+    bool resolve_sqlite(size_t start, size_t& end);
+    bool resolve_pe(size_t start, size_t& end);
+    bool resolve_zip(size_t start, size_t& end);
+    bool resolve_pdf(size_t start, size_t& end);
+
+public:
+    /**
+     * @brief Construtor
+     * @param reader Leitor do arquivo varrido (usado para ler fora do chunk atual)
+     * @param scan_limit Máximo de bytes examinados a partir do cabeçalho ao
+     *        percorrer dados comprimidos (JPEG)
+     */
+    LengthResolver(ChunkReader& reader, size_t scan_limit);
+
+    /**
+     * @brief Informa o chunk atual da varredura
+     * @param data Dados do chunk (válidos até a próxima chamada)
+     * @param size Tamanho do chunk
+     * @param file_offset Offset absoluto de data[0]
+     */
+    void set_chunk(const uint8_t* data, size_t size, size_t file_offset);
+
+    /**
+     * @brief Determina o fim do arquivo que começa em start
+     * @param format Formato estrutural da assinatura
+     * @param start Offset absoluto do cabeçalho
+     * @param end Offset absoluto do fim do arquivo (exclusivo)
+     * @return true se a estrutura é consistente e termina dentro do arquivo varrido
+     */
+    bool resolve(StructureFormat format, size_t start, size_t& end);
+
+    /**
+     * @brief Simula um arquivo em dois fragmentos
+     * @param split Offset absoluto em que o primeiro fragmento termina
+     * @param gap Bytes entre o fim do primeiro fragmento e o início do segundo
+     *
+     * Posições >= split passam a ser lidas em posição + gap. split = SIZE_MAX
+     * (ou gap = 0) volta à leitura contígua.
+     */
+    void set_gap(size_t split, size_t gap);
+
+    /**
+     * @brief Offset em que a última resolução mal-sucedida encontrou a estrutura inconsistente
+     * @return Offset absoluto, ou 0 se a falha foi logo no cabeçalho (provável falso positivo)
+     */
+    size_t get_failure_offset() const;
+
+    /**
+     * @brief Último offset até o qual a estrutura foi confirmada antes da falha
+     * @return Offset absoluto (o corte do fragmento fica entre ele e a falha)
+     */
+    size_t get_verified_offset() const;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "cpu_features.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Busca de um padrão fixo (footer) com tabelas pré-calculadas
+ *
+ * Padrões curtos usam um filtro vetorial que compara o primeiro e o último
+ * byte do padrão em blocos de 16, 32 ou 64 posições (conforme a CPU) e só
+ * confirma o miolo nas posições que passam pelo filtro. Padrões longos, ou
+ * CPUs sem SIMD, usam Boyer-Moore-Horspool.
+ */
+class PatternSearcher {
+public:
+    static const size_t MAX_SIMD_PATTERN = 32;
+
+private:
+    std::vector<uint8_t> pattern_;
+    size_t shift_[256];             // Deslocamentos de Horspool por byte
+    SimdLevel simd_level_;
+
+    size_t find_horspool(const uint8_t* data, size_t size) const;
+
+public:
+    /**
+     * @brief Construtor - cria um buscador vazio
+     */
+    PatternSearcher();
+
+    /**
+     * @brief Construtor que já pré-calcula as tabelas do padrão
+     * @param pattern Padrão a ser buscado
+     */
+    explicit PatternSearcher(const std::vector<uint8_t>& pattern);
+
+    /**
+     * @brief Define o padrão e pré-calcula as tabelas
+     * @param pattern Padrão a ser buscado
+     */
+    void build(const std::vector<uint8_t>& pattern);
+
+    /**
+     * @brief Procura a primeira ocorrência do padrão
+     * @param data Buffer com os dados
+     * @param size Tamanho do buffer
+     * @return Posição da primeira ocorrência ou SIZE_MAX se não encontrado
+     */
+    size_t find(const uint8_t* data, size_t size) const;
+
+    /**
+     * @brief Retorna o padrão buscado
+     * @return Bytes do padrão
+     */
+    const std::vector<uint8_t>& get_pattern() const;
+
+    /**
+     * @brief Força um nível SIMD (limitado ao suportado pela CPU)
+     * @param level Nível desejado
+     */
+    void set_simd_level(SimdLevel level);
+
+    /**
+     * @brief Retorna o nível SIMD em uso
+     * @return Nível SIMD
+     */
+    SimdLevel get_simd_level() const;
+};
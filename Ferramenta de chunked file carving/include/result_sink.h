@@ -0,0 +1,125 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <memory>
+#include <fstream>
+#include <cstdint>
+#include <cstddef>
+
+struct CarvedFile;
+
+/**
+ * @brief Totais de um tipo de arquivo
+ */
+struct TypeTotals {
+    size_t count = 0;
+    size_t bytes = 0;
+};
+
+/**
+ * @brief Blocos por classe (só com a classificação de blocos ativa)
+ */
+struct BlockTotals {
+    size_t data = 0;
+    size_t zero = 0;
+    size_t uniform = 0;
+    size_t high_entropy = 0;
+};
+
+/**
+ * @brief Agregados da execução, mantidos enquanto os arquivos são aceitos
+ */
+struct CarvingSummary {
+    size_t files_found = 0;
+    size_t files_extracted = 0;
+    size_t bytes_processed = 0;
+    std::map<std::string, TypeTotals> types;   // Limitado ao número de assinaturas
+    bool blocks_classified = false;
+    BlockTotals blocks;
+};
+
+/**
+ * @brief Formatos de relatório disponíveis
+ */
+enum class ReportFormat {
+    TEXT,       // Relatório detalhado legível
+    CSV,        // Uma linha por arquivo
+    NDJSON,     // Um objeto JSON por linha
+    STORE       // Registros binários com índice por offset (result_store.h)
+};
+
+/**
+ * @brief Destino de resultados gravado à medida que os arquivos são aceitos
+ *
+ * Cada arquivo aceito vira uma linha (ou bloco) acrescentada a um buffer,
+ * gravado no disco em lotes; nada é guardado por arquivo, de modo que a
+ * memória não cresce com o número de resultados. O resumo final vem dos
+ * agregados da execução e fica no fim do relatório.
+ */
+class ResultSink {
+private:
+    static constexpr size_t BUFFER_SIZE = 256 * 1024;   // Gravação em lotes
+
+    std::ofstream file_;
+    std::string path_;
+    std::string buffer_;
+    bool failed_;
+
+protected:
+    /**
+     * @brief Acrescenta texto ao buffer (gravado quando o lote enche)
+     */
+    void append(const std::string& text);
+
+    virtual void write_header() = 0;
+    virtual void write_file(const CarvedFile& file) = 0;
+    virtual void write_summary(const CarvingSummary& summary) = 0;
+
+    /**
+     * @brief Etapa final depois que o arquivo foi fechado (ex: gravar o índice)
+     * @return false em caso de erro
+     */
+    virtual bool complete();
+
+public:
+    /**
+     * @brief Construtor
+     * @param path Arquivo de saída (sobrescrito)
+     */
+    explicit ResultSink(const std::string& path);
+
+    virtual ~ResultSink();
+
+    /**
+     * @brief Cria o destino de um formato e grava o seu cabeçalho
+     * @param format Formato do relatório
+     * @param path Arquivo de saída
+     * @return Destino pronto, ou nullptr se o arquivo não pôde ser criado
+     */
+    static std::unique_ptr<ResultSink> create(ReportFormat format, const std::string& path);
+
+    /**
+     * @brief Acrescenta um arquivo aceito
+     * @param file Arquivo já nomeado (e extraído, se for o caso)
+     */
+    void add(const CarvedFile& file);
+
+    /**
+     * @brief Grava os lotes pendentes no disco
+     * @return false se alguma gravação falhou
+     */
+    bool flush();
+
+    /**
+     * @brief Grava o resumo e fecha o arquivo
+     * @param summary Agregados da execução
+     * @return true se o relatório inteiro foi gravado
+     */
+    bool finish(const CarvingSummary& summary);
+
+    /**
+     * @brief Caminho do arquivo de saída
+     */
+    const std::string& get_path() const;
+};
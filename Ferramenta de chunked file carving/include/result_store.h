@@ -0,0 +1,120 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Cabeçalho do arquivo de resultados binário
+ *
+ * Layout: cabeçalho, registros de tamanho fixo na ordem em que os arquivos
+ * foram aceitos, tabela de nomes de tipo (u32 tamanho + bytes por tipo) e,
+ * alinhado a 8 bytes, o índice (u32 por registro) ordenado pelo offset.
+ * O cabeçalho só recebe a assinatura quando o arquivo está completo.
+ */
+struct StoreHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;        // Só é válido na mesma ordem de bytes
+    uint64_t record_count;
+    uint32_t record_size;
+    uint32_t type_count;
+    uint64_t strings_offset;
+    uint64_t strings_size;
+    uint64_t index_offset;
+    uint64_t files_found;
+    uint64_t files_extracted;
+    uint64_t bytes_processed;
+};
+
+/**
+ * @brief Registro de um arquivo aceito
+ */
+struct StoreRecord {
+    uint64_t start_offset;
+    uint64_t end_offset;
+    uint64_t file_size;
+    uint64_t hash;              // XXH3 do conteúdo, válido com STORE_HASH
+    uint32_t type_id;           // Posição na tabela de tipos
+    uint32_t flags;
+};
+
+enum StoreFlags : uint32_t {
+    STORE_FOOTER_VALID = 1u << 0,
+    STORE_STRUCTURE = 1u << 1,
+    STORE_EXTRACTED = 1u << 2,
+    STORE_FRAGMENTED = 1u << 3,
+    STORE_NESTED = 1u << 4,
+    STORE_HASH = 1u << 5,
+    STORE_DUPLICATE = 1u << 6   // Mesmo conteúdo de um arquivo anterior
+};
+
+/**
+ * @brief Leitura de um arquivo de resultados mapeado em memória
+ *
+ * Nada é copiado além dos nomes de tipo: consultas por faixa de offset
+ * usam busca binária no índice e os demais filtros percorrem só os
+ * registros da faixa.
+ */
+class ResultStore {
+public:
+    static const char MAGIC[8];
+    static const uint32_t FORMAT_VERSION = 1;
+    static const uint32_t BYTE_ORDER_TAG = 0x01020304;
+
+private:
+    std::shared_ptr<const void> storage_;
+    StoreHeader header_;
+    const StoreRecord* records_;
+    const uint32_t* index_;
+    std::vector<std::string> type_names_;
+
+public:
+    ResultStore();
+
+    /**
+     * @brief Mapeia e valida um arquivo de resultados
+     * @param path Caminho do arquivo
+     * @return true se o arquivo está completo e consistente
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Número de registros
+     */
+    size_t size() const;
+
+    /**
+     * @brief Registro na ordem de offset
+     * @param position Posição no índice (0 .. size()-1)
+     */
+    const StoreRecord& get(size_t position) const;
+
+    /**
+     * @brief Primeira posição do índice com offset inicial >= offset
+     * @param offset Offset procurado
+     * @return Posição, ou size() se não houver
+     */
+    size_t lower_bound(uint64_t offset) const;
+
+    /**
+     * @brief Nome de um tipo
+     * @param type_id Identificação gravada no registro
+     */
+    const std::string& get_type_name(uint32_t type_id) const;
+
+    /**
+     * @brief Procura a identificação de um tipo pelo nome
+     * @param name Nome do tipo (ex: "JPEG")
+     * @param type_id Identificação (preenchida se encontrado)
+     * @return true se o tipo aparece no arquivo
+     */
+    bool find_type(const std::string& name, uint32_t& type_id) const;
+
+    /**
+     * @brief Cabeçalho com os totais da execução
+     */
+    const StoreHeader& get_header() const;
+};
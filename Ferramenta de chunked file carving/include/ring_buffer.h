@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Buffer circular espelhado na memória virtual
+ *
+ * As mesmas páginas são mapeadas duas vezes em sequência, de modo que
+ * qualquer região de até capacity() bytes a partir de at(posição) é
+ * contígua mesmo quando dá a volta no fim do buffer. Os chunks são lidos
+ * na posição correspondente ao seu offset no arquivo e o overlap é
+ * simplesmente o fim do chunk anterior, sem cópia.
+ *
+ * Disponível no Linux (memfd); em outros sistemas allocate() falha e o
+ * leitor usa o buffer com cópia do overlap.
+ */
+class RingBuffer {
+private:
+    uint8_t* base_;
+    size_t capacity_;
+    bool huge_pages_;
+
+public:
+    RingBuffer();
+    ~RingBuffer();
+
+    // Não permite cópia
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    /**
+     * @brief Reserva o buffer (substitui o anterior)
+     * @param min_capacity Capacidade mínima (arredondada para a página)
+     * @param huge_pages Tenta páginas enormes (2MB), com recuo para páginas normais
+     * @return true se o buffer espelhado está pronto
+     */
+    bool allocate(size_t min_capacity, bool huge_pages);
+
+    /**
+     * @brief Libera o mapeamento
+     */
+    void release();
+
+    /**
+     * @brief Verifica se há um buffer espelhado pronto
+     */
+    bool is_ready() const;
+
+    /**
+     * @brief Capacidade em bytes (0 se não alocado)
+     */
+    size_t capacity() const;
+
+    /**
+     * @brief Verifica se o buffer usa páginas enormes
+     */
+    bool uses_huge_pages() const;
+
+    /**
+     * @brief Endereço de uma posição absoluta (válido por capacity() bytes)
+     * @param position Posição absoluta (ex: offset no arquivo)
+     */
+    uint8_t* at(size_t position) const {
+        return base_ + position % capacity_;
+    }
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "file_signature.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Cache binário do conjunto de assinaturas compilado
+ *
+ * Guarda as assinaturas e o bloco do autômato de cabeçalhos em um arquivo
+ * versionado. O arquivo é identificado por uma chave calculada a partir
+ * das assinaturas já carregadas e do conteúdo do arquivo de configuração;
+ * em execuções seguintes o bloco é mapeado em memória e usado diretamente,
+ * sem recompilar o autômato.
+ */
+class SignatureCache {
+public:
+    static const uint32_t FORMAT_VERSION = 1;
+
+    /**
+     * @brief Calcula a chave do cache
+     * @param base Assinaturas presentes antes da carga da configuração
+     * @param config_text Conteúdo do arquivo de configuração
+     * @return Chave (FNV-1a de 64 bits)
+     */
+    static uint64_t compute_key(const std::vector<FileSignature>& base, const std::string& config_text);
+
+    /**
+     * @brief Caminho padrão do cache de um arquivo de configuração
+     * @param config_file Arquivo de configuração
+     * @return Caminho do cache (mesmo diretório, extensão .cache)
+     */
+    static std::string default_path(const std::string& config_file);
+
+    /**
+     * @brief Carrega o cache, se existir e corresponder à chave
+     * @param path Caminho do cache
+     * @param key Chave esperada
+     * @param signatures Assinaturas gravadas (substitui o conteúdo)
+     * @param builtin_count Assinaturas iniciais ainda idênticas às embutidas
+     * @param matcher Autômato associado ao bloco mapeado
+     * @return true se o cache foi usado
+     */
+    static bool load(const std::string& path, uint64_t key, std::vector<FileSignature>& signatures,
+                     size_t& builtin_count, HeaderMatcher& matcher);
+
+    /**
+     * @brief Grava o cache (arquivo temporário + rename, nunca fica parcial)
+     * @param path Caminho do cache
+     * @param key Chave do conjunto
+     * @param signatures Assinaturas do conjunto
+     * @param builtin_count Assinaturas iniciais ainda idênticas às embutidas
+     * @param matcher Autômato compilado do conjunto
+     * @return true se gravado com sucesso
+     */
+    static bool save(const std::string& path, uint64_t key, const std::vector<FileSignature>& signatures,
+                     size_t builtin_count, const HeaderMatcher& matcher);
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+
+/**
+ * @brief Pool de threads com roubo de tarefas (work stealing)
+ *
+ * Cada worker possui sua própria fila. O worker consome tarefas do fim da
+ * sua fila e, quando ela esvazia, rouba tarefas do início das filas dos
+ * outros workers, mantendo todos ocupados mesmo com tarefas de custo desigual.
+ */
+class ThreadPool {
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex state_mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable all_done_;
+    std::atomic<size_t> pending_tasks_;
+    std::atomic<size_t> queued_tasks_;
+    std::atomic<size_t> next_queue_;
+    bool stopping_;
+    std::exception_ptr first_error_;
+
+    void worker_loop(size_t index);
+    bool try_pop(size_t index, std::function<void()>& task);
+
+public:
+    /**
+     * @brief Construtor
+     * @param num_threads Número de workers (0 = número de núcleos da CPU)
+     */
+    explicit ThreadPool(size_t num_threads);
+
+    /**
+     * @brief Destrutor - aguarda as tarefas pendentes e encerra os workers
+     */
+    ~ThreadPool();
+
+    // Não permite cópia
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Enfileira uma tarefa
+     * @param task Tarefa a ser executada
+     *
+     * Tarefas enviadas de dentro de um worker vão para a fila desse worker;
+     * as demais são distribuídas em rodízio.
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Aguarda todas as tarefas terminarem
+     *
+     * Relança a primeira exceção lançada por uma tarefa, se houver.
+     */
+    void wait();
+
+    /**
+     * @brief Aguarda as tarefas terminarem por um tempo limitado
+     * @param timeout Tempo máximo de espera
+     * @return true se todas as tarefas terminaram
+     */
+    bool wait_for(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Retorna o número de workers
+     * @return Número de workers
+     */
+    size_t size() const;
+
+    /**
+     * @brief Retorna o índice do worker que executa a thread atual
+     * @return Índice do worker ou SIZE_MAX fora do pool
+     */
+    static size_t current_worker();
+
+    /**
+     * @brief Resolve o número de threads efetivo
+     * @param requested Número pedido (0 = número de núcleos da CPU)
+     * @return Número de threads (no mínimo 1)
+     */
+    static size_t resolve_thread_count(size_t requested);
+};
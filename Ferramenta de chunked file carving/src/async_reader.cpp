@@ -0,0 +1,537 @@
+#include "async_reader.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CARVER_HAVE_PREAD 1
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#define CARVER_HAVE_PREAD 0
+#endif
+
+// O CMake define CARVER_HAVE_IO_URING; no build via Makefile detecta pelo cabeçalho
+#ifndef CARVER_HAVE_IO_URING
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define CARVER_HAVE_IO_URING 1
+#endif
+#endif
+#endif
+#ifndef CARVER_HAVE_IO_URING
+#define CARVER_HAVE_IO_URING 0
+#endif
+
+#if CARVER_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+/**
+ * @brief Mecanismo de leitura assíncrona
+ *
+ * Cada leitura é identificada por uma etiqueta (o índice do slot). Leituras
+ * curtas são completadas internamente; o resultado final é o total de bytes
+ * lidos ou -errno.
+ */
+class ReadEngine {
+public:
+    virtual ~ReadEngine() = default;
+    virtual bool submit(size_t tag, uint8_t* buffer, size_t length, size_t offset) = 0;
+    virtual long wait(size_t tag) = 0;
+    virtual const char* name() const = 0;
+};
+
+namespace {
+
+#if CARVER_HAVE_PREAD
+    /**
+     * @brief Lê exatamente length bytes (ou até o fim do arquivo)
+     */
+    long pread_full(int fd, uint8_t* buffer, size_t length, size_t offset) {
+        size_t done = 0;
+        while (done < length) {
+            ssize_t result = pread(fd, buffer + done, length - done, static_cast<off_t>(offset + done));
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return -errno;
+            }
+            if (result == 0) {
+                break;
+            }
+            done += static_cast<size_t>(result);
+        }
+        return static_cast<long>(done);
+    }
+
+    /**
+     * @brief Fallback portável: threads dedicadas executando pread
+     */
+    class ThreadReadEngine : public ReadEngine {
+    private:
+        struct Request {
+            size_t tag;
+            uint8_t* buffer;
+            size_t length;
+            size_t offset;
+        };
+
+        int fd_;
+        std::vector<std::thread> threads_;
+        std::deque<Request> queue_;
+        std::vector<long> results_;
+        std::vector<bool> done_;
+        std::mutex mutex_;
+        std::condition_variable request_ready_;
+        std::condition_variable request_done_;
+        bool stopping_;
+
+        void worker_loop() {
+            while (true) {
+                Request request;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    request_ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+                    if (queue_.empty()) {
+                        return;
+                    }
+                    request = queue_.front();
+                    queue_.pop_front();
+                }
+
+                long result = pread_full(fd_, request.buffer, request.length, request.offset);
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    results_[request.tag] = result;
+                    done_[request.tag] = true;
+                }
+                request_done_.notify_all();
+            }
+        }
+
+    public:
+        ThreadReadEngine(int fd, size_t slots, size_t num_threads)
+            : fd_(fd)
+            , results_(slots, 0)
+            , done_(slots, false)
+            , stopping_(false) {
+            for (size_t i = 0; i < num_threads; ++i) {
+                threads_.emplace_back(&ThreadReadEngine::worker_loop, this);
+            }
+        }
+
+        ~ThreadReadEngine() override {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            request_ready_.notify_all();
+            for (auto& thread : threads_) {
+                thread.join();
+            }
+        }
+
+        bool submit(size_t tag, uint8_t* buffer, size_t length, size_t offset) override {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                done_[tag] = false;
+                queue_.push_back({tag, buffer, length, offset});
+            }
+            request_ready_.notify_one();
+            return true;
+        }
+
+        long wait(size_t tag) override {
+            std::unique_lock<std::mutex> lock(mutex_);
+            request_done_.wait(lock, [this, tag] { return static_cast<bool>(done_[tag]); });
+            return results_[tag];
+        }
+
+        const char* name() const override {
+            return "threads";
+        }
+    };
+#endif
+
+#if CARVER_HAVE_IO_URING
+    int sys_io_uring_setup(unsigned entries, io_uring_params* params) {
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    int sys_io_uring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+        return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+    }
+
+    /**
+     * @brief Leituras via io_uring, usando as syscalls diretamente (sem liburing)
+     */
+    class UringReadEngine : public ReadEngine {
+    private:
+        struct Request {
+            uint8_t* buffer;
+            size_t length;
+            size_t offset;
+            size_t done;
+            long result;
+            bool complete;
+            iovec iov;
+        };
+
+        int fd_;
+        int ring_fd_;
+        void* sq_ring_;
+        void* cq_ring_;
+        size_t sq_ring_size_;
+        size_t cq_ring_size_;
+        io_uring_sqe* sqes_;
+        size_t sqes_size_;
+
+        unsigned* sq_tail_;
+        unsigned* sq_mask_;
+        unsigned* sq_array_;
+        unsigned* cq_head_;
+        unsigned* cq_tail_;
+        unsigned* cq_mask_;
+        io_uring_cqe* cqes_;
+
+        std::vector<Request> requests_;
+
+        bool push_sqe(size_t tag) {
+            Request& request = requests_[tag];
+            request.iov.iov_base = request.buffer + request.done;
+            request.iov.iov_len = request.length - request.done;
+
+            unsigned tail = *sq_tail_;
+            unsigned index = tail & *sq_mask_;
+            io_uring_sqe* sqe = &sqes_[index];
+            std::memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = IORING_OP_READV;
+            sqe->fd = fd_;
+            sqe->addr = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(&request.iov));
+            sqe->len = 1;
+            sqe->off = request.offset + request.done;
+            sqe->user_data = tag;
+            sq_array_[index] = index;
+            __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+            int submitted;
+            do {
+                submitted = sys_io_uring_enter(ring_fd_, 1, 0, 0);
+            } while (submitted < 0 && errno == EINTR);
+            return submitted == 1;
+        }
+
+        void reap_one() {
+            unsigned head = *cq_head_;
+            while (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+                if (sys_io_uring_enter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+                    // Anel inutilizável: encerra todas as leituras pendentes com erro
+                    long error = -errno;
+                    for (auto& request : requests_) {
+                        if (!request.complete) {
+                            request.result = error;
+                            request.complete = true;
+                        }
+                    }
+                    return;
+                }
+            }
+
+            const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+            size_t tag = static_cast<size_t>(cqe.user_data);
+            int result = cqe.res;
+            __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+
+            Request& request = requests_[tag];
+            if (result < 0) {
+                request.result = result;
+                request.complete = true;
+                return;
+            }
+
+            request.done += static_cast<size_t>(result);
+            if (result == 0 || request.done >= request.length) {
+                request.result = static_cast<long>(request.done);
+                request.complete = true;
+            } else if (!push_sqe(tag)) {
+                // Leitura curta: o restante é pedido de novo; se falhar, completa com pread
+                long rest = pread_full(fd_, request.buffer + request.done, request.length - request.done,
+                                       request.offset + request.done);
+                request.result = rest < 0 ? rest : static_cast<long>(request.done) + rest;
+                request.complete = true;
+            }
+        }
+
+    public:
+        UringReadEngine(int fd, size_t slots)
+            : fd_(fd)
+            , ring_fd_(-1)
+            , sq_ring_(MAP_FAILED)
+            , cq_ring_(MAP_FAILED)
+            , sq_ring_size_(0)
+            , cq_ring_size_(0)
+            , sqes_(static_cast<io_uring_sqe*>(MAP_FAILED))
+            , sqes_size_(0)
+            , requests_(slots) {
+        }
+
+        ~UringReadEngine() override {
+            for (size_t tag = 0; tag < requests_.size(); ++tag) {
+                if (ring_fd_ >= 0 && !requests_[tag].complete) {
+                    wait(tag);
+                }
+            }
+            if (sqes_ != MAP_FAILED) {
+                munmap(sqes_, sqes_size_);
+            }
+            if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+                munmap(cq_ring_, cq_ring_size_);
+            }
+            if (sq_ring_ != MAP_FAILED) {
+                munmap(sq_ring_, sq_ring_size_);
+            }
+            if (ring_fd_ >= 0) {
+                ::close(ring_fd_);
+            }
+        }
+
+        /**
+         * @brief Cria o anel; falha em kernels antigos ou quando o io_uring está bloqueado
+         */
+        bool init() {
+            for (auto& request : requests_) {
+                request.complete = true;
+            }
+
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+            ring_fd_ = sys_io_uring_setup(static_cast<unsigned>(requests_.size()), &params);
+            if (ring_fd_ < 0) {
+                return false;
+            }
+
+            sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single_mmap) {
+                sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+            }
+
+            sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            ring_fd_, IORING_OFF_SQ_RING);
+            if (sq_ring_ == MAP_FAILED) {
+                return false;
+            }
+            cq_ring_ = single_mmap ? sq_ring_
+                                   : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                          ring_fd_, IORING_OFF_CQ_RING);
+            if (cq_ring_ == MAP_FAILED) {
+                return false;
+            }
+
+            sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+            sqes_ = static_cast<io_uring_sqe*>(mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                                                    MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES));
+            if (sqes_ == MAP_FAILED) {
+                return false;
+            }
+
+            uint8_t* sq = static_cast<uint8_t*>(sq_ring_);
+            uint8_t* cq = static_cast<uint8_t*>(cq_ring_);
+            sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            return true;
+        }
+
+        bool submit(size_t tag, uint8_t* buffer, size_t length, size_t offset) override {
+            Request& request = requests_[tag];
+            request.buffer = buffer;
+            request.length = length;
+            request.offset = offset;
+            request.done = 0;
+            request.result = 0;
+            request.complete = false;
+            if (!push_sqe(tag)) {
+                request.complete = true;
+                request.result = -EIO;
+                return false;
+            }
+            return true;
+        }
+
+        long wait(size_t tag) override {
+            while (!requests_[tag].complete) {
+                reap_one();
+            }
+            return requests_[tag].result;
+        }
+
+        const char* name() const override {
+            return "io_uring";
+        }
+    };
+#endif
+
+} // namespace
+
+AsyncChunkPipeline::AsyncChunkPipeline(size_t chunk_size, size_t overlap_size, size_t io_depth)
+    : fd_(-1)
+    , file_size_(0)
+    , chunk_size_(chunk_size)
+    , overlap_size_(overlap_size)
+    , start_position_(0)
+    , next_submit_(0)
+    , next_consume_(0)
+    , held_slot_(SIZE_MAX) {
+
+    // Um slot a mais que a profundidade: o chunk entregue continua válido
+    // enquanto io_depth leituras estão em andamento
+    size_t depth = std::max<size_t>(io_depth, 1);
+    slots_.resize(depth + 1);
+    for (auto& slot : slots_) {
+        slot.buffer.resize(chunk_size_ + overlap_size_);
+        slot.offset = 0;
+        slot.length = 0;
+        slot.pending = false;
+    }
+}
+
+AsyncChunkPipeline::~AsyncChunkPipeline() {
+    drain();
+    engine_.reset();
+#if CARVER_HAVE_PREAD
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+}
+
+bool AsyncChunkPipeline::open(const std::string& filename, size_t file_size) {
+#if CARVER_HAVE_PREAD
+    fd_ = ::open(filename.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        return false;
+    }
+    file_size_ = file_size;
+
+#if CARVER_HAVE_IO_URING
+    {
+        auto uring = std::make_unique<UringReadEngine>(fd_, slots_.size());
+        if (uring->init()) {
+            engine_ = std::move(uring);
+        }
+    }
+#endif
+    if (!engine_) {
+        size_t io_threads = std::min<size_t>(slots_.size() - 1, 4);
+        engine_ = std::make_unique<ThreadReadEngine>(fd_, slots_.size(), io_threads);
+    }
+
+    restart(0);
+    return true;
+#else
+    (void)filename;
+    (void)file_size;
+    return false;
+#endif
+}
+
+bool AsyncChunkPipeline::submit_next() {
+    size_t position = start_position_ + next_submit_ * chunk_size_;
+    if (position >= file_size_) {
+        return false;
+    }
+
+    // Mesma regra do ChunkReader síncrono: todo chunk após o primeiro repete
+    // os últimos overlap_size bytes do anterior, que estão no cache de páginas
+    size_t prefix = (next_submit_ > 0 && chunk_size_ >= overlap_size_) ? overlap_size_ : 0;
+
+    // Chunks são consumidos em ordem, então o chunk n sempre ocupa o slot n % slots
+    size_t slot_index = next_submit_ % slots_.size();
+    Slot& slot = slots_[slot_index];
+    slot.offset = position - prefix;
+    slot.length = prefix + std::min(chunk_size_, file_size_ - position);
+    slot.pending = engine_->submit(slot_index, slot.buffer.data(), slot.length, slot.offset);
+    next_submit_++;
+    return slot.pending;
+}
+
+void AsyncChunkPipeline::drain() {
+    if (!engine_) {
+        return;
+    }
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        if (slots_[i].pending) {
+            engine_->wait(i);
+            slots_[i].pending = false;
+        }
+    }
+}
+
+void AsyncChunkPipeline::restart(size_t position) {
+    drain();
+    start_position_ = position;
+    next_submit_ = 0;
+    next_consume_ = 0;
+    held_slot_ = SIZE_MAX;
+
+    for (size_t i = 0; i + 1 < slots_.size(); ++i) {
+        if (!submit_next()) {
+            break;
+        }
+    }
+}
+
+bool AsyncChunkPipeline::next(ChunkView& view) {
+    if (!engine_) {
+        return false;
+    }
+
+    // O chunk entregue anteriormente foi liberado: abre espaço para mais uma leitura
+    if (held_slot_ != SIZE_MAX) {
+        submit_next();
+        held_slot_ = SIZE_MAX;
+    }
+
+    size_t slot_index = next_consume_ % slots_.size();
+    Slot& slot = slots_[slot_index];
+    if (!slot.pending) {
+        return false;
+    }
+
+    long result = engine_->wait(slot_index);
+    slot.pending = false;
+    if (result < 0) {
+        std::cerr << "Erro de leitura assíncrona em " << slot.offset << ": "
+                  << std::strerror(static_cast<int>(-result)) << std::endl;
+        return false;
+    }
+    if (result == 0) {
+        return false;
+    }
+
+    view = {slot.buffer.data(), static_cast<size_t>(result), slot.offset};
+    held_slot_ = slot_index;
+    next_consume_++;
+    return true;
+}
+
+const char* AsyncChunkPipeline::engine_name() const {
+    return engine_ ? engine_->name() : "nenhum";
+}
@@ -0,0 +1,208 @@
+#include "block_classifier.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if CARVER_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const size_t MIN_ENTROPY_BLOCK = 512;
+
+/**
+ * @brief Compara data[begin, size) com o primeiro byte, sem vetores
+ */
+bool uniform_scalar(const uint8_t* data, size_t begin, size_t size) {
+    for (size_t i = begin; i < size; ++i) {
+        if (data[i] != data[0]) return false;
+    }
+    return true;
+}
+
+#if CARVER_X86_SIMD
+
+// Cada kernel acumula 4 vetores por iteração e informa em checked até onde
+// comparou (o restante, menor que 4 vetores, fica para o caminho escalar)
+
+CARVER_TARGET("sse2")
+bool uniform_sse2(const uint8_t* data, size_t size, size_t& checked) {
+    const __m128i first = _mm_set1_epi8(static_cast<char>(data[0]));
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        __m128i diff = _mm_or_si128(
+            _mm_or_si128(_mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), first),
+                         _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 16)), first)),
+            _mm_or_si128(_mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 32)), first),
+                         _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 48)), first)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(diff, zero)) != 0xFFFF) return false;
+    }
+    checked = i;
+    return true;
+}
+
+CARVER_TARGET("avx2")
+bool uniform_avx2(const uint8_t* data, size_t size, size_t& checked) {
+    const __m256i first = _mm256_set1_epi8(static_cast<char>(data[0]));
+    size_t i = 0;
+    for (; i + 128 <= size; i += 128) {
+        __m256i diff = _mm256_or_si256(
+            _mm256_or_si256(_mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), first),
+                            _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32)), first)),
+            _mm256_or_si256(_mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 64)), first),
+                            _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 96)), first)));
+        if (!_mm256_testz_si256(diff, diff)) return false;
+    }
+    checked = i;
+    return true;
+}
+
+CARVER_TARGET("avx512f,avx512bw")
+bool uniform_avx512(const uint8_t* data, size_t size, size_t& checked) {
+    const __m512i first = _mm512_set1_epi8(static_cast<char>(data[0]));
+    size_t i = 0;
+    for (; i + 256 <= size; i += 256) {
+        __m512i diff = _mm512_or_si512(
+            _mm512_or_si512(_mm512_xor_si512(_mm512_loadu_si512(data + i), first),
+                            _mm512_xor_si512(_mm512_loadu_si512(data + i + 64), first)),
+            _mm512_or_si512(_mm512_xor_si512(_mm512_loadu_si512(data + i + 128), first),
+                            _mm512_xor_si512(_mm512_loadu_si512(data + i + 192), first)));
+        if (_mm512_test_epi8_mask(diff, diff) != 0) return false;
+    }
+    checked = i;
+    return true;
+}
+
+#endif
+
+} // namespace
+
+const char* block_class_name(BlockClass type) {
+    switch (type) {
+        case BlockClass::ZERO: return "ZERO";
+        case BlockClass::UNIFORM: return "UNIFORME";
+        case BlockClass::HIGH_ENTROPY: return "ALTA_ENTROPIA";
+        default: return "DADOS";
+    }
+}
+
+BlockClassifier::BlockClassifier()
+    : block_size_(0)
+    , entropy_(false)
+    , entropy_threshold_(8.0)
+    , simd_level_(detect_simd_level()) {
+    set_block_size(4096);
+}
+
+void BlockClassifier::set_block_size(size_t block_size) {
+    block_size_ = std::max<size_t>(block_size, 1);
+    weighted_log_.clear();
+
+    if (block_size_ < MIN_ENTROPY_BLOCK) {
+        return;
+    }
+
+    weighted_log_.resize(block_size_ + 1, 0.0f);
+    for (size_t count = 2; count <= block_size_; ++count) {
+        weighted_log_[count] = static_cast<float>(count * std::log2(static_cast<double>(count)));
+    }
+
+    // Dados aleatórios ficam abaixo de 8 bits pelo viés do histograma finito
+    // (~255 / (2N ln 2)); a margem de 1,5x mantém blocos cifrados acima do limite
+    double bias = 255.0 / (2.0 * static_cast<double>(block_size_) * std::log(2.0));
+    entropy_threshold_ = 8.0 - 1.5 * bias;
+}
+
+size_t BlockClassifier::get_block_size() const {
+    return block_size_;
+}
+
+void BlockClassifier::set_entropy(bool entropy) {
+    entropy_ = entropy;
+}
+
+void BlockClassifier::set_simd_level(SimdLevel level) {
+    simd_level_ = clamp_simd_level(level);
+}
+
+bool BlockClassifier::is_uniform(const uint8_t* data) const {
+    size_t checked = 0;
+
+#if CARVER_X86_SIMD
+    bool uniform = true;
+    switch (simd_level_) {
+        case SimdLevel::AVX512: uniform = uniform_avx512(data, block_size_, checked); break;
+        case SimdLevel::AVX2: uniform = uniform_avx2(data, block_size_, checked); break;
+        case SimdLevel::SSE2: uniform = uniform_sse2(data, block_size_, checked); break;
+        default: break;
+    }
+    if (!uniform) {
+        return false;
+    }
+#endif
+
+    return uniform_scalar(data, checked, block_size_);
+}
+
+bool BlockClassifier::is_high_entropy(const uint8_t* data) const {
+    if (weighted_log_.empty()) {
+        return false;
+    }
+
+    // Quatro histogramas intercalados evitam a dependência entre bytes repetidos
+    uint32_t histogram[4][256];
+    std::memset(histogram, 0, sizeof(histogram));
+    size_t i = 0;
+    for (; i + 4 <= block_size_; i += 4) {
+        histogram[0][data[i]]++;
+        histogram[1][data[i + 1]]++;
+        histogram[2][data[i + 2]]++;
+        histogram[3][data[i + 3]]++;
+    }
+    for (; i < block_size_; ++i) {
+        histogram[0][data[i]]++;
+    }
+
+    // H = log2(N) - sum(c * log2(c)) / N
+    double weighted = 0.0;
+    for (int byte = 0; byte < 256; ++byte) {
+        uint32_t count = histogram[0][byte] + histogram[1][byte] + histogram[2][byte] + histogram[3][byte];
+        weighted += weighted_log_[count];
+    }
+    double entropy = std::log2(static_cast<double>(block_size_)) - weighted / static_cast<double>(block_size_);
+    return entropy >= entropy_threshold_;
+}
+
+BlockClass BlockClassifier::classify(const uint8_t* data) const {
+    if (is_uniform(data)) {
+        return data[0] == 0 ? BlockClass::ZERO : BlockClass::UNIFORM;
+    }
+    if (entropy_ && is_high_entropy(data)) {
+        return BlockClass::HIGH_ENTROPY;
+    }
+    return BlockClass::DATA;
+}
+
+bool write_block_map(const std::string& path, const std::vector<BlockRun>& runs) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao criar mapa de blocos: " << path << std::endl;
+        return false;
+    }
+
+    file << "Inicio,Fim,Tipo\n";
+    for (const auto& run : runs) {
+        file << run.begin << "," << run.end << "," << block_class_name(run.type) << "\n";
+    }
+    file.close();
+
+    if (!file) {
+        std::cerr << "Erro ao gravar mapa de blocos: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
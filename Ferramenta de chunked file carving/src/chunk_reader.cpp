@@ -1,13 +1,64 @@
 #include "chunk_reader.h"
+#include "async_reader.h"
 #include <iostream>
 #include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CARVER_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#else
+#define CARVER_HAVE_MMAP 0
+#endif
+
+#if CARVER_HAVE_MMAP && defined(SEEK_DATA) && defined(SEEK_HOLE)
+#define CARVER_HAVE_SEEK_HOLE 1
+#endif
+
+#if defined(__linux__)
+#include <linux/fs.h>
+#include <sys/sendfile.h>
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+#define CARVER_HAVE_COPY_FILE_RANGE 1
+#endif
+#endif
+
+namespace {
+    // Maior bloco copiado por chamada no modo com buffer (memória limitada)
+    const size_t COPY_BUFFER_SIZE = 1 << 20;
+}
 
 ChunkReader::ChunkReader(size_t chunk_size, size_t overlap_size)
     : file_size_(0)
     , current_position_(0)
     , chunk_size_(chunk_size)
     , is_open_(false)
+    , verbose_(true)
+    , chunk_offset_(0)
     , overlap_size_(overlap_size)
+    , backend_(ReaderBackend::STREAM)
+    , fd_(-1)
+    , mapping_(nullptr)
+    , carried_overlap_(0)
+    , direct_fd_(-1)
+    , alignment_(1)
+    , direct_chunk_size_(0)
+    , direct_capacity_(0)
+    , direct_scratch_capacity_(0)
+    , io_depth_(0)
+    , huge_pages_(false)
+    , ring_unavailable_(false)
+    , sparse_(false)
+    , allocated_size_(0)
+    , data_begin_(0)
+    , data_end_(0)
+    , skipped_bytes_(0)
     , total_bytes_read_(0)
     , chunks_read_(0) {
     
@@ -32,13 +83,36 @@ bool ChunkReader::open(const std::string& filename) {
     
     is_open_ = true;
     current_position_ = 0;
+    chunk_offset_ = 0;
     total_bytes_read_ = 0;
     chunks_read_ = 0;
     
     calculate_file_size();
+    detect_sparse();
+    
+    if (backend_ == ReaderBackend::MMAP && !open_mapping()) {
+        std::cerr << "Aviso: mapeamento em memória indisponível para " << filename_
+                  << ", usando leitura em stream" << std::endl;
+    }
+    
+    if (backend_ == ReaderBackend::DIRECT && !open_direct()) {
+        std::cerr << "Aviso: leitura direta (O_DIRECT) indisponível para " << filename_
+                  << ", usando leitura em stream" << std::endl;
+    }
     
-    std::cout << "Arquivo aberto: " << filename_ 
-              << " (" << file_size_ << " bytes)" << std::endl;
+    if (get_backend() == ReaderBackend::STREAM && io_depth_ > 0 && file_size_ > 0) {
+        pipeline_ = std::make_unique<AsyncChunkPipeline>(chunk_size_, overlap_size_, io_depth_);
+        if (!pipeline_->open(filename_, file_size_)) {
+            std::cerr << "Aviso: leitura assíncrona indisponível para " << filename_
+                      << ", usando leitura síncrona" << std::endl;
+            pipeline_.reset();
+        }
+    }
+    
+    if (verbose_) {
+        std::cout << "Arquivo aberto: " << filename_ 
+                  << " (" << file_size_ << " bytes)" << std::endl;
+    }
     
     return true;
 }
@@ -47,6 +121,9 @@ void ChunkReader::close() {
     if (file_.is_open()) {
         file_.close();
     }
+    close_mapping();
+    close_direct();
+    pipeline_.reset();
     
     is_open_ = false;
     filename_.clear();
@@ -54,9 +131,28 @@ void ChunkReader::close() {
     overlap_buffer_.clear();
     file_size_ = 0;
     current_position_ = 0;
+    carried_overlap_ = 0;
+    sparse_ = false;
+    allocated_size_ = 0;
+    data_begin_ = 0;
+    data_end_ = 0;
+    skipped_bytes_ = 0;
 }
 
 bool ChunkReader::read_chunk(std::vector<uint8_t>& data, size_t& bytes_read) {
+    skip_hole();
+    
+    if (mapping_ || pipeline_ || direct_fd_ >= 0 || prepare_ring()) {
+        ChunkView view;
+        if (!read_chunk_view(view)) {
+            bytes_read = 0;
+            return false;
+        }
+        data.assign(view.data, view.data + view.size);
+        bytes_read = view.size;
+        return true;
+    }
+    
     if (!is_open_) {
         bytes_read = 0;
         return false;
@@ -86,6 +182,8 @@ bool ChunkReader::read_chunk(std::vector<uint8_t>& data, size_t& bytes_read) {
         bytes_read = overlap_buffer_.size();
     }
     
+    chunk_offset_ = current_position_ - bytes_read;
+    
     // Lê novos dados
     file_.seekg(current_position_);
     file_.read(reinterpret_cast<char*>(data.data() + bytes_read), bytes_to_read);
@@ -111,6 +209,124 @@ bool ChunkReader::read_chunk(std::vector<uint8_t>& data, size_t& bytes_read) {
     return bytes_read > 0;
 }
 
+bool ChunkReader::read_chunk_view(ChunkView& view) {
+    skip_hole();
+    
+    if (pipeline_) {
+        if (is_eof() || !pipeline_->next(view)) {
+            return false;
+        }
+        
+        // O pipeline lê cada chunk já com o overlap, direto no seu próprio buffer
+        size_t new_bytes = view.offset + view.size - current_position_;
+        chunk_offset_ = view.offset;
+        current_position_ += new_bytes;
+        total_bytes_read_ += new_bytes;
+        chunks_read_++;
+        return true;
+    }
+    
+    if (direct_fd_ >= 0) {
+        if (is_eof()) {
+            return false;
+        }
+        
+        // Os dados novos são lidos em posição alinhada, depois de uma reserva
+        // onde o overlap do chunk anterior é copiado
+        size_t bytes_to_read = std::min(direct_chunk_size_, file_size_ - current_position_);
+        size_t carried = current_position_ > 0 ? overlap_buffer_.size() : 0;
+        size_t reserve = (overlap_size_ + alignment_ - 1) / alignment_ * alignment_;
+        
+        const uint8_t* data;
+        size_t new_bytes = read_direct(current_position_, bytes_to_read, direct_buffer_, direct_capacity_, reserve, data);
+        if (new_bytes == 0) {
+            return false;
+        }
+        
+        uint8_t* chunk_start = direct_buffer_.get() + reserve + current_position_ % alignment_ - carried;
+        std::memcpy(chunk_start, overlap_buffer_.data(), carried);
+        
+        chunk_offset_ = current_position_ - carried;
+        view = {chunk_start, carried + new_bytes, chunk_offset_};
+        
+        current_position_ += new_bytes;
+        total_bytes_read_ += new_bytes;
+        chunks_read_++;
+        
+        overlap_buffer_.clear();
+        if (new_bytes >= overlap_size_ && current_position_ < file_size_) {
+            overlap_buffer_.assign(view.data + view.size - overlap_size_, view.data + view.size);
+        }
+        return true;
+    }
+    
+    if (!mapping_ && prepare_ring()) {
+        if (is_eof()) {
+            return false;
+        }
+        
+        // Os dados novos vão para a posição do seu offset no buffer circular;
+        // o overlap já está lá, no fim do chunk anterior
+        size_t bytes_to_read = std::min(chunk_size_, file_size_ - current_position_);
+        size_t carried = current_position_ > 0 ? carried_overlap_ : 0;
+        
+        file_.seekg(current_position_);
+        file_.read(reinterpret_cast<char*>(ring_.at(current_position_)), bytes_to_read);
+        size_t new_bytes = file_.gcount();
+        if (new_bytes == 0) {
+            return false;
+        }
+        
+        chunk_offset_ = current_position_ - carried;
+        view = {ring_.at(chunk_offset_), carried + new_bytes, chunk_offset_};
+        
+        current_position_ += new_bytes;
+        total_bytes_read_ += new_bytes;
+        chunks_read_++;
+        
+        carried_overlap_ = (new_bytes >= overlap_size_ && current_position_ < file_size_) ? overlap_size_ : 0;
+        return true;
+    }
+    
+    if (!mapping_) {
+        size_t bytes_read;
+        if (!read_chunk(buffer_, bytes_read)) {
+            return false;
+        }
+        view = {buffer_.data(), bytes_read, chunk_offset_};
+        return true;
+    }
+    
+    if (is_eof()) {
+        return false;
+    }
+    
+    // O overlap já está no mapeamento, imediatamente antes da posição atual
+    size_t bytes_to_read = std::min(chunk_size_, file_size_ - current_position_);
+    size_t carried = current_position_ > 0 ? carried_overlap_ : 0;
+    
+    chunk_offset_ = current_position_ - carried;
+    view = {mapping_ + chunk_offset_, carried + bytes_to_read, chunk_offset_};
+    
+    current_position_ += bytes_to_read;
+    total_bytes_read_ += bytes_to_read;
+    chunks_read_++;
+    
+    carried_overlap_ = (bytes_to_read >= overlap_size_ && current_position_ < file_size_) ? overlap_size_ : 0;
+    
+#if CARVER_HAVE_MMAP
+    // Pede ao kernel para já trazer o próximo chunk enquanto este é varrido
+    if (current_position_ < file_size_) {
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t advise_start = current_position_ / page * page;
+        size_t advise_length = std::min(chunk_size_ + (current_position_ - advise_start), file_size_ - advise_start);
+        madvise(const_cast<uint8_t*>(mapping_) + advise_start, advise_length, MADV_WILLNEED);
+    }
+#endif
+    
+    return true;
+}
+
 size_t ChunkReader::read_at_position(size_t position, size_t size, std::vector<uint8_t>& data) {
     if (!is_open_ || position >= file_size_) {
         return 0;
@@ -119,12 +335,177 @@ size_t ChunkReader::read_at_position(size_t position, size_t size, std::vector<u
     size_t bytes_to_read = std::min(size, file_size_ - position);
     data.resize(bytes_to_read);
     
+    if (mapping_) {
+        std::memcpy(data.data(), mapping_ + position, bytes_to_read);
+        return bytes_to_read;
+    }
+    
+    if (direct_fd_ >= 0) {
+        const uint8_t* source;
+        size_t available = read_direct(position, bytes_to_read, direct_scratch_, direct_scratch_capacity_, 0, source);
+        std::memcpy(data.data(), source, available);
+        data.resize(available);
+        return available;
+    }
+    
     file_.seekg(position);
     file_.read(reinterpret_cast<char*>(data.data()), bytes_to_read);
     
     return file_.gcount();
 }
 
+size_t ChunkReader::copy_range(size_t position, size_t size, const std::string& output_path, bool append,
+                               const CopyObserver& observer) {
+    if (!is_open_ || position >= file_size_) {
+        return 0;
+    }
+    
+    size = std::min(size, file_size_ - position);
+    size_t copied = 0;
+    
+#if CARVER_HAVE_MMAP
+    // Sem O_APPEND: copy_file_range recusa destinos abertos nesse modo
+    int output = ::open(output_path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (append ? 0 : O_TRUNC), 0644);
+    if (output < 0) {
+        std::cerr << "Erro ao criar arquivo: " << output_path << std::endl;
+        return 0;
+    }
+    if (append && lseek(output, 0, SEEK_END) < 0) {
+        std::cerr << "Erro ao gravar arquivo: " << output_path << " (" << std::strerror(errno) << ")" << std::endl;
+        ::close(output);
+        return 0;
+    }
+    
+    // O kernel não entrega os bytes ao observer
+    bool kernel_copy = !observer && open_descriptor();
+    
+#ifdef CARVER_HAVE_COPY_FILE_RANGE
+    // Cópia dentro do kernel (ou reflink, em sistemas de arquivos com suporte)
+    while (kernel_copy && copied < size) {
+        loff_t source_offset = static_cast<loff_t>(position + copied);
+        ssize_t result = copy_file_range(fd_, &source_offset, output, nullptr, size - copied, 0);
+        if (result > 0) {
+            copied += static_cast<size_t>(result);
+        } else if (result < 0 && errno == EINTR) {
+            continue;
+        } else {
+            break; // EXDEV, ENOSYS, EOPNOTSUPP...: tenta o próximo método
+        }
+    }
+#endif
+    
+#if defined(__linux__)
+    while (kernel_copy && copied < size) {
+        off_t source_offset = static_cast<off_t>(position + copied);
+        ssize_t result = sendfile(output, fd_, &source_offset, std::min<size_t>(size - copied, 1u << 30));
+        if (result > 0) {
+            copied += static_cast<size_t>(result);
+        } else if (result < 0 && errno == EINTR) {
+            continue;
+        } else {
+            break;
+        }
+    }
+#endif
+    
+    // Último recurso: cópia por blocos, sem carregar o arquivo inteiro em memória
+    while (copied < size) {
+        const uint8_t* source;
+        size_t length;
+        if (mapping_) {
+            source = mapping_ + position + copied;
+            length = observer ? std::min(size - copied, COPY_BUFFER_SIZE) : size - copied;
+        } else {
+            length = read_at_position(position + copied, std::min(size - copied, COPY_BUFFER_SIZE), scratch_);
+            source = scratch_.data();
+        }
+        if (length == 0) {
+            break;
+        }
+        if (observer) {
+            observer(source, length);
+        }
+        
+        size_t written = 0;
+        while (written < length) {
+            ssize_t result = ::write(output, source + written, length - written);
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                std::cerr << "Erro ao gravar arquivo: " << output_path << " (" << std::strerror(errno) << ")" << std::endl;
+                ::close(output);
+                return 0;
+            }
+            written += static_cast<size_t>(result);
+        }
+        copied += length;
+    }
+    
+    if (::close(output) != 0) {
+        std::cerr << "Erro ao gravar arquivo: " << output_path << " (" << std::strerror(errno) << ")" << std::endl;
+        return 0;
+    }
+    
+#if defined(__linux__)
+    // No modo DIRECT a região copiada pelo kernel não deve permanecer no cache
+    if (direct_fd_ >= 0 && fd_ >= 0) {
+        posix_fadvise(fd_, static_cast<off_t>(position), static_cast<off_t>(size), POSIX_FADV_DONTNEED);
+    }
+#endif
+#else
+    std::ofstream output(output_path, append ? std::ios::binary | std::ios::app : std::ios::binary);
+    if (!output.is_open()) {
+        std::cerr << "Erro ao criar arquivo: " << output_path << std::endl;
+        return 0;
+    }
+    
+    while (copied < size) {
+        size_t length = read_at_position(position + copied, std::min(size - copied, COPY_BUFFER_SIZE), scratch_);
+        if (length == 0) {
+            break;
+        }
+        if (observer) {
+            observer(scratch_.data(), length);
+        }
+        output.write(reinterpret_cast<const char*>(scratch_.data()), length);
+        copied += length;
+    }
+    
+    output.close();
+    if (!output) {
+        std::cerr << "Erro ao gravar arquivo: " << output_path << std::endl;
+        return 0;
+    }
+#endif
+    
+    return copied;
+}
+
+size_t ChunkReader::view_at_position(size_t position, size_t size, ChunkView& view) {
+    if (!is_open_ || position >= file_size_) {
+        view = {nullptr, 0, position};
+        return 0;
+    }
+    
+    if (mapping_) {
+        view = {mapping_ + position, std::min(size, file_size_ - position), position};
+        return view.size;
+    }
+    
+    if (direct_fd_ >= 0) {
+        const uint8_t* source;
+        size_t available = read_direct(position, std::min(size, file_size_ - position),
+                                       direct_scratch_, direct_scratch_capacity_, 0, source);
+        view = {source, available, position};
+        return available;
+    }
+    
+    size_t bytes_read = read_at_position(position, size, scratch_);
+    view = {scratch_.data(), bytes_read, position};
+    return bytes_read;
+}
+
 bool ChunkReader::seek(size_t position) {
     if (!is_open_) {
         return false;
@@ -136,10 +517,19 @@ bool ChunkReader::seek(size_t position) {
     
     current_position_ = position;
     overlap_buffer_.clear(); // Limpa overlap ao fazer seek manual
+    carried_overlap_ = 0;
+    
+    if (pipeline_) {
+        pipeline_->restart(position);
+    }
     
     return true;
 }
 
+size_t ChunkReader::get_chunk_offset() const {
+    return chunk_offset_;
+}
+
 size_t ChunkReader::tell() const {
     return current_position_;
 }
@@ -171,6 +561,137 @@ double ChunkReader::get_progress() const {
 void ChunkReader::set_chunk_size(size_t new_chunk_size) {
     chunk_size_ = new_chunk_size;
     buffer_.reserve(chunk_size_);
+    direct_chunk_size_ = (chunk_size_ + alignment_ - 1) / alignment_ * alignment_;
+}
+
+size_t ChunkReader::get_chunk_size() const {
+    return chunk_size_;
+}
+
+size_t ChunkReader::get_overlap_size() const {
+    return overlap_size_;
+}
+
+void ChunkReader::set_backend(ReaderBackend backend) {
+    backend_ = backend;
+}
+
+ReaderBackend ChunkReader::get_backend() const {
+    if (mapping_) {
+        return ReaderBackend::MMAP;
+    }
+    return direct_fd_ >= 0 ? ReaderBackend::DIRECT : ReaderBackend::STREAM;
+}
+
+void ChunkReader::set_io_depth(size_t io_depth) {
+    io_depth_ = io_depth;
+}
+
+size_t ChunkReader::get_io_depth() const {
+    return io_depth_;
+}
+
+void ChunkReader::set_huge_pages(bool huge_pages) {
+    huge_pages_ = huge_pages;
+}
+
+bool ChunkReader::get_huge_pages() const {
+    return huge_pages_;
+}
+
+bool ChunkReader::prepare_ring() {
+    if (!is_open_ || mapping_ || pipeline_ || direct_fd_ >= 0 || ring_unavailable_) {
+        return false;
+    }
+    
+    // Um chunk inteiro mais o overlap que o antecede cabem sem se sobrepor
+    size_t needed = chunk_size_ + overlap_size_;
+    if (ring_.capacity() >= needed && ring_.uses_huge_pages() == huge_pages_) {
+        return true;
+    }
+    if (!ring_.allocate(needed, huge_pages_)) {
+        ring_unavailable_ = true;
+        return false;
+    }
+    
+    // Posições já lidas estão no buffer anterior: o próximo chunk começa sem overlap
+    carried_overlap_ = 0;
+    return true;
+}
+
+const char* ChunkReader::get_io_engine_name() const {
+    return pipeline_ ? pipeline_->engine_name() : nullptr;
+}
+
+bool ChunkReader::is_sparse() const {
+    return sparse_;
+}
+
+size_t ChunkReader::get_allocated_size() const {
+    return allocated_size_;
+}
+
+size_t ChunkReader::get_skipped_bytes() const {
+    return skipped_bytes_;
+}
+
+void ChunkReader::detect_sparse() {
+    sparse_ = false;
+    allocated_size_ = file_size_;
+    data_begin_ = 0;
+    data_end_ = 0;
+    skipped_bytes_ = 0;
+    
+#ifdef CARVER_HAVE_SEEK_HOLE
+    // Dispositivos de bloco não informam blocos alocados; só arquivos regulares são esparsos
+    struct stat info;
+    if (file_size_ == 0 || !open_descriptor() || fstat(fd_, &info) != 0 || !S_ISREG(info.st_mode)) {
+        return;
+    }
+    allocated_size_ = std::min(file_size_, static_cast<size_t>(info.st_blocks) * 512);
+    sparse_ = allocated_size_ < file_size_;
+#endif
+}
+
+void ChunkReader::skip_hole() {
+#ifdef CARVER_HAVE_SEEK_HOLE
+    // Dentro do último extent de dados (ou no recuo que o antecede) não há o que saltar
+    if (!sparse_ || is_eof() || (current_position_ < data_end_ && current_position_ + overlap_size_ >= data_begin_)) {
+        return;
+    }
+    
+    // A busca começa no overlap do chunk anterior: ele também precisa estar no buraco
+    size_t from = current_position_ - std::min(current_position_, overlap_size_);
+    off_t data = lseek(fd_, static_cast<off_t>(from), SEEK_DATA);
+    if (data < 0) {
+        if (errno != ENXIO) {
+            sparse_ = false; // Sem suporte no sistema de arquivos: lê tudo
+            return;
+        }
+        data = static_cast<off_t>(file_size_); // Só buraco até o fim do arquivo
+    }
+    
+    off_t hole = static_cast<size_t>(data) < file_size_ ? lseek(fd_, data, SEEK_HOLE) : data;
+    data_begin_ = static_cast<size_t>(data);
+    data_end_ = hole < data ? file_size_ : std::min(file_size_, static_cast<size_t>(hole));
+    
+    size_t target = data_begin_ >= file_size_ ? file_size_ : data_begin_ - std::min(data_begin_, overlap_size_);
+    if (target <= current_position_) {
+        return;
+    }
+    
+    skipped_bytes_ += target - current_position_;
+    current_position_ = target;
+    overlap_buffer_.clear();
+    carried_overlap_ = 0;
+    if (pipeline_ && target < file_size_) {
+        pipeline_->restart(target);
+    }
+#endif
+}
+
+void ChunkReader::set_verbose(bool verbose) {
+    verbose_ = verbose;
 }
 
 void ChunkReader::set_overlap_size(size_t new_overlap_size) {
@@ -203,4 +724,163 @@ void ChunkReader::calculate_file_size() {
     
     // Restaura posição original
     file_.seekg(current_pos);
-}
\ No newline at end of file
+}
+
+bool ChunkReader::open_mapping() {
+#if CARVER_HAVE_MMAP
+    if (file_size_ == 0) {
+        return false;
+    }
+    
+    if (!open_descriptor()) {
+        return false;
+    }
+    
+    void* address = mmap(nullptr, file_size_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+    
+    // Varredura é sequencial: leitura antecipada agressiva e descarte rápido
+    madvise(address, file_size_, MADV_SEQUENTIAL);
+    mapping_ = static_cast<const uint8_t*>(address);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ChunkReader::AlignedFree::operator()(uint8_t* pointer) const {
+    std::free(pointer);
+}
+
+bool ChunkReader::open_direct() {
+#if CARVER_HAVE_MMAP && (defined(O_DIRECT) || defined(F_NOCACHE))
+    if (file_size_ == 0) {
+        return false;
+    }
+    
+#ifdef O_DIRECT
+    direct_fd_ = ::open(filename_.c_str(), O_RDONLY | O_DIRECT | O_CLOEXEC);
+#else
+    direct_fd_ = ::open(filename_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (direct_fd_ >= 0 && fcntl(direct_fd_, F_NOCACHE, 1) != 0) {
+        ::close(direct_fd_);
+        direct_fd_ = -1;
+    }
+#endif
+    if (direct_fd_ < 0) {
+        return false;
+    }
+    
+    // 4KB atende discos de 512 bytes e de 4K; dispositivos de bloco informam o setor lógico
+    alignment_ = 4096;
+#ifdef BLKSSZGET
+    struct stat info;
+    int sector_size = 0;
+    if (fstat(direct_fd_, &info) == 0 && S_ISBLK(info.st_mode) &&
+        ioctl(direct_fd_, BLKSSZGET, &sector_size) == 0 && sector_size > 0) {
+        alignment_ = std::max(alignment_, static_cast<size_t>(sector_size));
+    }
+#endif
+    
+    // Chunks múltiplos do setor mantêm alinhada a leitura de dados novos; o
+    // tamanho configurado fica intacto para uma próxima abertura em outro modo
+    direct_chunk_size_ = (chunk_size_ + alignment_ - 1) / alignment_ * alignment_;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ChunkReader::close_direct() {
+#if CARVER_HAVE_MMAP
+    if (direct_fd_ >= 0) {
+        ::close(direct_fd_);
+        direct_fd_ = -1;
+    }
+#endif
+    alignment_ = 1;
+    direct_chunk_size_ = 0;
+    direct_buffer_.reset();
+    direct_capacity_ = 0;
+    direct_scratch_.reset();
+    direct_scratch_capacity_ = 0;
+}
+
+size_t ChunkReader::read_direct(size_t position, size_t size, AlignedBuffer& buffer, size_t& capacity,
+                                size_t buffer_offset, const uint8_t*& data) {
+    data = nullptr;
+#if CARVER_HAVE_MMAP
+    // Início, tamanho e destino da leitura precisam ser múltiplos do setor
+    size_t aligned_start = position / alignment_ * alignment_;
+    size_t lead = position - aligned_start;
+    size_t aligned_length = (lead + size + alignment_ - 1) / alignment_ * alignment_;
+    
+    if (buffer_offset + aligned_length > capacity) {
+        void* memory = nullptr;
+        if (posix_memalign(&memory, alignment_, buffer_offset + aligned_length) != 0) {
+            std::cerr << "Erro ao alocar buffer alinhado de " << buffer_offset + aligned_length << " bytes" << std::endl;
+            return 0;
+        }
+        buffer.reset(static_cast<uint8_t*>(memory));
+        capacity = buffer_offset + aligned_length;
+    }
+    
+    uint8_t* destination = buffer.get() + buffer_offset;
+    size_t done = 0;
+    while (done < aligned_length) {
+        ssize_t result = pread(direct_fd_, destination + done, aligned_length - done,
+                               static_cast<off_t>(aligned_start + done));
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Erro de leitura direta em " << aligned_start + done << ": "
+                      << std::strerror(errno) << std::endl;
+            break;
+        }
+        if (result == 0) {
+            break;
+        }
+        done += static_cast<size_t>(result);
+        if (done % alignment_ != 0) {
+            break; // Leitura curta não alinhada: fim do arquivo
+        }
+    }
+    
+    data = destination + lead;
+    return done > lead ? std::min(size, done - lead) : 0;
+#else
+    (void)position;
+    (void)size;
+    (void)buffer;
+    (void)capacity;
+    (void)buffer_offset;
+    return 0;
+#endif
+}
+
+bool ChunkReader::open_descriptor() {
+#if CARVER_HAVE_MMAP
+    if (fd_ < 0) {
+        fd_ = ::open(filename_.c_str(), O_RDONLY | O_CLOEXEC);
+    }
+    return fd_ >= 0;
+#else
+    return false;
+#endif
+}
+
+void ChunkReader::close_mapping() {
+#if CARVER_HAVE_MMAP
+    if (mapping_) {
+        munmap(const_cast<uint8_t*>(mapping_), file_size_);
+        mapping_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+#endif
+}
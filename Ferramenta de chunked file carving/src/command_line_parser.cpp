@@ -3,6 +3,7 @@
 #include <sstream>
 #include <filesystem>
 #include <algorithm>
+#include <cctype>
 
 namespace fs = std::filesystem;
 
@@ -14,18 +15,45 @@ void CommandLineParser::initialize_help_messages() {
     help_messages_["input"] = "Arquivo de entrada para file carving (obrigatório)";
     help_messages_["output"] = "Diretório de saída para arquivos extraídos (padrão: output)";
     help_messages_["types"] = "Tipos de arquivo para procurar, separados por vírgula (ex: JPEG,PNG,PDF)";
+    help_messages_["signatures"] = "Carrega assinaturas adicionais (formato de signatures.conf, com cache compilado)";
     help_messages_["min-size"] = "Tamanho mínimo de arquivo em bytes (padrão: 512)";
     help_messages_["max-size"] = "Tamanho máximo de arquivo em bytes (0 = sem limite, padrão: 0)";
     help_messages_["chunk-size"] = "Tamanho do chunk de leitura em bytes (padrão: 65536)";
     help_messages_["overlap-size"] = "Tamanho do overlap entre chunks em bytes (padrão: 4096)";
     help_messages_["search-window"] = "Janela de busca para footers em bytes (padrão: 1048576)";
     help_messages_["no-extract"] = "Apenas detecta arquivos, não os extrai";
+    help_messages_["hash"] = "Calcula o hash XXH3 do conteúdo de cada arquivo (relatórios e duplicatas)";
+    help_messages_["sha256"] = "Calcula também o SHA-256 de cada arquivo para os relatórios (implica --hash)";
+    help_messages_["dedup"] = "Duplicatas de conteúdo: skip (não grava) ou link (hard link) (implica --hash)";
+    help_messages_["hash-only"] = "Calcula os hashes e aponta duplicatas sem gravar arquivos (triagem)";
+    help_messages_["known-hashes"] = "Descarta, sem gravar, arquivos cujo hash está no banco (gerado por carver-hashdb)";
     help_messages_["no-footers"] = "Não usa footers para delimitar arquivos";
+    help_messages_["no-structure"] = "Não lê o tamanho pela estrutura (JPEG, PNG, BMP, RIFF, MP4, SQLite, PE, ZIP, PDF)";
+    help_messages_["bifragment"] = "Procura o segundo fragmento de JPEG, ZIP e PDF cuja estrutura falha no meio";
+    help_messages_["max-gap"] = "Maior intervalo entre os dois fragmentos em bytes (padrão: 1048576)";
+    help_messages_["skip-carved"] = "Não procura cabeçalhos dentro de arquivos já delimitados (sem miniaturas/membros embutidos)";
+    help_messages_["mmap"] = "Lê a entrada via mapeamento em memória (sem cópias por chunk)";
+    help_messages_["direct"] = "Lê a entrada com O_DIRECT, sem ocupar o cache de páginas";
+    help_messages_["block-size"] = "Procura cabeçalhos só em offsets alinhados a blocos (ex.: 512, 4096; padrão: todos)";
+    help_messages_["block-offset"] = "Base do alinhamento de --block-size, ex.: início da partição (padrão: 0)";
+    help_messages_["unaligned"] = "Regiões <início-fim> varridas em todos os offsets no modo alinhado (repetível)";
+    help_messages_["skip-blocks"] = "Não procura cabeçalhos em blocos: uniform (zerados/repetidos), entropy (cifrados)";
+    help_messages_["block-map"] = "Grava o mapa de classes dos blocos em CSV (zero, uniforme, alta entropia, dados)";
+    help_messages_["io-depth"] = "Leituras de chunk em andamento via io_uring/threads (0 = síncrona, padrão: 0)";
+    help_messages_["huge-pages"] = "Buffer circular da leitura síncrona em páginas enormes (2MB), se disponíveis";
+    help_messages_["threads"] = "Número de threads de varredura (0 = todos os núcleos, padrão: 1)";
+    help_messages_["writers"] = "Threads de gravação dos arquivos extraídos (0 = na varredura, padrão: 2)";
+    help_messages_["write-queue"] = "Arquivos aguardando gravação antes de a varredura esperar (padrão: 64)";
+    help_messages_["simd"] = "Kernel de busca: auto, scalar, sse2, avx2, avx512 (padrão: auto)";
     help_messages_["verbose"] = "Modo verboso - exibe informações detalhadas";
     help_messages_["no-report"] = "Não gera relatório de texto";
     help_messages_["csv"] = "Gera relatório em formato CSV";
+    help_messages_["ndjson"] = "Gera relatório NDJSON (um objeto JSON por arquivo)";
+    help_messages_["store"] = "Grava resultados binários com índice por offset (consulta: carver-query)";
     help_messages_["report-file"] = "Nome do arquivo de relatório (padrão: carving_report.txt)";
     help_messages_["csv-file"] = "Nome do arquivo CSV (padrão: carving_report.csv)";
+    help_messages_["ndjson-file"] = "Nome do arquivo NDJSON (padrão: carving_report.ndjson)";
+    help_messages_["store-file"] = "Nome do arquivo de resultados binário (padrão: carving_results.crv)";
     help_messages_["help"] = "Exibe esta mensagem de ajuda";
     help_messages_["version"] = "Exibe informações de versão";
 }
@@ -68,6 +96,13 @@ bool CommandLineParser::parse(int argc, char* argv[]) {
             }
             config_.file_types = split_string(argv[++i], ',');
         }
+        else if (arg == "--signatures") {
+            if (i + 1 >= argc) {
+                std::cerr << "Erro: --signatures requer um argumento" << std::endl;
+                return false;
+            }
+            config_.signatures_file = argv[++i];
+        }
         else if (arg == "--min-size") {
             if (i + 1 >= argc) {
                 std::cerr << "Erro: --min-size requer um argumento" << std::endl;
@@ -121,9 +156,181 @@ bool CommandLineParser::parse(int argc, char* argv[]) {
         else if (arg == "--no-extract") {
             config_.extract_files = false;
         }
+        else if (arg == "--hash") {
+            config_.hash_files = true;
+        }
+        else if (arg == "--sha256") {
+            config_.hash_files = true;
+            config_.hash_sha256 = true;
+        }
+        else if (arg == "--dedup") {
+            if (i + 1 >= argc) {
+                std::cerr << "Erro: --dedup requer um argumento" << std::endl;
+                return false;
+            }
+            config_.dedup = argv[++i];
+            if (config_.dedup != "skip" && config_.dedup != "link") {
+                std::cerr << "Erro: valor inválido para --dedup (use skip ou link)" << std::endl;
+                return false;
+            }
+            config_.hash_files = true;
+        }
+        else if (arg == "--hash-only") {
+            config_.hash_files = true;
+            config_.extract_files = false;
+        }
+        else if (arg == "--known-hashes") {
+            if (i + 1 >= argc) {
+                std::cerr << "Erro: --known-hashes requer um argumento" << std::endl;
+                return false;
+            }
+            config_.known_hashes_file = argv[++i];
+            config_.hash_sha256 = true;     // O banco é consultado pelo SHA-256
+        }
         else if (arg == "--no-footers") {
             config_.use_footers = false;
         }
+        else if (arg == "--no-structure") {
+            config_.use_structure = false;
+        }
+        else if (arg == "--skip-carved") {
+            config_.skip_carved = true;
+        }
+        else if (arg == "--bifragment") {
+            config_.bifragment = true;
+        }
+        else if (arg == "--max-gap") {
+            if (i + 1 >= argc) {
+                std::cerr << "Erro: --max-gap requer um argumento" << std::endl;
+                return false;
+            }
+            if (!parse_size_argument(argv[++i], config_.max_gap)) {
+                std::cerr << "Erro: valor inválido para --max-gap" << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--mmap") {
+            config_.use_mmap = true;
+        }
+        else if (arg == "--direct") {
+            config_.use_direct = true;
+        }
+        else if (arg == "--huge-pages") {
+            config_.huge_pages = true;
+        }
+        else if (arg == "--io-depth") {
+            if (i + 1 >= argc) {
+                std::cerr << "Erro: --io-depth requer um argumento" << std::endl;
+                return false;
+            }
+            if (!parse_size_argument(argv[++i], config_.io_depth)) {
+                std::cerr << "Erro: valor inválido para --io-depth" << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--block-size") {
+            if (i + 1 >= argc) {
+                std::cerr << "Erro: --block-size requer um argumento" << std::endl;
+                return false;
+            }
+            if (!parse_size_argument(argv[++i], config_.block_size)) {
+                std::cerr << "Erro: valor inválido para --block-size" << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--block-offset") {
+            if (i + 1 >= argc) {
+                std::cerr << "Erro: --block-offset requer um argumento" << std::endl;
+                return false;
+            }
+            if (!parse_size_argument(argv[++i], config_.block_offset)) {
+                std::cerr << "Erro: valor inválido para --block-offset" << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--unaligned") {
+            if (i + 1 >= argc) {
+                std::cerr << "Erro: --unaligned requer um argumento" << std::endl;
+                return false;
+            }
+            std::stringstream regions(argv[++i]);
+            std::string item;
+            while (std::getline(regions, item, ',')) {
+                std::pair<size_t, size_t> region;
+                if (!parse_region_argument(item, region)) {
+                    std::cerr << "Erro: região inválida para --unaligned: " << item << std::endl;
+                    return false;
+                }
+                config_.unaligned_regions.push_back(region);
+            }
+        }
+        else if (arg == "--skip-blocks") {
+            if (i + 1 >= argc) {
+                std::cerr << "Erro: --skip-blocks requer um argumento" << std::endl;
+                return false;
+            }
+            std::stringstream classes(argv[++i]);
+            std::string item;
+            while (std::getline(classes, item, ',')) {
+                if (item == "uniform") {
+                    config_.skip_uniform_blocks = true;
+                } else if (item == "entropy") {
+                    config_.skip_entropy_blocks = true;
+                } else {
+                    std::cerr << "Erro: valor inválido para --skip-blocks (use uniform e/ou entropy): " << item << std::endl;
+                    return false;
+                }
+            }
+        }
+        else if (arg == "--block-map") {
+            if (i + 1 >= argc) {
+                std::cerr << "Erro: --block-map requer um argumento" << std::endl;
+                return false;
+            }
+            config_.block_map_file = argv[++i];
+        }
+        else if (arg == "--threads") {
+            if (i + 1 >= argc) {
+                std::cerr << "Erro: --threads requer um argumento" << std::endl;
+                return false;
+            }
+            if (!parse_size_argument(argv[++i], config_.threads)) {
+                std::cerr << "Erro: valor inválido para --threads" << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--writers") {
+            if (i + 1 >= argc) {
+                std::cerr << "Erro: --writers requer um argumento" << std::endl;
+                return false;
+            }
+            if (!parse_size_argument(argv[++i], config_.writers)) {
+                std::cerr << "Erro: valor inválido para --writers" << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--write-queue") {
+            if (i + 1 >= argc) {
+                std::cerr << "Erro: --write-queue requer um argumento" << std::endl;
+                return false;
+            }
+            if (!parse_size_argument(argv[++i], config_.write_queue) || config_.write_queue == 0) {
+                std::cerr << "Erro: valor inválido para --write-queue" << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--simd") {
+            if (i + 1 >= argc) {
+                std::cerr << "Erro: --simd requer um argumento" << std::endl;
+                return false;
+            }
+            SimdLevel level;
+            if (!parse_simd_level(argv[++i], level)) {
+                std::cerr << "Erro: valor inválido para --simd" << std::endl;
+                return false;
+            }
+            config_.simd_level = clamp_simd_level(level);
+        }
         else if (arg == "--verbose") {
             config_.verbose = true;
         }
@@ -133,6 +340,12 @@ bool CommandLineParser::parse(int argc, char* argv[]) {
         else if (arg == "--csv") {
             config_.generate_csv = true;
         }
+        else if (arg == "--ndjson") {
+            config_.generate_ndjson = true;
+        }
+        else if (arg == "--store") {
+            config_.generate_store = true;
+        }
         else if (arg == "--report-file") {
             if (i + 1 >= argc) {
                 std::cerr << "Erro: --report-file requer um argumento" << std::endl;
@@ -147,6 +360,20 @@ bool CommandLineParser::parse(int argc, char* argv[]) {
             }
             config_.csv_file = argv[++i];
         }
+        else if (arg == "--ndjson-file") {
+            if (i + 1 >= argc) {
+                std::cerr << "Erro: --ndjson-file requer um argumento" << std::endl;
+                return false;
+            }
+            config_.ndjson_file = argv[++i];
+        }
+        else if (arg == "--store-file") {
+            if (i + 1 >= argc) {
+                std::cerr << "Erro: --store-file requer um argumento" << std::endl;
+                return false;
+            }
+            config_.store_file = argv[++i];
+        }
         else if (arg[0] == '-') {
             std::cerr << "Erro: argumento desconhecido: " << arg << std::endl;
             return false;
@@ -180,6 +407,16 @@ bool CommandLineParser::validate_config() const {
         return false;
     }
     
+    if (!config_.signatures_file.empty() && !fs::exists(config_.signatures_file)) {
+        std::cerr << "Erro: arquivo de assinaturas não existe: " << config_.signatures_file << std::endl;
+        return false;
+    }
+    
+    if (!config_.known_hashes_file.empty() && !fs::exists(config_.known_hashes_file)) {
+        std::cerr << "Erro: banco de hashes não existe: " << config_.known_hashes_file << std::endl;
+        return false;
+    }
+    
     if (config_.chunk_size < 1024) {
         std::cerr << "Erro: chunk-size deve ser pelo menos 1024 bytes" << std::endl;
         return false;
@@ -190,6 +427,21 @@ bool CommandLineParser::validate_config() const {
         return false;
     }
     
+    if (config_.use_mmap && config_.use_direct) {
+        std::cerr << "Erro: --mmap e --direct não podem ser usados juntos" << std::endl;
+        return false;
+    }
+    
+    if (config_.bifragment && !config_.use_structure) {
+        std::cerr << "Erro: --bifragment não pode ser usado com --no-structure" << std::endl;
+        return false;
+    }
+    
+    if (!config_.unaligned_regions.empty() && config_.block_size <= 1) {
+        std::cerr << "Erro: --unaligned requer --block-size maior que 1" << std::endl;
+        return false;
+    }
+    
     if (config_.max_file_size > 0 && config_.min_file_size > config_.max_file_size) {
         std::cerr << "Erro: min-size não pode ser maior que max-size" << std::endl;
         return false;
@@ -214,16 +466,45 @@ void CommandLineParser::print_config() const {
         std::cout << "Tipos de arquivo: Todos" << std::endl;
     }
     
+    std::cout << "Arquivo de assinaturas: " << (config_.signatures_file.empty() ? "Nenhum" : config_.signatures_file) << std::endl;
     std::cout << "Tamanho mínimo: " << config_.min_file_size << " bytes" << std::endl;
     std::cout << "Tamanho máximo: " << (config_.max_file_size == 0 ? "Sem limite" : std::to_string(config_.max_file_size) + " bytes") << std::endl;
     std::cout << "Tamanho do chunk: " << config_.chunk_size << " bytes" << std::endl;
     std::cout << "Tamanho do overlap: " << config_.overlap_size << " bytes" << std::endl;
     std::cout << "Janela de busca: " << config_.search_window << " bytes" << std::endl;
     std::cout << "Extrair arquivos: " << (config_.extract_files ? "Sim" : "Não") << std::endl;
+    std::cout << "Hash do conteúdo: " << (!config_.hash_files ? "Não" : config_.hash_sha256 ? "XXH3 e SHA-256" : "XXH3") << std::endl;
+    std::cout << "Duplicatas: " << (config_.dedup == "skip" ? "Não gravadas" : config_.dedup == "link" ? "Hard links" : "Gravadas") << std::endl;
+    std::cout << "Hashes conhecidos: " << (config_.known_hashes_file.empty() ? "Nenhum" : config_.known_hashes_file) << std::endl;
     std::cout << "Usar footers: " << (config_.use_footers ? "Sim" : "Não") << std::endl;
+    std::cout << "Tamanho pela estrutura: " << (config_.use_structure ? "Sim" : "Não") << std::endl;
+    std::cout << "Arquivos embutidos: " << (config_.skip_carved ? "Ignorados" : "Reportados") << std::endl;
+    std::cout << "Dois fragmentos: " << (config_.bifragment ? "Sim (intervalo até " + std::to_string(config_.max_gap) + " bytes)" : std::string("Não")) << std::endl;
+    std::cout << "Leitura mapeada (mmap): " << (config_.use_mmap ? "Sim" : "Não") << std::endl;
+    std::cout << "Leitura direta (O_DIRECT): " << (config_.use_direct ? "Sim" : "Não") << std::endl;
+    std::cout << "Leituras em andamento: " << (config_.io_depth == 0 ? std::string("Síncrona") : std::to_string(config_.io_depth)) << std::endl;
+    std::cout << "Páginas enormes: " << (config_.huge_pages ? "Sim" : "Não") << std::endl;
+    if (config_.block_size > 1) {
+        std::cout << "Alinhamento de cabeçalhos: " << config_.block_size << " bytes (base "
+                  << config_.block_offset << ")" << std::endl;
+        for (const auto& region : config_.unaligned_regions) {
+            std::cout << "Região não alinhada: " << region.first << "-" << region.second << std::endl;
+        }
+    } else {
+        std::cout << "Alinhamento de cabeçalhos: Nenhum" << std::endl;
+    }
+    std::cout << "Blocos ignorados: " << (config_.skip_uniform_blocks && config_.skip_entropy_blocks ? "Uniformes e alta entropia"
+                                          : config_.skip_uniform_blocks ? "Uniformes"
+                                          : config_.skip_entropy_blocks ? "Alta entropia" : "Nenhum") << std::endl;
+    std::cout << "Mapa de blocos: " << (config_.block_map_file.empty() ? "Nenhum" : config_.block_map_file) << std::endl;
+    std::cout << "Threads: " << (config_.threads == 0 ? std::string("Automático") : std::to_string(config_.threads)) << std::endl;
+    std::cout << "Threads de gravação: " << config_.writers << " (fila: " << config_.write_queue << ")" << std::endl;
+    std::cout << "Kernel SIMD: " << simd_level_name(config_.simd_level) << std::endl;
     std::cout << "Modo verboso: " << (config_.verbose ? "Sim" : "Não") << std::endl;
     std::cout << "Gerar relatório: " << (config_.generate_report ? "Sim" : "Não") << std::endl;
     std::cout << "Gerar CSV: " << (config_.generate_csv ? "Sim" : "Não") << std::endl;
+    std::cout << "Gerar NDJSON: " << (config_.generate_ndjson ? "Sim" : "Não") << std::endl;
+    std::cout << "Gerar resultados binários: " << (config_.generate_store ? "Sim" : "Não") << std::endl;
     std::cout << std::endl;
 }
 
@@ -243,18 +524,45 @@ void CommandLineParser::print_help() const {
     std::cout << "  -i, --input <arquivo>      " << help_messages_.at("input") << std::endl;
     std::cout << "  -o, --output <diretório>   " << help_messages_.at("output") << std::endl;
     std::cout << "  -t, --types <tipos>        " << help_messages_.at("types") << std::endl;
+    std::cout << "      --signatures <arquivo> " << help_messages_.at("signatures") << std::endl;
     std::cout << "      --min-size <bytes>     " << help_messages_.at("min-size") << std::endl;
     std::cout << "      --max-size <bytes>     " << help_messages_.at("max-size") << std::endl;
     std::cout << "      --chunk-size <bytes>   " << help_messages_.at("chunk-size") << std::endl;
     std::cout << "      --overlap-size <bytes> " << help_messages_.at("overlap-size") << std::endl;
     std::cout << "      --search-window <bytes>" << help_messages_.at("search-window") << std::endl;
     std::cout << "      --no-extract           " << help_messages_.at("no-extract") << std::endl;
+    std::cout << "      --hash                 " << help_messages_.at("hash") << std::endl;
+    std::cout << "      --sha256               " << help_messages_.at("sha256") << std::endl;
+    std::cout << "      --dedup <modo>         " << help_messages_.at("dedup") << std::endl;
+    std::cout << "      --hash-only            " << help_messages_.at("hash-only") << std::endl;
+    std::cout << "      --known-hashes <arquivo> " << help_messages_.at("known-hashes") << std::endl;
     std::cout << "      --no-footers           " << help_messages_.at("no-footers") << std::endl;
+    std::cout << "      --no-structure         " << help_messages_.at("no-structure") << std::endl;
+    std::cout << "      --skip-carved          " << help_messages_.at("skip-carved") << std::endl;
+    std::cout << "      --bifragment           " << help_messages_.at("bifragment") << std::endl;
+    std::cout << "      --max-gap <bytes>      " << help_messages_.at("max-gap") << std::endl;
+    std::cout << "      --mmap                 " << help_messages_.at("mmap") << std::endl;
+    std::cout << "      --direct               " << help_messages_.at("direct") << std::endl;
+    std::cout << "      --io-depth <n>         " << help_messages_.at("io-depth") << std::endl;
+    std::cout << "      --huge-pages           " << help_messages_.at("huge-pages") << std::endl;
+    std::cout << "      --block-size <bytes>   " << help_messages_.at("block-size") << std::endl;
+    std::cout << "      --block-offset <bytes> " << help_messages_.at("block-offset") << std::endl;
+    std::cout << "      --unaligned <faixas>   " << help_messages_.at("unaligned") << std::endl;
+    std::cout << "      --skip-blocks <classes>" << help_messages_.at("skip-blocks") << std::endl;
+    std::cout << "      --block-map <arquivo>  " << help_messages_.at("block-map") << std::endl;
+    std::cout << "      --threads <n>          " << help_messages_.at("threads") << std::endl;
+    std::cout << "      --writers <n>          " << help_messages_.at("writers") << std::endl;
+    std::cout << "      --write-queue <n>      " << help_messages_.at("write-queue") << std::endl;
+    std::cout << "      --simd <nível>         " << help_messages_.at("simd") << std::endl;
     std::cout << "      --verbose              " << help_messages_.at("verbose") << std::endl;
     std::cout << "      --no-report            " << help_messages_.at("no-report") << std::endl;
     std::cout << "      --csv                  " << help_messages_.at("csv") << std::endl;
+    std::cout << "      --ndjson               " << help_messages_.at("ndjson") << std::endl;
+    std::cout << "      --store                " << help_messages_.at("store") << std::endl;
     std::cout << "      --report-file <arquivo>" << help_messages_.at("report-file") << std::endl;
     std::cout << "      --csv-file <arquivo>   " << help_messages_.at("csv-file") << std::endl;
+    std::cout << "      --ndjson-file <arquivo>" << help_messages_.at("ndjson-file") << std::endl;
+    std::cout << "      --store-file <arquivo> " << help_messages_.at("store-file") << std::endl;
     std::cout << "  -h, --help                 " << help_messages_.at("help") << std::endl;
     std::cout << "  -v, --version              " << help_messages_.at("version") << std::endl;
     std::cout << std::endl;
@@ -264,6 +572,12 @@ void CommandLineParser::print_help() const {
     std::cout << "  chunked_carver -i disk_image.dd -o recovered_files" << std::endl;
     std::cout << "  chunked_carver -i disk_image.dd -t JPEG,PNG,PDF --min-size 1024" << std::endl;
     std::cout << "  chunked_carver -i disk_image.dd --no-extract --csv" << std::endl;
+    std::cout << "  chunked_carver -i disk_image.dd --threads 0" << std::endl;
+    std::cout << "  chunked_carver -i disk_image.dd --dedup link --sha256 --csv" << std::endl;
+    std::cout << "  chunked_carver -i disk_image.dd --signatures signatures.conf" << std::endl;
+    std::cout << "  chunked_carver -i disk_image.dd --block-size 4096 --block-offset 1M --unaligned 0-1M" << std::endl;
+    std::cout << "  chunked_carver -i disk_image.dd --block-size 4096 --bifragment --max-gap 4M" << std::endl;
+    std::cout << "  chunked_carver -i disk_image.dd --skip-blocks uniform --block-map blocks.csv" << std::endl;
     std::cout << std::endl;
     
     std::cout << "TIPOS DE ARQUIVO SUPORTADOS:" << std::endl;
@@ -304,6 +618,16 @@ bool CommandLineParser::parse_size_argument(const std::string& arg, size_t& valu
     }
 }
 
+bool CommandLineParser::parse_region_argument(const std::string& arg, std::pair<size_t, size_t>& region) const {
+    size_t separator = arg.find('-');
+    if (separator == std::string::npos ||
+        !parse_size_argument(arg.substr(0, separator), region.first) ||
+        !parse_size_argument(arg.substr(separator + 1), region.second)) {
+        return false;
+    }
+    return region.first < region.second;
+}
+
 std::vector<std::string> CommandLineParser::split_string(const std::string& str, char delimiter) const {
     std::vector<std::string> result;
     std::stringstream ss(str);
@@ -316,7 +640,8 @@ std::vector<std::string> CommandLineParser::split_string(const std::string& str,
         
         if (!item.empty()) {
             // Converte para maiúscula
-            std::transform(item.begin(), item.end(), item.begin(), ::toupper);
+            std::transform(item.begin(), item.end(), item.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
             result.push_back(item);
         }
     }
@@ -0,0 +1,417 @@
+#include "content_hash.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+
+namespace {
+
+const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ull;
+const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4Full;
+const uint64_t PRIME64_3 = 0x165667B19E3779F9ull;
+const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ull;
+const uint64_t PRIME64_5 = 0x27D4EB2F165667C5ull;
+
+inline uint64_t rotl64(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint32_t rotr32(uint32_t value, int bits) {
+    return (value >> bits) | (value << (32 - bits));
+}
+
+inline uint64_t read_le64(const uint8_t* data) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+inline uint32_t read_le32(const uint8_t* data) {
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+// XXH3: segredo padrão e parâmetros da variante de 64 bits
+const uint8_t XXH3_SECRET[192] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+const size_t XXH3_STRIPE = 64;
+const size_t XXH3_SECRET_LIMIT = sizeof(XXH3_SECRET) - XXH3_STRIPE;      // Segredo do embaralhamento
+const size_t XXH3_STRIPES_PER_BLOCK = XXH3_SECRET_LIMIT / 8;            // 8 bytes de segredo por faixa
+const size_t XXH3_MIDSIZE_MAX = 240;
+const uint32_t PRIME32_1 = 0x9E3779B1u;
+const uint32_t PRIME32_2 = 0x85EBCA77u;
+const uint32_t PRIME32_3 = 0xC2B2AE3Du;
+const uint64_t PRIME_MX1 = 0x165667919E3779F9ull;
+const uint64_t PRIME_MX2 = 0x9FB21C651E98DF25ull;
+
+inline uint64_t swap64(uint64_t value) {
+    uint64_t result = 0;
+    for (int i = 0; i < 8; ++i) {
+        result = (result << 8) | ((value >> (i * 8)) & 0xFF);
+    }
+    return result;
+}
+
+/**
+ * @brief Produto 64x64 -> 128 bits, metades combinadas por XOR
+ */
+inline uint64_t mul128_fold64(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128_t;
+    uint128_t product = static_cast<uint128_t>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+    uint64_t lo_lo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+    uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFF);
+    uint64_t lo_hi = (a & 0xFFFFFFFF) * (b >> 32);
+    uint64_t hi_hi = (a >> 32) * (b >> 32);
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+    uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+    return lower ^ upper;
+#endif
+}
+
+inline uint64_t xxh64_avalanche(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    return hash ^ (hash >> 32);
+}
+
+inline uint64_t xxh3_avalanche(uint64_t hash) {
+    hash ^= hash >> 37;
+    hash *= PRIME_MX1;
+    return hash ^ (hash >> 32);
+}
+
+inline uint64_t xxh3_rrmxmx(uint64_t hash, uint64_t length) {
+    hash ^= rotl64(hash, 49) ^ rotl64(hash, 24);
+    hash *= PRIME_MX2;
+    hash ^= (hash >> 35) + length;
+    hash *= PRIME_MX2;
+    return hash ^ (hash >> 28);
+}
+
+inline uint64_t xxh3_mix16(const uint8_t* input, const uint8_t* secret) {
+    return mul128_fold64(read_le64(input) ^ read_le64(secret), read_le64(input + 8) ^ read_le64(secret + 8));
+}
+
+/**
+ * @brief XXH3 de entradas de até 240 bytes (sem acumuladores)
+ */
+uint64_t xxh3_short(const uint8_t* input, size_t length) {
+    const uint8_t* secret = XXH3_SECRET;
+    if (length == 0) {
+        return xxh64_avalanche(read_le64(secret + 56) ^ read_le64(secret + 64));
+    }
+    if (length <= 3) {
+        uint32_t combined = (static_cast<uint32_t>(input[0]) << 16) | (static_cast<uint32_t>(input[length >> 1]) << 24) |
+                            static_cast<uint32_t>(input[length - 1]) | (static_cast<uint32_t>(length) << 8);
+        uint64_t flip = read_le32(secret) ^ read_le32(secret + 4);
+        return xxh64_avalanche(combined ^ flip);
+    }
+    if (length <= 8) {
+        uint64_t value = read_le32(input + length - 4) + (static_cast<uint64_t>(read_le32(input)) << 32);
+        uint64_t flip = read_le64(secret + 8) ^ read_le64(secret + 16);
+        return xxh3_rrmxmx(value ^ flip, length);
+    }
+    if (length <= 16) {
+        uint64_t low = read_le64(input) ^ (read_le64(secret + 24) ^ read_le64(secret + 32));
+        uint64_t high = read_le64(input + length - 8) ^ (read_le64(secret + 40) ^ read_le64(secret + 48));
+        return xxh3_avalanche(length + swap64(low) + high + mul128_fold64(low, high));
+    }
+
+    uint64_t accumulator = length * PRIME64_1;
+    if (length <= 128) {
+        // Pares de 16 bytes das duas pontas, de fora para dentro
+        size_t pairs = (length - 1) / 32 + 1;
+        for (size_t i = pairs; i-- > 0; ) {
+            accumulator += xxh3_mix16(input + 16 * i, secret + 32 * i);
+            accumulator += xxh3_mix16(input + length - 16 * (i + 1), secret + 32 * i + 16);
+        }
+        return xxh3_avalanche(accumulator);
+    }
+
+    for (size_t i = 0; i < 8; ++i) {
+        accumulator += xxh3_mix16(input + 16 * i, secret + 16 * i);
+    }
+    accumulator = xxh3_avalanche(accumulator);
+    for (size_t i = 8; i < length / 16; ++i) {
+        accumulator += xxh3_mix16(input + 16 * i, secret + 16 * (i - 8) + 3);
+    }
+    accumulator += xxh3_mix16(input + length - 16, secret + 136 - 17);
+    return xxh3_avalanche(accumulator);
+}
+
+inline void xxh3_accumulate_stripe(uint64_t* accumulators, const uint8_t* input, const uint8_t* secret) {
+    for (size_t lane = 0; lane < 8; ++lane) {
+        uint64_t value = read_le64(input + lane * 8);
+        uint64_t keyed = value ^ read_le64(secret + lane * 8);
+        accumulators[lane ^ 1] += value;
+        accumulators[lane] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+    }
+}
+
+inline void xxh3_accumulate(uint64_t* accumulators, const uint8_t* input, const uint8_t* secret, size_t stripes) {
+    for (size_t stripe = 0; stripe < stripes; ++stripe) {
+        xxh3_accumulate_stripe(accumulators, input + stripe * XXH3_STRIPE, secret + stripe * 8);
+    }
+}
+
+inline void xxh3_scramble(uint64_t* accumulators) {
+    const uint8_t* secret = XXH3_SECRET + XXH3_SECRET_LIMIT;
+    for (size_t lane = 0; lane < 8; ++lane) {
+        uint64_t value = accumulators[lane];
+        value ^= value >> 47;
+        value ^= read_le64(secret + lane * 8);
+        accumulators[lane] = value * PRIME32_1;
+    }
+}
+
+const uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+} // namespace
+
+Xxh3::Xxh3()
+    : accumulators_{PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3, PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1}
+    , buffered_(0)
+    , total_length_(0)
+    , stripes_in_block_(0) {
+}
+
+void Xxh3::consume_stripes(const uint8_t* input, size_t stripes) {
+    // O bloco termina a cada 16 faixas: embaralha e volta ao início do segredo
+    while (stripes > 0) {
+        size_t take = std::min(stripes, XXH3_STRIPES_PER_BLOCK - stripes_in_block_);
+        xxh3_accumulate(accumulators_, input, XXH3_SECRET + stripes_in_block_ * 8, take);
+        stripes_in_block_ += take;
+        if (stripes_in_block_ == XXH3_STRIPES_PER_BLOCK) {
+            xxh3_scramble(accumulators_);
+            stripes_in_block_ = 0;
+        }
+        input += take * XXH3_STRIPE;
+        stripes -= take;
+    }
+}
+
+void Xxh3::update(const void* data, size_t size) {
+    const uint8_t* input = static_cast<const uint8_t*>(data);
+    total_length_ += size;
+
+    if (buffered_ + size <= BUFFER_SIZE) {
+        std::memcpy(buffer_ + buffered_, input, size);
+        buffered_ += size;
+        return;
+    }
+
+    // O último byte nunca é consumido aqui: a faixa final é tratada em digest
+    if (buffered_ > 0) {
+        size_t take = BUFFER_SIZE - buffered_;
+        std::memcpy(buffer_ + buffered_, input, take);
+        input += take;
+        size -= take;
+        consume_stripes(buffer_, BUFFER_SIZE / XXH3_STRIPE);
+        buffered_ = 0;
+    }
+
+    if (size > BUFFER_SIZE) {
+        size_t stripes = (size - 1) / XXH3_STRIPE;
+        consume_stripes(input, stripes);
+        input += stripes * XXH3_STRIPE;
+        size -= stripes * XXH3_STRIPE;
+        // A faixa anterior ao resto completa a última faixa se o resto for curto
+        std::memcpy(buffer_ + BUFFER_SIZE - XXH3_STRIPE, input - XXH3_STRIPE, XXH3_STRIPE);
+    }
+
+    std::memcpy(buffer_, input, size);
+    buffered_ = size;
+}
+
+uint64_t Xxh3::digest() const {
+    if (total_length_ <= XXH3_MIDSIZE_MAX) {
+        return xxh3_short(buffer_, static_cast<size_t>(total_length_));
+    }
+
+    // Cópia do estado: o hash pode continuar recebendo dados
+    Xxh3 copy = *this;
+    uint8_t last_stripe[XXH3_STRIPE];
+    const uint8_t* last;
+    if (buffered_ >= XXH3_STRIPE) {
+        copy.consume_stripes(buffer_, (buffered_ - 1) / XXH3_STRIPE);
+        last = buffer_ + buffered_ - XXH3_STRIPE;
+    } else {
+        size_t catchup = XXH3_STRIPE - buffered_;
+        std::memcpy(last_stripe, buffer_ + BUFFER_SIZE - catchup, catchup);
+        std::memcpy(last_stripe + catchup, buffer_, buffered_);
+        last = last_stripe;
+    }
+    xxh3_accumulate_stripe(copy.accumulators_, last, XXH3_SECRET + XXH3_SECRET_LIMIT - 7);
+
+    uint64_t hash = total_length_ * PRIME64_1;
+    for (size_t pair = 0; pair < 4; ++pair) {
+        hash += mul128_fold64(copy.accumulators_[2 * pair] ^ read_le64(XXH3_SECRET + 11 + 16 * pair),
+                              copy.accumulators_[2 * pair + 1] ^ read_le64(XXH3_SECRET + 11 + 16 * pair + 8));
+    }
+    return xxh3_avalanche(hash);
+}
+
+Sha256::Sha256()
+    : buffered_(0)
+    , total_length_(0) {
+    const uint32_t initial[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    std::memcpy(state_, initial, sizeof(state_));
+}
+
+void Sha256::process_block(const uint8_t* block) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (static_cast<uint32_t>(block[i * 4]) << 24) | (static_cast<uint32_t>(block[i * 4 + 1]) << 16) |
+               (static_cast<uint32_t>(block[i * 4 + 2]) << 8) | block[i * 4 + 3];
+    }
+    for (int i = 16; i < 64; ++i) {
+        uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+    uint32_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+    for (int i = 0; i < 64; ++i) {
+        uint32_t s1 = rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25);
+        uint32_t choice = (e & f) ^ (~e & g);
+        uint32_t t1 = h + s1 + choice + SHA256_K[i] + w[i];
+        uint32_t s0 = rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22);
+        uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2 = s0 + majority;
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state_[0] += a; state_[1] += b; state_[2] += c; state_[3] += d;
+    state_[4] += e; state_[5] += f; state_[6] += g; state_[7] += h;
+}
+
+void Sha256::update(const void* data, size_t size) {
+    const uint8_t* input = static_cast<const uint8_t*>(data);
+    total_length_ += size;
+
+    if (buffered_ > 0) {
+        size_t take = std::min<size_t>(64 - buffered_, size);
+        std::memcpy(buffer_ + buffered_, input, take);
+        buffered_ += take;
+        input += take;
+        size -= take;
+        if (buffered_ < 64) {
+            return;
+        }
+        process_block(buffer_);
+        buffered_ = 0;
+    }
+
+    while (size >= 64) {
+        process_block(input);
+        input += 64;
+        size -= 64;
+    }
+
+    std::memcpy(buffer_, input, size);
+    buffered_ = size;
+}
+
+Sha256Digest Sha256::digest() const {
+    // O preenchimento é feito em uma cópia: o hash pode continuar recebendo dados
+    Sha256 copy = *this;
+    uint64_t bit_length = total_length_ * 8;
+
+    const uint8_t marker = 0x80;
+    copy.update(&marker, 1);
+    const uint8_t zero = 0;
+    while (copy.buffered_ != 56) {
+        copy.update(&zero, 1);
+    }
+    uint8_t length[8];
+    for (int i = 0; i < 8; ++i) {
+        length[i] = static_cast<uint8_t>(bit_length >> (56 - i * 8));
+    }
+    copy.update(length, sizeof(length));
+
+    Sha256Digest digest;
+    for (size_t i = 0; i < 8; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            digest[i * 4 + j] = static_cast<uint8_t>(copy.state_[i] >> (24 - j * 8));
+        }
+    }
+    return digest;
+}
+
+std::string Sha256::hex_digest() const {
+    return format_sha256(digest());
+}
+
+std::string format_sha256(const Sha256Digest& digest) {
+    static const char DIGITS[] = "0123456789abcdef";
+    std::string hex(digest.size() * 2, '0');
+    for (size_t i = 0; i < digest.size(); ++i) {
+        hex[i * 2] = DIGITS[digest[i] >> 4];
+        hex[i * 2 + 1] = DIGITS[digest[i] & 0x0F];
+    }
+    return hex;
+}
+
+bool parse_sha256(const std::string& hex, Sha256Digest& digest) {
+    if (hex.size() != digest.size() * 2) {
+        return false;
+    }
+    for (size_t i = 0; i < hex.size(); ++i) {
+        char c = hex[i];
+        uint8_t value;
+        if (c >= '0' && c <= '9') value = static_cast<uint8_t>(c - '0');
+        else if (c >= 'a' && c <= 'f') value = static_cast<uint8_t>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') value = static_cast<uint8_t>(c - 'A' + 10);
+        else return false;
+        if (i % 2 == 0) {
+            digest[i / 2] = static_cast<uint8_t>(value << 4);
+        } else {
+            digest[i / 2] |= value;
+        }
+    }
+    return true;
+}
+
+std::string format_hash64(uint64_t hash) {
+    char digits[17];
+    std::snprintf(digits, sizeof(digits), "%016llx", static_cast<unsigned long long>(hash));
+    return digits;
+}
@@ -0,0 +1,101 @@
+#include "cpu_features.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+SimdLevel probe_simd_level() {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE2;
+    return SimdLevel::SCALAR;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4] = {0, 0, 0, 0};
+    __cpuid(info, 0);
+    int max_leaf = info[0];
+
+    __cpuid(info, 1);
+    bool sse2 = (info[3] & (1 << 26)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+
+    bool avx2 = false;
+    bool avx512bw = false;
+    if (osxsave && max_leaf >= 7) {
+        unsigned long long xcr0 = _xgetbv(0);
+        bool ymm_state = (xcr0 & 0x6) == 0x6;
+        bool zmm_state = (xcr0 & 0xE6) == 0xE6;
+
+        __cpuidex(info, 7, 0);
+        avx2 = ymm_state && (info[1] & (1 << 5)) != 0;
+        avx512bw = zmm_state && (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0;
+    }
+
+    if (avx512bw) return SimdLevel::AVX512;
+    if (avx2) return SimdLevel::AVX2;
+    if (sse2) return SimdLevel::SSE2;
+    return SimdLevel::SCALAR;
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+
+bool probe_ssse3() {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4] = {0, 0, 0, 0};
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#else
+    return false;
+#endif
+}
+
+} // namespace
+
+SimdLevel detect_simd_level() {
+    static const SimdLevel level = probe_simd_level();
+    return level;
+}
+
+bool cpu_supports_ssse3() {
+    static const bool supported = probe_ssse3();
+    return supported;
+}
+
+SimdLevel clamp_simd_level(SimdLevel requested) {
+    SimdLevel supported = detect_simd_level();
+    return static_cast<int>(requested) < static_cast<int>(supported) ? requested : supported;
+}
+
+const char* simd_level_name(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SSE2: return "SSE2";
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::AVX512: return "AVX-512";
+        default: return "Escalar";
+    }
+}
+
+bool parse_simd_level(const std::string& name, SimdLevel& level) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+
+    if (lower == "auto") {
+        level = detect_simd_level();
+    } else if (lower == "scalar") {
+        level = SimdLevel::SCALAR;
+    } else if (lower == "sse2") {
+        level = SimdLevel::SSE2;
+    } else if (lower == "avx2") {
+        level = SimdLevel::AVX2;
+    } else if (lower == "avx512") {
+        level = SimdLevel::AVX512;
+    } else {
+        return false;
+    }
+    return true;
+}
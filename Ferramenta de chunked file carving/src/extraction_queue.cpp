@@ -0,0 +1,114 @@
+#include "extraction_queue.h"
+#include "chunk_reader.h"
+#include <algorithm>
+
+ExtractionQueue::ExtractionQueue(const std::vector<ChunkReader*>& readers, size_t capacity,
+                                 Extractor extract, Retire retire, Prepare prepare, Claim claim)
+    : capacity_(std::max<size_t>(capacity, 1))
+    , next_sequence_(0)
+    , next_claim_(0)
+    , stopping_(false)
+    , prepare_(std::move(prepare))
+    , claim_(std::move(claim))
+    , extract_(std::move(extract))
+    , retire_(std::move(retire)) {
+
+    for (ChunkReader* reader : readers) {
+        writers_.emplace_back([this, reader]() { writer_loop(*reader); });
+    }
+}
+
+ExtractionQueue::~ExtractionQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_available_.notify_all();
+    for (auto& writer : writers_) {
+        writer.join();
+    }
+}
+
+void ExtractionQueue::writer_loop(ChunkReader& reader) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_available_.wait(lock, [this]() { return stopping_ || !waiting_.empty(); });
+        if (waiting_.empty()) {
+            return;     // Encerrando, nada pendente
+        }
+
+        // O Job fica no mesmo endereço: o deque só cresce no fim e é consumido no início
+        Job* job = waiting_.front();
+        waiting_.pop_front();
+        lock.unlock();
+
+        if (prepare_) {
+            try {
+                prepare_(job->file, reader);
+            } catch (...) {
+                // Sem preparação o arquivo ainda passa pela etapa ordenada
+            }
+        }
+
+        if (claim_) {
+            // Os envios anteriores já foram pegos por outras threads: a espera termina
+            lock.lock();
+            claim_turn_.wait(lock, [this, job]() { return next_claim_ == job->sequence; });
+            lock.unlock();
+            try {
+                claim_(job->file, reader);
+            } catch (...) {
+            }
+            lock.lock();
+            next_claim_++;
+            claim_turn_.notify_all();
+            lock.unlock();
+        }
+
+        bool extracted = false;
+        try {
+            extracted = extract_(job->file, reader);
+        } catch (...) {
+            extracted = false;
+        }
+
+        lock.lock();
+        job->file.extracted = extracted;
+        job->done = true;
+        job_done_.notify_all();
+    }
+}
+
+void ExtractionQueue::retire_front(std::unique_lock<std::mutex>& lock) {
+    CarvedFile file = std::move(jobs_.front().file);
+    jobs_.pop_front();
+    lock.unlock();
+    retire_(file);
+    lock.lock();
+}
+
+void ExtractionQueue::submit(CarvedFile file) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // Contrapressão: o varredor espera o arquivo mais antigo liberar espaço
+    while (jobs_.size() >= capacity_) {
+        job_done_.wait(lock, [this]() { return jobs_.front().done; });
+        retire_front(lock);
+    }
+
+    jobs_.push_back(Job{std::move(file), next_sequence_++, false});
+    waiting_.push_back(&jobs_.back());
+    work_available_.notify_one();
+
+    while (!jobs_.empty() && jobs_.front().done) {
+        retire_front(lock);
+    }
+}
+
+void ExtractionQueue::drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!jobs_.empty()) {
+        job_done_.wait(lock, [this]() { return jobs_.front().done; });
+        retire_front(lock);
+    }
+}
@@ -1,10 +1,19 @@
 #include "file_carver.h"
+#include "thread_pool.h"
+#include "gap_carver.h"
+#include "extraction_queue.h"
+#include "content_hash.h"
 #include <iostream>
 #include <fstream>
 #include <filesystem>
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <condition_variable>
 
 namespace fs = std::filesystem;
 
@@ -14,10 +23,27 @@ FileCarver::FileCarver(const std::string& output_dir)
     , max_file_size_(0)
     , extract_files_(true)
     , use_footers_(true)
+    , use_structure_(true)
+    , bifragment_(false)
+    , max_gap_(1024 * 1024) // 1MB
+    , skip_carved_(false)
     , search_window_(1024 * 1024) // 1MB
+    , num_threads_(1)
+    , extraction_writers_(2)
+    , extraction_queue_depth_(64)
+    , hash_files_(false)
+    , hash_sha256_(false)
+    , dedup_mode_(DedupMode::NONE)
+    , block_size_(0)
+    , block_offset_(0)
+    , skip_uniform_blocks_(false)
+    , skip_entropy_blocks_(false)
     , files_found_(0)
     , files_extracted_(0)
-    , bytes_processed_(0) {
+    , files_duplicated_(0)
+    , files_known_(0)
+    , bytes_processed_(0)
+    , last_progress_step_(-1) {
     
     signature_detector_ = std::make_unique<FileSignatureDetector>();
     chunk_reader_ = std::make_unique<ChunkReader>();
@@ -48,10 +74,83 @@ void FileCarver::set_use_footers(bool use_footers) {
     use_footers_ = use_footers;
 }
 
+void FileCarver::set_use_structure(bool use_structure) {
+    use_structure_ = use_structure;
+}
+
+void FileCarver::set_bifragment(bool bifragment, size_t max_gap) {
+    bifragment_ = bifragment;
+    max_gap_ = max_gap;
+}
+
+void FileCarver::set_skip_carved(bool skip_carved) {
+    skip_carved_ = skip_carved;
+}
+
 void FileCarver::set_search_window(size_t window_size) {
     search_window_ = window_size;
 }
 
+void FileCarver::set_chunk_size(size_t chunk_size) {
+    chunk_reader_->set_chunk_size(chunk_size);
+}
+
+void FileCarver::set_overlap_size(size_t overlap_size) {
+    chunk_reader_->set_overlap_size(overlap_size);
+}
+
+void FileCarver::set_simd_level(SimdLevel level) {
+    signature_detector_->set_simd_level(level);
+    block_classifier_.set_simd_level(level);
+}
+
+void FileCarver::set_reader_backend(ReaderBackend backend) {
+    chunk_reader_->set_backend(backend);
+}
+
+void FileCarver::set_io_depth(size_t io_depth) {
+    chunk_reader_->set_io_depth(io_depth);
+}
+
+void FileCarver::set_huge_pages(bool huge_pages) {
+    chunk_reader_->set_huge_pages(huge_pages);
+}
+
+void FileCarver::set_num_threads(size_t num_threads) {
+    num_threads_ = ThreadPool::resolve_thread_count(num_threads);
+}
+
+void FileCarver::set_extraction_writers(size_t writers, size_t queue_depth) {
+    extraction_writers_ = writers;
+    extraction_queue_depth_ = std::max<size_t>(queue_depth, 1);
+}
+
+void FileCarver::set_hashing(bool hash_files, bool sha256) {
+    hash_files_ = hash_files || sha256;
+    hash_sha256_ = sha256;
+}
+
+void FileCarver::set_dedup(DedupMode mode) {
+    dedup_mode_ = mode;
+}
+
+void FileCarver::set_block_alignment(size_t block_size, size_t block_offset) {
+    block_size_ = block_size > 1 ? block_size : 0;
+    block_offset_ = block_offset;
+}
+
+void FileCarver::add_unaligned_region(size_t begin, size_t end) {
+    if (begin < end) {
+        unaligned_regions_.emplace_back(begin, end);
+    }
+}
+
+void FileCarver::set_block_classification(bool skip_uniform, bool skip_entropy, const std::string& map_file) {
+    skip_uniform_blocks_ = skip_uniform;
+    skip_entropy_blocks_ = skip_entropy;
+    block_map_file_ = map_file;
+}
+
 void FileCarver::set_progress_callback(std::function<void(double)> callback) {
     progress_callback_ = callback;
 }
@@ -60,6 +159,43 @@ void FileCarver::add_custom_signature(const FileSignature& signature) {
     signature_detector_->add_signature(signature);
 }
 
+void FileCarver::add_custom_signatures(const std::vector<FileSignature>& signatures) {
+    signature_detector_->add_signatures(signatures);
+}
+
+bool FileCarver::load_signatures(const std::string& filename) {
+    auto start = std::chrono::steady_clock::now();
+    if (!signature_detector_->load_signatures_from_file(filename)) {
+        return false;
+    }
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2) << elapsed.count();
+    std::cout << "Assinaturas carregadas de " << filename << ": "
+              << signature_detector_->get_signatures().size() << " tipos ("
+              << (signature_detector_->was_loaded_from_cache() ? "autômato do cache" : "autômato compilado")
+              << ", " << oss.str() << " ms)" << std::endl;
+    return true;
+}
+
+bool FileCarver::load_known_hashes(const std::string& filename) {
+    auto start = std::chrono::steady_clock::now();
+    auto known_hashes = std::make_unique<KnownHashSet>();
+    if (!known_hashes->open(filename)) {
+        return false;
+    }
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+    
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2) << elapsed.count();
+    std::cout << "Hashes conhecidos carregados de " << filename << ": " << known_hashes->size()
+              << " hashes (" << oss.str() << " ms)" << std::endl;
+    known_hashes_ = std::move(known_hashes);
+    hash_sha256_ = true;    // O banco é consultado pelo SHA-256
+    return true;
+}
+
 bool FileCarver::carve_file(const std::string& input_file) {
     return carve_file_types(input_file, {});
 }
@@ -74,6 +210,14 @@ bool FileCarver::carve_file_types(const std::string& input_file, const std::vect
     
     std::cout << "Iniciando file carving em: " << input_file << std::endl;
     std::cout << "Tamanho do arquivo: " << chunk_reader_->get_file_size() << " bytes" << std::endl;
+    if (chunk_reader_->is_sparse()) {
+        std::cout << "Arquivo esparso: " << chunk_reader_->get_allocated_size()
+                  << " bytes alocados (buracos não são lidos)" << std::endl;
+    }
+    if (chunk_reader_->get_io_engine_name()) {
+        std::cout << "Leitura antecipada: " << chunk_reader_->get_io_engine_name()
+                  << " (" << chunk_reader_->get_io_depth() << " leituras em andamento)" << std::endl;
+    }
     
     if (!file_types.empty()) {
         std::cout << "Procurando por tipos: ";
@@ -83,27 +227,14 @@ bool FileCarver::carve_file_types(const std::string& input_file, const std::vect
         std::cout << std::endl;
     }
     
-    std::vector<uint8_t> chunk_data;
-    size_t bytes_read;
-    size_t file_offset = 0;
+    // Blocos do tamanho do alinhamento (clusters), para que o mapa coincida com eles
+    block_classifier_.set_block_size(block_size_ > 1 ? block_size_ : 4096);
+    block_classifier_.set_entropy(skip_entropy_blocks_ || !block_map_file_.empty());
     
-    while (chunk_reader_->read_chunk(chunk_data, bytes_read)) {
-        process_chunk(chunk_data, bytes_read, file_offset, file_types);
-        
-        file_offset = chunk_reader_->tell();
-        bytes_processed_ += bytes_read;
-        
-        // Atualiza progresso
-        double progress = chunk_reader_->get_progress();
-        update_progress(progress);
-        
-        // Exibe progresso a cada 5%
-        static int last_progress = -1;
-        int current_progress = static_cast<int>(progress / 5) * 5;
-        if (current_progress != last_progress && current_progress % 5 == 0) {
-            std::cout << "Progresso: " << current_progress << "%" << std::endl;
-            last_progress = current_progress;
-        }
+    if (num_threads_ > 1) {
+        carve_parallel(input_file, file_types);
+    } else {
+        carve_sequential(input_file, file_types);
     }
     
     chunk_reader_->close();
@@ -111,215 +242,999 @@ bool FileCarver::carve_file_types(const std::string& input_file, const std::vect
     std::cout << "\nFile carving concluído!" << std::endl;
     std::cout << "Arquivos encontrados: " << files_found_ << std::endl;
     std::cout << "Arquivos extraídos: " << files_extracted_ << std::endl;
+    if (hashing_enabled()) {
+        std::cout << "Arquivos duplicados: " << files_duplicated_ << std::endl;
+    }
+    if (known_hashes_) {
+        std::cout << "Arquivos conhecidos descartados: " << files_known_ << std::endl;
+    }
     std::cout << "Bytes processados: " << bytes_processed_ << std::endl;
     
+    finish_result_sinks();
     return true;
 }
 
-const std::vector<CarvedFile>& FileCarver::get_carved_files() const {
-    return carved_files_;
+void FileCarver::carve_sequential(const std::string& input_file, const std::vector<std::string>& file_types) {
+    ChunkView chunk;
+    std::vector<ScanHit> hits;
+    LengthResolver resolver(*chunk_reader_, search_window_);
+    FooterTracker tracker(*signature_detector_, search_window_, chunk_reader_->get_file_size(),
+                          use_structure_ ? &resolver : nullptr);
+    
+    // Hipóteses de fragmentação em um pool do tamanho da máquina (a varredura
+    // aguarda cada candidato), com um leitor próprio por worker
+    std::unique_ptr<ThreadPool> gap_pool;
+    std::vector<std::unique_ptr<ChunkReader>> gap_readers;
+    std::unique_ptr<GapCarver> gap_carver = make_gap_carver(input_file, gap_pool, gap_readers);
+    
+    // Regiões aceitas: puladas na varredura (skip_carved) e usadas para marcar arquivos embutidos
+    IntervalIndex carved;
+    
+    // Gravação (e hash) fora da thread de varredura; os arquivos voltam em ordem para os relatórios
+    std::vector<std::unique_ptr<ChunkReader>> writer_readers;
+    std::unique_ptr<ExtractionQueue> extraction = make_extraction_queue(input_file, writer_readers);
+    
+    std::vector<BlockSurvey> surveys(1);
+    BlockSurvey* survey = classifying_blocks() ? &surveys[0] : nullptr;
+    if (survey) {
+        start_block_survey(*survey, 0);
+    }
+    
+    size_t claimed = 0;     // Cabeçalhos anteriores já pertencem a chunks processados
+    size_t consumed = 0;    // Posição do leitor: o overlap não é contado duas vezes
+    while (chunk_reader_->read_chunk_view(chunk)) {
+        size_t claim_end = header_claim_end(chunk, *chunk_reader_);
+        process_chunk(tracker, chunk.data, chunk.size, chunk.offset, claimed, claim_end, file_types,
+                      skip_carved_ ? &carved : nullptr, survey, hits);
+        claimed = std::max(claimed, claim_end);
+        emit_hits(hits, gap_carver.get(), carved, extraction.get());
+        
+        bytes_processed_ += chunk_reader_->tell() - consumed;
+        consumed = chunk_reader_->tell();
+        report_progress(chunk_reader_->get_progress());
+    }
+    
+    // Buracos saltados (inclusive o do fim do arquivo) contam como processados
+    bytes_processed_ += chunk_reader_->tell() - consumed;
+    
+    tracker.finish();
+    collect_resolved(tracker, hits);
+    emit_hits(hits, gap_carver.get(), carved, extraction.get());
+    
+    if (extraction) {
+        extraction->drain();
+    }
+    
+    if (survey) {
+        close_block_survey(*survey, chunk_reader_->get_file_size(), chunk_reader_->get_file_size());
+        finish_block_survey(surveys);
+    }
 }
 
-void FileCarver::get_statistics(size_t& files_found, size_t& files_extracted, size_t& bytes_processed) const {
-    files_found = files_found_;
-    files_extracted = files_extracted_;
-    bytes_processed = bytes_processed_;
+void FileCarver::carve_parallel(const std::string& input_file, const std::vector<std::string>& file_types) {
+    const size_t file_size = chunk_reader_->get_file_size();
+    const size_t chunk_size = chunk_reader_->get_chunk_size();
+    
+    ThreadPool pool(num_threads_);
+    std::cout << "Varredura paralela com " << pool.size() << " threads" << std::endl;
+    
+    // Cada worker tem seu próprio leitor
+    std::vector<std::unique_ptr<ChunkReader>> readers;
+    for (size_t i = 0; i < pool.size(); ++i) {
+        readers.push_back(open_worker_reader(input_file, true));
+    }
+    std::vector<BlockSurvey> worker_surveys(pool.size());
+    const bool classify = classifying_blocks();
+    
+    // Faixas menores que o arquivo/threads permitem balancear via roubo de tarefas
+    size_t range_size = file_size / (pool.size() * 16) + 1;
+    range_size = std::max(chunk_size * 4, (range_size + chunk_size - 1) / chunk_size * chunk_size);
+    const size_t range_count = file_size > 0 ? (file_size + range_size - 1) / range_size : 0;
+    
+    // Hits de cada faixa concluída, até a marca d'água (todas as faixas
+    // anteriores concluídas) passar por ela e o lote ser emitido
+    std::vector<std::vector<ScanHit>> range_hits(range_count);
+    std::vector<bool> range_done(range_count, false);
+    std::mutex done_mutex;
+    std::condition_variable range_finished;
+    
+    std::atomic<size_t> scanned_bytes(0);
+    for (size_t range = 0; range < range_count; ++range) {
+        pool.submit([this, range, range_size, file_size, classify, &readers, &worker_surveys, &file_types,
+                     &scanned_bytes, &range_hits, &range_done, &done_mutex, &range_finished]() {
+            size_t worker = ThreadPool::current_worker();
+            size_t begin = range * range_size;
+            size_t end = std::min(file_size, begin + range_size);
+            std::vector<ScanHit> hits;
+            scan_range(*readers[worker], begin, end, file_types, classify ? &worker_surveys[worker] : nullptr, hits);
+            scanned_bytes += end - begin;
+            {
+                std::lock_guard<std::mutex> lock(done_mutex);
+                range_hits[range] = std::move(hits);
+                range_done[range] = true;
+            }
+            range_finished.notify_one();
+        });
+    }
+    
+    // Pool próprio para as hipóteses de fragmentação: o da varredura está ocupado
+    std::unique_ptr<ThreadPool> gap_pool;
+    std::vector<std::unique_ptr<ChunkReader>> gap_readers;
+    std::unique_ptr<GapCarver> gap_carver = make_gap_carver(input_file, gap_pool, gap_readers);
+    
+    // Faixas vizinhas não conhecem os arquivos umas das outras: a classificação
+    // é feita aqui, lote a lote, em ordem de offset
+    IntervalIndex carved;
+    std::vector<std::unique_ptr<ChunkReader>> writer_readers;
+    std::unique_ptr<ExtractionQueue> extraction = make_extraction_queue(input_file, writer_readers);
+    
+    // Emissão em ordem de offset enquanto a varredura continua: só os hits das
+    // faixas ainda abaixo da marca d'água ficam em memória
+    size_t watermark = 0;
+    std::vector<ScanHit> hits;
+    while (watermark < range_count) {
+        {
+            std::unique_lock<std::mutex> lock(done_mutex);
+            range_finished.wait_for(lock, std::chrono::milliseconds(200), [&]() { return range_done[watermark]; });
+            for (; watermark < range_count && range_done[watermark]; ++watermark) {
+                hits.insert(hits.end(), std::make_move_iterator(range_hits[watermark].begin()),
+                            std::make_move_iterator(range_hits[watermark].end()));
+                std::vector<ScanHit>().swap(range_hits[watermark]);
+            }
+        }
+        report_progress(file_size > 0 ? 100.0 * scanned_bytes / file_size : 100.0);
+        
+        // Empates mantêm a ordem de detecção, pois hits com o mesmo offset vêm sempre da mesma faixa
+        std::stable_sort(hits.begin(), hits.end(), [](const ScanHit& a, const ScanHit& b) {
+            return a.file.start_offset < b.file.start_offset;
+        });
+        emit_hits(hits, gap_carver.get(), carved, extraction.get());
+    }
+    pool.wait();
+    
+    report_progress(100.0);
+    bytes_processed_ += scanned_bytes;
+    if (classify) {
+        finish_block_survey(worker_surveys);
+    }
+    
+    if (extraction) {
+        extraction->drain();
+    }
 }
 
-bool FileCarver::generate_report(const std::string& output_file) const {
-    std::ofstream report(output_file);
-    if (!report.is_open()) {
-        std::cerr << "Erro ao criar relatório: " << output_file << std::endl;
-        return false;
+void FileCarver::emit_hits(std::vector<ScanHit>& hits, GapCarver* gap_carver, IntervalIndex& carved,
+                           ExtractionQueue* extraction) {
+    if (gap_carver) {
+        carve_gaps(*gap_carver, hits);
     }
+    classify_nested(carved, hits);
     
-    report << "=== RELATÓRIO DE FILE CARVING ===" << std::endl;
-    report << "Data: " << std::chrono::system_clock::now().time_since_epoch().count() << std::endl;
-    report << "Arquivos encontrados: " << files_found_ << std::endl;
-    report << "Arquivos extraídos: " << files_extracted_ << std::endl;
-    report << "Bytes processados: " << bytes_processed_ << std::endl;
-    report << std::endl;
+    // Nomes atribuídos em ordem de offset são estáveis entre execuções
+    for (auto& hit : hits) {
+        hit.file.filename = generate_unique_filename(hit.signature->name, hit.signature->extension);
+        if (extraction) {
+            extraction->submit(std::move(hit.file));
+            continue;
+        }
+        if (hashing_enabled() && hash_before_extract()) {
+            hash_file(hit.file, *chunk_reader_);
+            claim_content(hit.file, *chunk_reader_);
+        }
+        if (extract_files_) {
+            hit.file.extracted = extract_file(hit.file, *chunk_reader_);
+        }
+        if (hashing_enabled() && !hash_before_extract()) {
+            claim_content(hit.file, *chunk_reader_);
+        }
+        link_duplicate(hit.file);
+        record_carved_file(hit.file);
+    }
+    hits.clear();
+}
+
+std::unique_ptr<ExtractionQueue> FileCarver::make_extraction_queue(const std::string& input_file,
+                                                                   std::vector<std::unique_ptr<ChunkReader>>& readers) {
+    if (!(extract_files_ || hashing_enabled()) || extraction_writers_ == 0) {
+        return nullptr;
+    }
     
-    report << "DETALHES DOS ARQUIVOS:" << std::endl;
-    report << std::string(80, '-') << std::endl;
+    std::vector<ChunkReader*> reader_views;
+    for (size_t i = 0; i < extraction_writers_; ++i) {
+        readers.push_back(open_worker_reader(input_file, false));
+        reader_views.push_back(readers.back().get());
+    }
+    ExtractionQueue::Prepare prepare;
+    ExtractionQueue::Claim claim;
+    bool claim_on_retire = hashing_enabled() && !hash_before_extract();
+    if (hashing_enabled() && hash_before_extract()) {
+        prepare = [this](CarvedFile& file, ChunkReader& reader) { hash_file(file, reader); };
+        claim = [this](CarvedFile& file, ChunkReader& reader) { claim_content(file, reader); };
+    }
+    // O retire roda em ordem na thread do varredor, que usa o leitor principal
+    return std::make_unique<ExtractionQueue>(
+        reader_views, extraction_queue_depth_,
+        [this](CarvedFile& file, ChunkReader& reader) { return extract_files_ && extract_file(file, reader); },
+        [this, claim_on_retire](CarvedFile& file) {
+            if (claim_on_retire) {
+                claim_content(file, *chunk_reader_);
+            }
+            link_duplicate(file);
+            record_carved_file(file);
+        },
+        prepare, claim);
+}
+
+std::unique_ptr<ChunkReader> FileCarver::open_worker_reader(const std::string& input_file, bool read_ahead) const {
+    auto reader = std::make_unique<ChunkReader>(chunk_reader_->get_chunk_size(), chunk_reader_->get_overlap_size());
+    reader->set_verbose(false);
+    reader->set_backend(chunk_reader_->get_backend());
+    reader->set_io_depth(read_ahead ? chunk_reader_->get_io_depth() : 0);
+    reader->set_huge_pages(chunk_reader_->get_huge_pages());
+    if (!reader->open(input_file)) {
+        throw std::runtime_error("não foi possível abrir " + input_file + " para leitura paralela");
+    }
+    return reader;
+}
+
+void FileCarver::scan_range(ChunkReader& reader, size_t range_begin, size_t range_end,
+                            const std::vector<std::string>& file_types, BlockSurvey* survey,
+                            std::vector<ScanHit>& hits) const {
+    // Lê até cobrir por inteiro qualquer cabeçalho iniciado antes de range_end
+    size_t stop = std::min(reader.get_file_size(), range_end + signature_detector_->get_max_header_length());
     
-    for (const auto& file : carved_files_) {
-        report << "Arquivo: " << file.filename << std::endl;
-        report << "  Tipo: " << file.type << std::endl;
-        report << "  Offset inicial: 0x" << std::hex << file.start_offset << std::dec 
-               << " (" << file.start_offset << ")" << std::endl;
-        report << "  Offset final: 0x" << std::hex << file.end_offset << std::dec 
-               << " (" << file.end_offset << ")" << std::endl;
-        report << "  Tamanho: " << file.file_size << " bytes" << std::endl;
-        report << "  Footer válido: " << (file.has_valid_footer ? "Sim" : "Não") << std::endl;
-        report << "  Extraído: " << (file.extracted ? "Sim" : "Não") << std::endl;
-        report << std::endl;
+    ChunkView chunk;
+    LengthResolver resolver(reader, search_window_);
+    FooterTracker tracker(*signature_detector_, search_window_, reader.get_file_size(),
+                          use_structure_ ? &resolver : nullptr);
+    
+    // Sem índice: a faixa não sabe quais arquivos serão aceitos (isso só se
+    // decide na emissão, em ordem de offset), então é varrida inteira
+    reader.seek(range_begin);
+    size_t claimed = range_begin;
+    size_t resumed = reader.get_file_size();    // Primeiro chunk além da faixa
+    if (survey) {
+        start_block_survey(*survey, range_begin);
+    }
+    while (reader.read_chunk_view(chunk)) {
+        if (chunk.offset < range_end) {
+            size_t claim_end = std::min(range_end, header_claim_end(chunk, reader));
+            process_chunk(tracker, chunk.data, chunk.size, chunk.offset, claimed, claim_end, file_types,
+                          nullptr, survey, hits);
+            claimed = std::max(claimed, claim_end);
+        } else {
+            // Além da faixa só interessam os footers dos candidatos ainda abertos
+            resumed = std::min(resumed, chunk.offset);
+            tracker.feed(chunk.data, chunk.size, chunk.offset);
+            collect_resolved(tracker, hits);
+        }
+        
+        if (chunk.offset + chunk.size >= stop && !tracker.has_open()) break;
     }
     
-    report.close();
-    std::cout << "Relatório salvo em: " << output_file << std::endl;
-    return true;
+    if (survey) {
+        close_block_survey(*survey, range_end, resumed);
+    }
+    
+    tracker.finish();
+    collect_resolved(tracker, hits);
 }
 
-bool FileCarver::generate_csv_report(const std::string& output_file) const {
-    std::ofstream csv(output_file);
-    if (!csv.is_open()) {
-        std::cerr << "Erro ao criar relatório CSV: " << output_file << std::endl;
-        return false;
+void FileCarver::record_carved_file(const CarvedFile& carved_file) {
+    // Arquivos conhecidos só entram na contagem de descartados
+    if (carved_file.known) {
+        files_known_++;
+        return;
     }
     
-    // Cabeçalho CSV
-    csv << "Arquivo,Tipo,Offset_Inicial,Offset_Final,Tamanho,Footer_Valido,Extraido" << std::endl;
+    if (carved_file.extracted) {
+        files_extracted_++;
+    }
     
-    for (const auto& file : carved_files_) {
-        csv << file.filename << ","
-            << file.type << ","
-            << file.start_offset << ","
-            << file.end_offset << ","
-            << file.file_size << ","
-            << (file.has_valid_footer ? "Sim" : "Nao") << ","
-            << (file.extracted ? "Sim" : "Nao") << std::endl;
+    if (!carved_file.duplicate_of.empty()) {
+        files_duplicated_++;
     }
     
-    csv.close();
-    std::cout << "Relatório CSV salvo em: " << output_file << std::endl;
-    return true;
+    files_found_++;
+    TypeTotals& totals = type_totals_[carved_file.type];
+    totals.count++;
+    totals.bytes += carved_file.file_size;
+    
+    for (auto& sink : result_sinks_) {
+        sink->add(carved_file);
+    }
+    
+    std::cout << "Encontrado: " << carved_file.type 
+              << " em offset 0x" << std::hex << carved_file.start_offset << std::dec
+              << " (" << carved_file.file_size << " bytes)";
+    if (!carved_file.duplicate_of.empty()) {
+        std::cout << " - duplicado de " << carved_file.duplicate_of;
+    }
+    std::cout << std::endl;
+}
+
+void FileCarver::report_progress(double progress) {
+    update_progress(progress);
+    
+    // Exibe progresso a cada 5%
+    int current_progress = static_cast<int>(progress / 5) * 5;
+    if (current_progress != last_progress_step_) {
+        std::cout << "Progresso: " << current_progress << "%" << std::endl;
+        last_progress_step_ = current_progress;
+    }
+}
+
+void FileCarver::add_result_sink(std::unique_ptr<ResultSink> sink) {
+    if (sink) {
+        result_sinks_.push_back(std::move(sink));
+    }
+}
+
+const std::map<std::string, TypeTotals>& FileCarver::get_type_totals() const {
+    return type_totals_;
+}
+
+void FileCarver::finish_result_sinks() {
+    CarvingSummary summary;
+    summary.files_found = files_found_;
+    summary.files_extracted = files_extracted_;
+    summary.bytes_processed = bytes_processed_;
+    summary.types = type_totals_;
+    summary.blocks_classified = classifying_blocks();
+    summary.blocks = block_totals_;
+    
+    for (auto& sink : result_sinks_) {
+        sink->finish(summary);
+    }
+    result_sinks_.clear();
+}
+
+void FileCarver::get_statistics(size_t& files_found, size_t& files_extracted, size_t& bytes_processed) const {
+    files_found = files_found_;
+    files_extracted = files_extracted_;
+    bytes_processed = bytes_processed_;
 }
 
 void FileCarver::clear_results() {
-    carved_files_.clear();
+    type_totals_.clear();
+    block_totals_ = BlockTotals();
+    filename_counters_.clear();
+    content_index_.clear();
+    link_targets_.clear();
+    last_progress_step_ = -1;
     files_found_ = 0;
     files_extracted_ = 0;
+    files_duplicated_ = 0;
+    files_known_ = 0;
     bytes_processed_ = 0;
 }
 
-void FileCarver::process_chunk(const std::vector<uint8_t>& data, size_t chunk_size, 
-                              size_t file_offset, const std::vector<std::string>& file_types) {
+void FileCarver::process_chunk(FooterTracker& tracker, const uint8_t* data, size_t chunk_size,
+                              size_t file_offset, size_t owned_begin, size_t owned_end,
+                              const std::vector<std::string>& file_types, const IntervalIndex* carved,
+                              BlockSurvey* survey, std::vector<ScanHit>& hits) const {
     
-    for (size_t i = 0; i <= chunk_size - 4; ++i) { // Assume mínimo de 4 bytes para header
-        const FileSignature* signature = signature_detector_->detect_header(data.data() + i, chunk_size - i);
-        
-        if (!signature) continue;
+    // Footers dos candidatos de chunks anteriores são procurados neste mesmo chunk
+    tracker.feed(data, chunk_size, file_offset);
+    
+    // Blocos zerados, uniformes ou de alta entropia (se pedido) ficam fora da busca de cabeçalhos
+    std::vector<std::pair<size_t, size_t>> skipped;
+    if (survey) {
+        classify_blocks(data, chunk_size, file_offset, owned_end, *survey, skipped);
+    }
+    size_t next_skipped = 0;
+    
+    const auto& signatures = signature_detector_->get_signatures();
+    const size_t chunk_end = file_offset + chunk_size;
+    const size_t header_tail = signature_detector_->get_max_header_length() > 0
+                             ? signature_detector_->get_max_header_length() - 1 : 0;
+    
+    // Sem índice o chunk é uma única fatia; com ele, as regiões de arquivos
+    // já aceitos ficam de fora e a busca salta direto para depois delas.
+    // Só entram no índice arquivos aceitos por classify_nested: um candidato
+    // recém-delimitado ainda pode ser descartado (contido em outro arquivo
+    // pendente), e pular a região dele esconderia cabeçalhos que valem,
+    // conforme o tamanho do chunk
+    size_t position = std::max(file_offset, owned_begin);
+    const size_t limit = std::min(chunk_end, owned_end);
+    std::vector<HeaderMatch> matches;
+    
+    while (position < limit) {
+        size_t slice_end = limit;
+        if (carved) {
+            position = carved->skip_covered(position);
+            if (position >= limit) break;
+            // O início da próxima região ainda é varrido (outro formato no mesmo offset)
+            size_t next = carved->next_region(position);
+            if (next != SIZE_MAX && next < slice_end) slice_end = next + 1;
+        }
         
-        // Verifica se deve processar este tipo de arquivo
-        if (!file_types.empty()) {
-            bool found = std::find(file_types.begin(), file_types.end(), signature->name) != file_types.end();
-            if (!found) continue;
+        while (next_skipped < skipped.size() && skipped[next_skipped].second <= position) {
+            next_skipped++;
+        }
+        if (next_skipped < skipped.size()) {
+            if (skipped[next_skipped].first <= position) {
+                position = skipped[next_skipped].second;
+                continue;
+            }
+            slice_end = std::min(slice_end, skipped[next_skipped].first);
         }
         
-        size_t start_offset = file_offset + i;
-        size_t end_offset = start_offset;
-        bool has_valid_footer = false;
+        // Uma única passada do autômato reporta todos os cabeçalhos da fatia,
+        // inclusive os que compartilham o mesmo offset (ex: ZIP e DOCX)
+        size_t relative = position - file_offset;
+        size_t scan_size = carved || !skipped.empty()
+                         ? std::min(chunk_size - relative, slice_end - position + header_tail)
+                         : chunk_size - relative;
+        matches.clear();
+        find_headers(data + relative, scan_size, position, matches);
         
-        // Busca por footer se disponível e habilitado
-        if (use_footers_ && signature->has_footer) {
-            size_t footer_pos = find_footer(start_offset, signature, search_window_);
-            if (footer_pos != SIZE_MAX) {
-                end_offset = footer_pos + signature->footer.size();
-                has_valid_footer = true;
-            } else {
-                // Se não encontrou footer, estima tamanho baseado na janela de busca
-                end_offset = start_offset + search_window_;
+        for (const auto& match : matches) {
+            const FileSignature* signature = &signatures[match.pattern_id];
+            size_t start_offset = position + match.offset;
+            
+            // Cabeçalhos fora da faixa pertencem a outra tarefa de varredura (ou a outro chunk)
+            if (start_offset < owned_begin || start_offset >= slice_end) continue;
+            
+            // Verifica se deve processar este tipo de arquivo
+            if (!file_types.empty()) {
+                bool found = std::any_of(file_types.begin(), file_types.end(), [signature](const std::string& type) {
+                    return same_signature_name(type, signature->name);
+                });
+                if (!found) continue;
             }
-        } else {
-            // Se não usa footers, estima tamanho baseado na janela de busca
-            end_offset = start_offset + search_window_;
+            
+            tracker.open(signature, start_offset, use_footers_);
         }
         
-        // Garante que não ultrapasse o tamanho do arquivo
-        if (end_offset > chunk_reader_->get_file_size()) {
-            end_offset = chunk_reader_->get_file_size();
+        position = slice_end;
+    }
+    
+    collect_resolved(tracker, hits);
+}
+
+void FileCarver::classify_blocks(const uint8_t* data, size_t chunk_size, size_t file_offset,
+                                 size_t owned_end, BlockSurvey& survey,
+                                 std::vector<std::pair<size_t, size_t>>& skipped) const {
+    const size_t block = block_classifier_.get_block_size();
+    const size_t chunk_end = file_offset + chunk_size;
+    const size_t header_tail = signature_detector_->get_max_header_length() > 0
+                             ? signature_detector_->get_max_header_length() - 1 : 0;
+    
+    // Um bloco que passou do fim do chunk anterior é contado neste, que o contém
+    // inteiro (no overlap); por isso a contagem segue next_block, não owned_begin
+    size_t position = first_block_at(file_offset);
+    for (; position + block <= chunk_end; position += block) {
+        BlockClass type = block_classifier_.classify(data + (position - file_offset));
+        if (position >= survey.next_block && position < owned_end) {
+            fill_block_gap(survey, position, file_offset, data, std::min(chunk_size, block));
+            record_blocks(survey, position, position + block, type);
         }
         
-        size_t file_size = end_offset - start_offset;
+        bool skip = type == BlockClass::HIGH_ENTROPY ? skip_entropy_blocks_
+                  : type != BlockClass::DATA ? skip_uniform_blocks_ : false;
+        if (!skip) continue;
+        if (!skipped.empty() && skipped.back().second == position) {
+            skipped.back().second = position + block;
+        } else {
+            skipped.emplace_back(position, position + block);
+        }
+    }
+    
+    // O bloco incompleto no fim do arquivo não é classificado
+    if (owned_end == SIZE_MAX && position < chunk_end) {
+        fill_block_gap(survey, position, file_offset, data, std::min(chunk_size, block));
+        record_blocks(survey, position, position + block, BlockClass::DATA);
+    }
+    
+    // Zeros no fim do chunk: se o leitor saltar um buraco a seguir, continuam nele
+    size_t tail = 0;
+    while (tail < std::min(chunk_size, block) && data[chunk_size - tail - 1] == 0) {
+        tail++;
+    }
+    survey.read_end = chunk_end;
+    survey.zero_tail = tail;
+    
+    for (auto& region : skipped) {
+        region.second -= std::min(header_tail, region.second - region.first);
+    }
+}
+
+size_t FileCarver::first_block_at(size_t offset) const {
+    // Blocos alinhados à mesma base dos cabeçalhos (início da partição)
+    const size_t block = block_classifier_.get_block_size();
+    size_t phase = block_size_ > 1 ? block_offset_ % block : 0;
+    return offset + (phase + block - offset % block) % block;
+}
+
+void FileCarver::record_blocks(BlockSurvey& survey, size_t begin, size_t end, BlockClass type) const {
+    if (begin >= end) {
+        return;
+    }
+    
+    const size_t block = block_classifier_.get_block_size();
+    size_t count = (end - begin + block - 1) / block;
+    switch (type) {
+        case BlockClass::ZERO: survey.totals.zero += count; break;
+        case BlockClass::UNIFORM: survey.totals.uniform += count; break;
+        case BlockClass::HIGH_ENTROPY: survey.totals.high_entropy += count; break;
+        default: survey.totals.data += count; break;
+    }
+    survey.next_block = begin + count * block;
+    
+    if (block_map_file_.empty()) return;
+    if (!survey.runs.empty() && survey.runs.back().end == begin && survey.runs.back().type == type) {
+        survey.runs.back().end = survey.next_block;
+    } else {
+        survey.runs.push_back({begin, survey.next_block, type});
+    }
+}
+
+void FileCarver::fill_block_gap(BlockSurvey& survey, size_t end, size_t resumed,
+                                const uint8_t* data, size_t size) const {
+    if (survey.next_block >= end) {
+        return;
+    }
+    
+    // Sem salto, os blocos pendentes cruzam chunks sem caber em nenhum: ficam como dados
+    size_t zeros_begin = 0;
+    size_t zeros_end = 0;
+    if (resumed > survey.read_end) {
+        // O buraco saltado, somado aos zeros que o cercam nos chunks lidos
+        size_t head = 0;
+        while (head < size && data[head] == 0) {
+            head++;
+        }
+        zeros_begin = survey.read_end - survey.zero_tail;
+        zeros_end = resumed + head;
+    }
+    
+    const size_t block = block_classifier_.get_block_size();
+    size_t zero_begin = std::min(end, std::max(survey.next_block, first_block_at(zeros_begin)));
+    size_t zero_end = zero_begin;
+    if (zeros_end > zero_begin) {
+        zero_end = std::min(end, zero_begin + (zeros_end - zero_begin) / block * block);
+    }
+    record_blocks(survey, survey.next_block, zero_begin, BlockClass::DATA);
+    record_blocks(survey, zero_begin, zero_end, BlockClass::ZERO);
+    record_blocks(survey, zero_end, end, BlockClass::DATA);
+}
+
+void FileCarver::start_block_survey(BlockSurvey& survey, size_t begin) const {
+    survey.next_block = first_block_at(begin);
+    survey.read_end = begin;
+    survey.zero_tail = 0;
+}
+
+void FileCarver::close_block_survey(BlockSurvey& survey, size_t end, size_t resumed) const {
+    if (survey.next_block >= end) {
+        return;
+    }
+    
+    // Todos os blocos com início na faixa; o último do arquivo, incompleto, fica como dados
+    const size_t block = block_classifier_.get_block_size();
+    size_t stop = survey.next_block + (end - survey.next_block + block - 1) / block * block;
+    fill_block_gap(survey, stop, std::min(resumed, chunk_reader_->get_file_size()), nullptr, 0);
+}
+
+void FileCarver::finish_block_survey(std::vector<BlockSurvey>& surveys) {
+    std::vector<BlockRun> runs;
+    for (auto& survey : surveys) {
+        block_totals_.data += survey.totals.data;
+        block_totals_.zero += survey.totals.zero;
+        block_totals_.uniform += survey.totals.uniform;
+        block_totals_.high_entropy += survey.totals.high_entropy;
+        runs.insert(runs.end(), survey.runs.begin(), survey.runs.end());
+        survey.runs.clear();
+    }
+    
+    std::cout << "Blocos de " << block_classifier_.get_block_size() << " bytes: "
+              << block_totals_.data << " dados, " << block_totals_.zero << " zerados, "
+              << block_totals_.uniform << " uniformes, " << block_totals_.high_entropy << " alta entropia"
+              << std::endl;
+    
+    if (block_map_file_.empty()) {
+        return;
+    }
+    
+    // Faixas de workers diferentes chegam fora de ordem e podem continuar umas às outras
+    std::sort(runs.begin(), runs.end(), [](const BlockRun& a, const BlockRun& b) { return a.begin < b.begin; });
+    if (!runs.empty()) {
+        runs.back().end = std::min(runs.back().end, chunk_reader_->get_file_size());
+    }
+    size_t merged = 0;
+    for (size_t i = 0; i < runs.size(); ++i) {
+        if (merged > 0 && runs[merged - 1].end == runs[i].begin && runs[merged - 1].type == runs[i].type) {
+            runs[merged - 1].end = runs[i].end;
+        } else {
+            runs[merged++] = runs[i];
+        }
+    }
+    runs.resize(merged);
+    
+    if (write_block_map(block_map_file_, runs)) {
+        std::cout << "Mapa de blocos gravado em: " << block_map_file_ << std::endl;
+    }
+}
+
+bool FileCarver::classifying_blocks() const {
+    return skip_uniform_blocks_ || skip_entropy_blocks_ || !block_map_file_.empty();
+}
+
+size_t FileCarver::header_claim_end(const ChunkView& chunk, const ChunkReader& reader) const {
+    size_t chunk_end = chunk.offset + chunk.size;
+    if (chunk_end >= reader.get_file_size()) {
+        return SIZE_MAX;
+    }
+    
+    // O próximo chunk começa overlap bytes antes do fim: com overlap menor que
+    // o maior cabeçalho, os offsets entre os dois continuam com este chunk
+    size_t reserved = signature_detector_->get_max_header_length();
+    reserved = std::min({chunk.size, reader.get_overlap_size(), reserved > 0 ? reserved - 1 : 0});
+    return chunk_end - reserved;
+}
+
+void FileCarver::find_headers(const uint8_t* data, size_t chunk_size, size_t file_offset,
+                              std::vector<HeaderMatch>& matches) const {
+    if (block_size_ == 0) {
+        signature_detector_->scan_headers(data, chunk_size, matches);
+        return;
+    }
+    
+    // Primeiro offset do chunk congruente à base do alinhamento
+    size_t phase = block_offset_ % block_size_;
+    size_t first = (phase + block_size_ - file_offset % block_size_) % block_size_;
+    signature_detector_->scan_headers_aligned(data, chunk_size, first, block_size_, matches);
+    
+    if (unaligned_regions_.empty()) {
+        return;
+    }
+    
+    // Regiões indicadas pelo usuário são varridas em todos os offsets; a fatia
+    // se estende além do fim da região para confirmar cabeçalhos que começam nela
+    const size_t header_tail = std::max<size_t>(signature_detector_->get_max_header_length(), 1) - 1;
+    const size_t chunk_end = file_offset + chunk_size;
+    std::vector<HeaderMatch> region_matches;
+    bool merged = false;
+    
+    for (const auto& region : unaligned_regions_) {
+        size_t begin = std::max(region.first, file_offset);
+        size_t end = std::min(region.second, chunk_end);
+        if (begin >= end) continue;
+        
+        size_t slice_begin = begin - file_offset;
+        size_t slice_end = std::min(chunk_size, end - file_offset + header_tail);
+        signature_detector_->scan_headers(data + slice_begin, slice_end - slice_begin, region_matches);
         
-        // Valida tamanho mínimo
-        if (file_size < min_file_size_) continue;
+        for (const auto& match : region_matches) {
+            size_t offset = slice_begin + match.offset;
+            if (file_offset + offset >= end) continue;
+            matches.push_back({offset, match.pattern_id});
+            merged = true;
+        }
+    }
+    
+    if (merged) {
+        // Offsets alinhados dentro das regiões aparecem nas duas buscas
+        std::sort(matches.begin(), matches.end(), [](const HeaderMatch& a, const HeaderMatch& b) {
+            return a.offset != b.offset ? a.offset < b.offset : a.pattern_id < b.pattern_id;
+        });
+        matches.erase(std::unique(matches.begin(), matches.end(), [](const HeaderMatch& a, const HeaderMatch& b) {
+            return a.offset == b.offset && a.pattern_id == b.pattern_id;
+        }), matches.end());
+    }
+}
+
+void FileCarver::collect_resolved(FooterTracker& tracker, std::vector<ScanHit>& hits) const {
+    std::vector<FooterCandidate> resolved;
+    tracker.take_resolved(resolved);
+    
+    for (const auto& candidate : resolved) {
+        size_t file_size = candidate.end_offset - candidate.start_offset;
         
-        // Valida tamanho máximo
-        if (max_file_size_ > 0 && file_size > max_file_size_) continue;
+        // Candidatos a dois fragmentos só são filtrados depois da busca do segundo fragmento
+        bool gap_candidate = bifragment_ && candidate.structure_failure != 0;
+        if (!gap_candidate && !within_size_limits(candidate.signature, file_size)) {
+            continue;
+        }
         
         // Cria entrada do arquivo carved
-        CarvedFile carved_file;
-        carved_file.type = signature->name;
-        carved_file.start_offset = start_offset;
-        carved_file.end_offset = end_offset;
-        carved_file.file_size = file_size;
-        carved_file.has_valid_footer = has_valid_footer;
-        carved_file.extracted = false;
+        ScanHit hit;
+        hit.signature = candidate.signature;
+        hit.file.type = candidate.signature->name;
+        hit.file.start_offset = candidate.start_offset;
+        hit.file.end_offset = candidate.end_offset;
+        hit.file.file_size = file_size;
+        hit.file.has_valid_footer = candidate.has_valid_footer;
+        hit.file.structure_resolved = candidate.structure_resolved;
+        hit.file.extracted = false;
+        hit.file.parent_offset = SIZE_MAX;
+        hit.structure_failure = gap_candidate ? candidate.structure_failure : 0;
+        hit.structure_verified = candidate.structure_verified;
+        
+        if (validate_carved_file(hit.file)) {
+            hits.push_back(hit);
+        }
+    }
+}
+
+bool FileCarver::within_size_limits(const FileSignature* signature, size_t file_size) const {
+    if (file_size < min_file_size_) return false;
+    if (max_file_size_ > 0 && file_size > max_file_size_) return false;
+    return signature->max_size == 0 || file_size <= signature->max_size;
+}
+
+void FileCarver::classify_nested(IntervalIndex& carved, std::vector<ScanHit>& hits) const {
+    size_t kept = 0;
+    for (size_t i = 0; i < hits.size(); ++i) {
+        ScanHit& hit = hits[i];
+        
+        size_t owner;
+        if (carved.find_enclosing(hit.file.start_offset, owner)) {
+            if (skip_carved_) continue;
+            hit.file.parent_offset = owner;
+        }
         
-        // Gera nome único para o arquivo
-        carved_file.filename = generate_unique_filename(signature->name, signature->extension);
+        // Só regiões com fim confirmado: um fim dado pela janela não delimita nada
+        if (hit.file.has_valid_footer) {
+            if (hit.file.fragments.empty()) {
+                carved.insert(hit.file.start_offset, hit.file.end_offset, hit.file.start_offset);
+            } else {
+                for (const auto& fragment : hit.file.fragments) {
+                    carved.insert(fragment.first, fragment.second, hit.file.start_offset);
+                }
+            }
+        }
         
-        // Valida e extrai arquivo se necessário
-        if (validate_carved_file(carved_file)) {
-            if (extract_files_) {
-                carved_file.extracted = extract_file(carved_file);
-                if (carved_file.extracted) {
-                    files_extracted_++;
+        if (kept != i) {
+            hits[kept] = std::move(hit);
+        }
+        kept++;
+    }
+    hits.resize(kept);
+}
+
+void FileCarver::carve_gaps(GapCarver& gap_carver, std::vector<ScanHit>& hits) const {
+    size_t kept = 0;
+    for (size_t i = 0; i < hits.size(); ++i) {
+        ScanHit& hit = hits[i];
+        if (hit.structure_failure != 0) {
+            std::vector<std::pair<size_t, size_t>> fragments;
+            if (gap_carver.carve(hit.signature, hit.file.start_offset, hit.structure_verified,
+                                 hit.structure_failure, fragments)) {
+                hit.file.file_size = 0;
+                for (const auto& fragment : fragments) {
+                    hit.file.file_size += fragment.second - fragment.first;
                 }
+                hit.file.end_offset = fragments.back().second;
+                hit.file.has_valid_footer = true;
+                hit.file.structure_resolved = true;
+                hit.file.fragments = std::move(fragments);
             }
+            hit.structure_failure = 0;
             
-            carved_files_.push_back(carved_file);
-            files_found_++;
-            
-            std::cout << "Encontrado: " << signature->name 
-                      << " em offset 0x" << std::hex << start_offset << std::dec
-                      << " (" << file_size << " bytes)" << std::endl;
+            if (!within_size_limits(hit.signature, hit.file.file_size)) continue;
+        }
+        if (kept != i) {
+            hits[kept] = std::move(hit);
         }
+        kept++;
     }
+    hits.resize(kept);
 }
 
-size_t FileCarver::find_footer(size_t start_offset, const FileSignature* signature, size_t max_search_size) {
-    if (!signature || !signature->has_footer) {
-        return SIZE_MAX;
+std::unique_ptr<GapCarver> FileCarver::make_gap_carver(const std::string& input_file, std::unique_ptr<ThreadPool>& pool,
+                                                       std::vector<std::unique_ptr<ChunkReader>>& readers) const {
+    if (!bifragment_ || !use_structure_) {
+        return nullptr;
     }
     
-    std::vector<uint8_t> search_data;
-    size_t actual_size = chunk_reader_->read_at_position(start_offset, max_search_size, search_data);
+    pool = std::make_unique<ThreadPool>(ThreadPool::resolve_thread_count(0));
+    std::vector<ChunkReader*> reader_views;
+    for (size_t i = 0; i < pool->size(); ++i) {
+        readers.push_back(open_worker_reader(input_file, false));
+        reader_views.push_back(readers.back().get());
+    }
     
-    if (actual_size == 0) {
-        return SIZE_MAX;
+    // Sem alinhamento informado, assume clusters de 4KB a partir do início da imagem
+    size_t cluster_size = block_size_ > 1 ? block_size_ : 4096;
+    return std::make_unique<GapCarver>(*signature_detector_, *pool, reader_views, cluster_size,
+                                       block_size_ > 1 ? block_offset_ : 0, max_gap_, search_window_);
+}
+
+bool FileCarver::extract_file(CarvedFile& carved_file, ChunkReader& reader) const {
+    // Duplicatas não são gravadas (com LINK, link_duplicate cria o hard link depois),
+    // nem arquivos conhecidos
+    if (carved_file.known || (!carved_file.duplicate_of.empty() && dedup_mode_ != DedupMode::NONE)) {
+        return false;
     }
     
-    size_t footer_pos = signature_detector_->find_pattern(search_data.data(), actual_size, signature->footer);
+    std::string output_path = output_directory_ + "/" + carved_file.filename;
+    
+    // Sem decisão pendente sobre o conteúdo, o hash é feito sobre os blocos
+    // copiados, sem ler o arquivo uma segunda vez
+    bool hash_while_copying = hashing_enabled() && !hash_before_extract();
+    Xxh3 xxh;
+    Sha256 sha;
+    ChunkReader::CopyObserver observer;
+    if (hash_while_copying) {
+        observer = [&](const uint8_t* data, size_t length) {
+            xxh.update(data, length);
+            if (hash_sha256_) {
+                sha.update(data, length);
+            }
+        };
+    }
     
-    if (footer_pos != SIZE_MAX) {
-        return start_offset + footer_pos;
+    // A cópia é feita pelo kernel sempre que possível, sem buffer do tamanho do arquivo
+    size_t bytes_copied = 0;
+    if (carved_file.fragments.empty()) {
+        bytes_copied = reader.copy_range(carved_file.start_offset, carved_file.file_size, output_path, false, observer);
+    } else {
+        for (size_t i = 0; i < carved_file.fragments.size(); ++i) {
+            const auto& fragment = carved_file.fragments[i];
+            size_t size = fragment.second - fragment.first;
+            if (reader.copy_range(fragment.first, size, output_path, i > 0, observer) != size) {
+                bytes_copied = 0;
+                break;
+            }
+            bytes_copied += size;
+        }
+    }
+    
+    // Se a cópia não foi até o fim, o hash é refeito com uma leitura própria:
+    // ele não depende de o arquivo ter sido gravado
+    if (hash_while_copying) {
+        if (bytes_copied == carved_file.file_size) {
+            store_hashes(carved_file, xxh, sha);
+        } else {
+            hash_file(carved_file, reader);
+        }
+    }
+    
+    if (bytes_copied == 0) {
+        std::error_code error;
+        fs::remove(output_path, error);
+        return false;
     }
     
-    return SIZE_MAX;
+    return true;
 }
 
-bool FileCarver::extract_file(CarvedFile& carved_file) {
-    std::string output_path = output_directory_ + "/" + carved_file.filename;
+void FileCarver::hash_file(CarvedFile& carved_file, ChunkReader& reader) const {
+    const size_t HASH_BLOCK_SIZE = 1024 * 1024;
     
-    std::ofstream output(output_path, std::ios::binary);
-    if (!output.is_open()) {
-        std::cerr << "Erro ao criar arquivo: " << output_path << std::endl;
-        return false;
+    Xxh3 xxh;
+    Sha256 sha;
+    auto hash_range = [&](size_t position, size_t size) {
+        ChunkView view;
+        while (size > 0) {
+            size_t length = reader.view_at_position(position, std::min(size, HASH_BLOCK_SIZE), view);
+            if (length == 0) {
+                return false;
+            }
+            xxh.update(view.data, length);
+            if (hash_sha256_) {
+                sha.update(view.data, length);
+            }
+            position += length;
+            size -= length;
+        }
+        return true;
+    };
+    
+    // Mesmos bytes, na mesma ordem, que extract_file grava
+    if (carved_file.fragments.empty()) {
+        if (!hash_range(carved_file.start_offset, carved_file.file_size)) return;
+    } else {
+        for (const auto& fragment : carved_file.fragments) {
+            if (!hash_range(fragment.first, fragment.second - fragment.first)) return;
+        }
     }
     
-    std::vector<uint8_t> file_data;
-    size_t bytes_read = chunk_reader_->read_at_position(carved_file.start_offset, 
-                                                       carved_file.file_size, file_data);
+    store_hashes(carved_file, xxh, sha);
+}
+
+void FileCarver::store_hashes(CarvedFile& carved_file, const Xxh3& xxh, const Sha256& sha) const {
+    carved_file.content_hash = xxh.digest();
+    if (hash_sha256_) {
+        Sha256Digest digest = sha.digest();
+        carved_file.sha256 = format_sha256(digest);
+        carved_file.known = known_hashes_ && known_hashes_->contains(digest);
+    }
+    carved_file.hashed = true;
+}
+
+bool FileCarver::hashing_enabled() const {
+    return hash_files_ || known_hashes_ != nullptr;
+}
+
+bool FileCarver::hash_before_extract() const {
+    // Duplicatas e arquivos conhecidos não são gravados: o hash vem antes da cópia
+    return !extract_files_ || dedup_mode_ != DedupMode::NONE || known_hashes_ != nullptr;
+}
+
+void FileCarver::claim_content(CarvedFile& carved_file, ChunkReader& reader) {
+    if (!carved_file.hashed || carved_file.known) {
+        return;
+    }
     
-    if (bytes_read == 0) {
-        output.close();
-        fs::remove(output_path);
-        return false;
+    std::vector<std::pair<size_t, size_t>> ranges = carved_file.fragments;
+    if (ranges.empty()) {
+        ranges.emplace_back(carved_file.start_offset, carved_file.start_offset + carved_file.file_size);
     }
     
-    output.write(reinterpret_cast<const char*>(file_data.data()), bytes_read);
-    output.close();
+    // Mesma chave em conteúdos diferentes (colisão) fica como conteúdo distinto
+    auto& entries = content_index_[std::make_pair(carved_file.content_hash, carved_file.file_size)];
+    for (const auto& entry : entries) {
+        bool same = !carved_file.sha256.empty() ? entry.sha256 == carved_file.sha256
+                                                : same_content(entry.ranges, ranges, reader);
+        if (same) {
+            carved_file.duplicate_of = entry.filename;
+            return;
+        }
+    }
+    entries.push_back({carved_file.filename, carved_file.sha256, std::move(ranges)});
+}
+
+bool FileCarver::same_content(const std::vector<std::pair<size_t, size_t>>& a,
+                              const std::vector<std::pair<size_t, size_t>>& b, ChunkReader& reader) const {
+    const size_t COMPARE_BLOCK_SIZE = 1024 * 1024;
     
-    return true;
+    std::vector<uint8_t> left;
+    std::vector<uint8_t> right;
+    size_t ai = 0, bi = 0;
+    size_t a_position = a.empty() ? 0 : a[0].first;
+    size_t b_position = b.empty() ? 0 : b[0].first;
+    while (ai < a.size() && bi < b.size()) {
+        // Avança pelo menor pedaço que cabe no trecho atual de cada lado
+        size_t length = std::min({a[ai].second - a_position, b[bi].second - b_position, COMPARE_BLOCK_SIZE});
+        if (length > 0) {
+            if (reader.read_at_position(a_position, length, left) != length ||
+                reader.read_at_position(b_position, length, right) != length ||
+                std::memcmp(left.data(), right.data(), length) != 0) {
+                return false;
+            }
+        }
+        a_position += length;
+        b_position += length;
+        if (a_position == a[ai].second && ++ai < a.size()) a_position = a[ai].first;
+        if (b_position == b[bi].second && ++bi < b.size()) b_position = b[bi].first;
+    }
+    return ai == a.size() && bi == b.size();
 }
 
-std::string FileCarver::generate_unique_filename(const std::string& base_name, const std::string& extension) {
-    static std::map<std::string, int> counters;
+void FileCarver::link_duplicate(CarvedFile& carved_file) {
+    if (dedup_mode_ != DedupMode::LINK) {
+        return;
+    }
     
-    int& counter = counters[base_name];
+    if (carved_file.duplicate_of.empty()) {
+        if (carved_file.extracted) {
+            link_targets_.insert(carved_file.filename);
+        }
+        return;
+    }
+    
+    // O original foi registrado antes; se a gravação dele falhou, não há o que ligar
+    if (link_targets_.count(carved_file.duplicate_of) == 0) {
+        return;
+    }
+    
+    fs::path target = fs::path(output_directory_) / carved_file.duplicate_of;
+    fs::path link = fs::path(output_directory_) / carved_file.filename;
+    std::error_code error;
+    fs::remove(link, error);
+    fs::create_hard_link(target, link, error);
+    if (error) {
+        std::cerr << "Erro ao criar hard link: " << link.string() << " (" << error.message() << ")" << std::endl;
+        return;
+    }
+    carved_file.extracted = true;
+}
+
+std::string FileCarver::generate_unique_filename(const std::string& base_name, const std::string& extension) {
+    int& counter = filename_counters_[base_name];
     std::ostringstream oss;
     oss << base_name << "_" << std::setfill('0') << std::setw(6) << counter << extension;
     counter++;
@@ -327,7 +1242,7 @@ std::string FileCarver::generate_unique_filename(const std::string& base_name, c
     return oss.str();
 }
 
-bool FileCarver::validate_carved_file(const CarvedFile& carved_file) const {
+bool FileCarver::validate_carved_file(const CarvedFile& /*carved_file*/) const {
     // Validações básicas já foram feitas (tamanho mínimo/máximo)
     // Aqui podem ser adicionadas validações mais específicas
     
@@ -1,218 +1,319 @@
 #include "file_signature.h"
+#include "signature_cache.h"
 #include <algorithm>
+#include <cctype>
 #include <fstream>
+#include <sstream>
 #include <iostream>
+#include <map>
 
-FileSignatureDetector::FileSignatureDetector() {
+namespace {
+
+/**
+ * @brief Remove espaços nas extremidades
+ */
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return "";
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+/**
+ * @brief Chave de busca por nome: maiúsculas, para que "gif89a" ache "GIF89a"
+ */
+std::string name_key(const std::string& name) {
+    std::string key = name;
+    std::transform(key.begin(), key.end(), key.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return key;
+}
+
+/**
+ * @brief Converte bytes em hexadecimal ("FF D8 FF" ou "FFD8FF")
+ * @return false se houver dígito inválido ou número ímpar de dígitos
+ */
+bool parse_hex_bytes(const std::string& text, std::vector<uint8_t>& bytes) {
+    bytes.clear();
+    std::string digits;
+    for (char c : text) {
+        if (c == ' ' || c == '\t') continue;
+        if (!std::isxdigit(static_cast<unsigned char>(c))) return false;
+        digits += c;
+    }
+    if (digits.size() % 2 != 0) return false;
+
+    for (size_t i = 0; i < digits.size(); i += 2) {
+        bytes.push_back(static_cast<uint8_t>(std::stoul(digits.substr(i, 2), nullptr, 16)));
+    }
+    return true;
+}
+
+/**
+ * @brief Interpreta uma linha NOME;EXTENSAO;HEADER_HEX;FOOTER_HEX;MAX_SIZE;HAS_FOOTER
+ * @param line Linha sem comentário
+ * @param signature Assinatura resultante
+ * @param error Descrição do erro
+ * @return true se a linha é válida
+ */
+bool parse_signature_line(const std::string& line, FileSignature& signature, std::string& error) {
+    std::vector<std::string> fields;
+    std::stringstream ss(line);
+    std::string field;
+    while (std::getline(ss, field, ';')) {
+        fields.push_back(trim(field));
+    }
+    if (!line.empty() && line.back() == ';') {
+        fields.push_back("");
+    }
+
+    if (fields.size() != 6) {
+        error = "esperados 6 campos separados por ';', encontrados " + std::to_string(fields.size());
+        return false;
+    }
+
+    signature.name = fields[0];
+    signature.extension = fields[1];
+    if (signature.name.empty()) {
+        error = "nome vazio";
+        return false;
+    }
+    if (!signature.extension.empty() && signature.extension[0] != '.') {
+        signature.extension = "." + signature.extension;
+    }
+
+    if (!parse_hex_bytes(fields[2], signature.header) || signature.header.empty()) {
+        error = "cabeçalho hexadecimal inválido: '" + fields[2] + "'";
+        return false;
+    }
+    if (!parse_hex_bytes(fields[3], signature.footer)) {
+        error = "rodapé hexadecimal inválido: '" + fields[3] + "'";
+        return false;
+    }
+
+    try {
+        size_t used = 0;
+        signature.max_size = static_cast<size_t>(std::stoull(fields[4], &used));
+        if (used != fields[4].size()) throw std::invalid_argument(fields[4]);
+    } catch (const std::exception&) {
+        error = "tamanho máximo inválido: '" + fields[4] + "'";
+        return false;
+    }
+
+    std::string flag = fields[5];
+    std::transform(flag.begin(), flag.end(), flag.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (flag == "true" || flag == "1") {
+        signature.has_footer = true;
+    } else if (flag == "false" || flag == "0") {
+        signature.has_footer = false;
+    } else {
+        error = "HAS_FOOTER deve ser true ou false: '" + fields[5] + "'";
+        return false;
+    }
+
+    if (signature.has_footer && signature.footer.empty()) {
+        error = "HAS_FOOTER=true sem rodapé";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool same_signature_name(const std::string& a, const std::string& b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](unsigned char x, unsigned char y) {
+               return std::toupper(x) == std::toupper(y);
+           });
+}
+
+FileSignatureDetector::FileSignatureDetector()
+    : builtin_count_(0)
+    , builtin_fast_path_(false)
+    , loaded_from_cache_(false) {
     initialize_common_signatures();
+    rebuild_matcher();
 }
 
 void FileSignatureDetector::initialize_common_signatures() {
-    // JPEG
-    add_signature({
-        "JPEG",
-        ".jpg",
-        {0xFF, 0xD8, 0xFF},
-        {0xFF, 0xD9},
-        0, // sem limite de tamanho
-        true
-    });
-    
-    // PNG
-    add_signature({
-        "PNG",
-        ".png",
-        {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A},
-        {0x49, 0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60, 0x82},
-        0,
-        true
-    });
-    
-    // GIF87a
-    add_signature({
-        "GIF87a",
-        ".gif",
-        {0x47, 0x49, 0x46, 0x38, 0x37, 0x61},
-        {0x00, 0x3B},
-        0,
-        true
-    });
-    
-    // GIF89a
-    add_signature({
-        "GIF89a",
-        ".gif",
-        {0x47, 0x49, 0x46, 0x38, 0x39, 0x61},
-        {0x00, 0x3B},
-        0,
-        true
-    });
-    
-    // PDF
-    add_signature({
-        "PDF",
-        ".pdf",
-        {0x25, 0x50, 0x44, 0x46, 0x2D}, // %PDF-
-        {0x25, 0x25, 0x45, 0x4F, 0x46}, // %%EOF
-        0,
-        true
-    });
-    
-    // ZIP
-    add_signature({
-        "ZIP",
-        ".zip",
-        {0x50, 0x4B, 0x03, 0x04},
-        {0x50, 0x4B, 0x05, 0x06},
-        0,
-        true
-    });
+    for (const BuiltinSignature& builtin : BUILTIN_SIGNATURES) {
+        insert_signature({
+            builtin.name,
+            builtin.extension,
+            std::vector<uint8_t>(builtin.header, builtin.header + builtin.header_length),
+            std::vector<uint8_t>(builtin.footer, builtin.footer + builtin.footer_length),
+            builtin.max_size,
+            builtin.has_footer
+        });
+    }
+    builtin_count_ = signatures_.size();
+}
+
+void FileSignatureDetector::add_signature(const FileSignature& signature) {
+    add_signatures({signature});
+}
+
+void FileSignatureDetector::add_signatures(const std::vector<FileSignature>& signatures) {
+    if (signatures.empty()) {
+        return;
+    }
     
-    // RAR
-    add_signature({
-        "RAR",
-        ".rar",
-        {0x52, 0x61, 0x72, 0x21, 0x1A, 0x07, 0x00},
-        {},
-        0,
-        false
-    });
+    for (const auto& signature : signatures) {
+        insert_signature(signature);
+    }
+    rebuild_matcher();
+}
+
+void FileSignatureDetector::insert_signature(const FileSignature& signature) {
+    signatures_.push_back(signature);
+    name_to_index_[name_key(signature.name)] = signatures_.size() - 1;
+}
+
+void FileSignatureDetector::rebuild_matcher() {
+    std::vector<std::vector<uint8_t>> headers;
+    headers.reserve(signatures_.size());
+    for (const auto& sig : signatures_) {
+        headers.push_back(sig.header);
+    }
+    header_matcher_.build(headers);
+    rebuild_search_tables(headers);
+}
+
+void FileSignatureDetector::rebuild_search_tables(const std::vector<std::vector<uint8_t>>& headers) {
+    header_prefilter_.build(headers);
     
-    // 7-Zip
-    add_signature({
-        "7ZIP",
-        ".7z",
-        {0x37, 0x7A, 0xBC, 0xAF, 0x27, 0x1C},
-        {},
-        0,
-        false
-    });
+    // Enquanto só houver as assinaturas embutidas, a confirmação usa as
+    // tabelas de compilação; assinaturas do usuário passam pelo autômato
+    builtin_fast_path_ = signatures_.size() == builtin_count_;
     
-    // Microsoft Office (DOCX, XLSX, PPTX)
-    add_signature({
-        "DOCX",
-        ".docx",
-        {0x50, 0x4B, 0x03, 0x04, 0x14, 0x00, 0x06, 0x00},
-        {},
-        0,
-        false
-    });
+    // Tabelas de busca dos footers são montadas uma vez, não a cada busca,
+    // e compartilhadas entre assinaturas com o mesmo footer
+    std::map<std::vector<uint8_t>, uint32_t> footer_ids;
+    footer_index_.assign(signatures_.size(), NO_FOOTER);
+    for (size_t i = 0; i < signatures_.size(); ++i) {
+        const auto& footer = signatures_[i].footer;
+        if (!footer.empty()) {
+            auto it = footer_ids.emplace(footer, static_cast<uint32_t>(footer_ids.size())).first;
+            footer_index_[i] = it->second;
+        }
+    }
     
-    // MP3
-    add_signature({
-        "MP3",
-        ".mp3",
-        {0x49, 0x44, 0x33}, // ID3
-        {},
-        0,
-        false
-    });
+    structure_formats_.resize(signatures_.size());
+    for (size_t i = 0; i < signatures_.size(); ++i) {
+        structure_formats_[i] = detect_structure_format(signatures_[i].header);
+    }
     
-    // MP3 (alternativo)
-    add_signature({
-        "MP3_ALT",
-        ".mp3",
-        {0xFF, 0xFB},
-        {},
-        0,
-        false
-    });
+    footer_searchers_.clear();
+    footer_searchers_.resize(footer_ids.size());
+    for (const auto& entry : footer_ids) {
+        PatternSearcher& searcher = footer_searchers_[entry.second];
+        searcher.build(entry.first);
+        searcher.set_simd_level(header_prefilter_.get_simd_level());
+    }
+}
+
+const FileSignature* FileSignatureDetector::detect_header(const uint8_t* data, size_t size) const {
+    if (builtin_fast_path_) {
+        uint32_t mask = match_builtin_headers(data, size);
+        return mask ? &signatures_[count_trailing_zeros(mask)] : nullptr;
+    }
     
-    // MP4
-    add_signature({
-        "MP4",
-        ".mp4",
-        {0x00, 0x00, 0x00, 0x20, 0x66, 0x74, 0x79, 0x70},
-        {},
-        0,
-        false
-    });
+    std::vector<uint32_t> ids;
+    header_matcher_.match_at(data, size, ids);
+    return ids.empty() ? nullptr : &signatures_[ids.front()];
+}
+
+void FileSignatureDetector::detect_headers(const uint8_t* data, size_t size, std::vector<const FileSignature*>& matches) const {
+    if (builtin_fast_path_) {
+        matches.clear();
+        for (uint32_t mask = match_builtin_headers(data, size); mask; mask &= mask - 1) {
+            matches.push_back(&signatures_[count_trailing_zeros(mask)]);
+        }
+        return;
+    }
     
-    // AVI
-    add_signature({
-        "AVI",
-        ".avi",
-        {0x52, 0x49, 0x46, 0x46}, // RIFF
-        {},
-        0,
-        false
-    });
+    std::vector<uint32_t> ids;
+    header_matcher_.match_at(data, size, ids);
     
-    // BMP
-    add_signature({
-        "BMP",
-        ".bmp",
-        {0x42, 0x4D},
-        {},
-        0,
-        false
-    });
+    matches.clear();
+    for (uint32_t id : ids) {
+        matches.push_back(&signatures_[id]);
+    }
+}
+
+void FileSignatureDetector::scan_headers(const uint8_t* data, size_t size, std::vector<HeaderMatch>& matches) const {
+    // Conjuntos grandes de assinaturas excedem o pré-filtro: usa o autômato completo
+    if (!header_prefilter_.is_enabled()) {
+        header_matcher_.scan(data, size, matches);
+        return;
+    }
     
-    // TIFF (Little Endian)
-    add_signature({
-        "TIFF_LE",
-        ".tiff",
-        {0x49, 0x49, 0x2A, 0x00},
-        {},
-        0,
-        false
-    });
+    // Confirma no autômato apenas os offsets apontados pelo pré-filtro vetorial
+    std::vector<size_t> candidates;
+    std::vector<uint32_t> ids;
+    header_prefilter_.find_candidates(data, size, candidates);
     
-    // TIFF (Big Endian)
-    add_signature({
-        "TIFF_BE",
-        ".tiff",
-        {0x4D, 0x4D, 0x00, 0x2A},
-        {},
-        0,
-        false
-    });
+    matches.clear();
+    if (builtin_fast_path_) {
+        for (size_t offset : candidates) {
+            for (uint32_t mask = match_builtin_headers(data + offset, size - offset); mask; mask &= mask - 1) {
+                matches.push_back({offset, count_trailing_zeros(mask)});
+            }
+        }
+        return;
+    }
     
-    // MS Word DOC
-    add_signature({
-        "DOC",
-        ".doc",
-        {0xD0, 0xCF, 0x11, 0xE0, 0xA1, 0xB1, 0x1A, 0xE1},
-        {},
-        0,
-        false
-    });
+    for (size_t offset : candidates) {
+        header_matcher_.match_at(data + offset, size - offset, ids);
+        for (uint32_t id : ids) {
+            matches.push_back({offset, id});
+        }
+    }
+}
+
+void FileSignatureDetector::scan_headers_aligned(const uint8_t* data, size_t size, size_t first, size_t stride,
+                                                 std::vector<HeaderMatch>& matches) const {
+    matches.clear();
+    if (stride == 0) {
+        return;
+    }
     
-    // Executable (PE)
-    add_signature({
-        "EXE",
-        ".exe",
-        {0x4D, 0x5A}, // MZ
-        {},
-        0,
-        false
-    });
+    if (builtin_fast_path_) {
+        for (size_t offset = first; offset < size; offset += stride) {
+            for (uint32_t mask = match_builtin_headers(data + offset, size - offset); mask; mask &= mask - 1) {
+                matches.push_back({offset, count_trailing_zeros(mask)});
+            }
+        }
+        return;
+    }
     
-    // SQLite Database
-    add_signature({
-        "SQLITE",
-        ".db",
-        {0x53, 0x51, 0x4C, 0x69, 0x74, 0x65, 0x20, 0x66, 0x6F, 0x72, 0x6D, 0x61, 0x74, 0x20, 0x33, 0x00},
-        {},
-        0,
-        false
-    });
+    std::vector<uint32_t> ids;
+    for (size_t offset = first; offset < size; offset += stride) {
+        header_matcher_.match_at(data + offset, size - offset, ids);
+        for (uint32_t id : ids) {
+            matches.push_back({offset, id});
+        }
+    }
 }
 
-void FileSignatureDetector::add_signature(const FileSignature& signature) {
-    signatures_.push_back(signature);
-    name_to_index_[signature.name] = signatures_.size() - 1;
+size_t FileSignatureDetector::get_max_header_length() const {
+    return header_matcher_.get_max_pattern_length();
 }
 
-const FileSignature* FileSignatureDetector::detect_header(const uint8_t* data, size_t size) const {
-    for (const auto& sig : signatures_) {
-        if (size >= sig.header.size()) {
-            if (std::equal(sig.header.begin(), sig.header.end(), data)) {
-                return &sig;
-            }
-        }
+void FileSignatureDetector::set_simd_level(SimdLevel level) {
+    header_prefilter_.set_simd_level(level);
+    for (auto& searcher : footer_searchers_) {
+        searcher.set_simd_level(level);
     }
-    return nullptr;
+}
+
+SimdLevel FileSignatureDetector::get_simd_level() const {
+    return header_prefilter_.get_simd_level();
+}
+
+bool FileSignatureDetector::is_prefilter_enabled() const {
+    return header_prefilter_.is_enabled();
 }
 
 bool FileSignatureDetector::detect_footer(const uint8_t* data, size_t size, const FileSignature* signature) const {
@@ -234,13 +335,27 @@ size_t FileSignatureDetector::find_pattern(const uint8_t* data, size_t size, con
         return SIZE_MAX;
     }
     
-    for (size_t i = 0; i <= size - pattern.size(); ++i) {
-        if (std::equal(pattern.begin(), pattern.end(), data + i)) {
-            return i;
-        }
+    // Padrões avulsos: as tabelas são montadas na hora (footers usam get_footer_searcher)
+    PatternSearcher searcher(pattern);
+    searcher.set_simd_level(header_prefilter_.get_simd_level());
+    return searcher.find(data, size);
+}
+
+const PatternSearcher* FileSignatureDetector::get_footer_searcher(const FileSignature* signature) const {
+    if (!signature || signature < signatures_.data() || signature >= signatures_.data() + signatures_.size()) {
+        return nullptr;
+    }
+    
+    uint32_t index = footer_index_[static_cast<size_t>(signature - signatures_.data())];
+    return index == NO_FOOTER ? nullptr : &footer_searchers_[index];
+}
+
+StructureFormat FileSignatureDetector::get_structure_format(const FileSignature* signature) const {
+    if (!signature || signature < signatures_.data() || signature >= signatures_.data() + signatures_.size()) {
+        return StructureFormat::NONE;
     }
     
-    return SIZE_MAX;
+    return structure_formats_[static_cast<size_t>(signature - signatures_.data())];
 }
 
 const std::vector<FileSignature>& FileSignatureDetector::get_signatures() const {
@@ -248,22 +363,80 @@ const std::vector<FileSignature>& FileSignatureDetector::get_signatures() const
 }
 
 const FileSignature* FileSignatureDetector::get_signature(const std::string& name) const {
-    auto it = name_to_index_.find(name);
+    auto it = name_to_index_.find(name_key(name));
     if (it != name_to_index_.end()) {
         return &signatures_[it->second];
     }
     return nullptr;
 }
 
-bool FileSignatureDetector::load_signatures_from_file(const std::string& filename) {
-    std::ifstream file(filename);
+bool FileSignatureDetector::load_signatures_from_file(const std::string& filename, bool use_cache) {
+    std::ifstream file(filename, std::ios::binary);
     if (!file.is_open()) {
         std::cerr << "Erro ao abrir arquivo de assinaturas: " << filename << std::endl;
         return false;
     }
     
-    // Implementação básica - pode ser expandida para ler formato JSON ou XML
-    // Por enquanto, apenas retorna true como placeholder
+    std::stringstream contents;
+    contents << file.rdbuf();
     file.close();
+    const std::string text = contents.str();
+    
+    // Mesmo conjunto inicial + mesma configuração = mesmo autômato
+    std::string cache_path = SignatureCache::default_path(filename);
+    uint64_t key = use_cache ? SignatureCache::compute_key(signatures_, text) : 0;
+    if (use_cache && SignatureCache::load(cache_path, key, signatures_, builtin_count_, header_matcher_)) {
+        std::vector<std::vector<uint8_t>> headers;
+        name_to_index_.clear();
+        for (size_t i = 0; i < signatures_.size(); ++i) {
+            name_to_index_[name_key(signatures_[i].name)] = i;
+            headers.push_back(signatures_[i].header);
+        }
+        rebuild_search_tables(headers);
+        loaded_from_cache_ = true;
+        return true;
+    }
+    
+    // Valida o arquivo inteiro antes de alterar o conjunto atual
+    std::vector<FileSignature> loaded;
+    std::istringstream lines(text);
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(lines, line)) {
+        line_number++;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+        
+        FileSignature signature;
+        std::string error;
+        if (!parse_signature_line(line, signature, error)) {
+            std::cerr << "Erro em " << filename << ":" << line_number << ": " << error << std::endl;
+            return false;
+        }
+        loaded.push_back(std::move(signature));
+    }
+    
+    // Nome já existente (sem diferenciar maiúsculas) substitui a assinatura
+    // anterior na mesma posição, mantendo a grafia dela nos relatórios
+    for (auto& signature : loaded) {
+        auto it = name_to_index_.find(name_key(signature.name));
+        if (it != name_to_index_.end()) {
+            signature.name = signatures_[it->second].name;
+            signatures_[it->second] = std::move(signature);
+            builtin_count_ = std::min(builtin_count_, it->second);
+        } else {
+            insert_signature(signature);
+        }
+    }
+    rebuild_matcher();
+    loaded_from_cache_ = false;
+    
+    if (use_cache) {
+        SignatureCache::save(cache_path, key, signatures_, builtin_count_, header_matcher_);
+    }
     return true;
-}
\ No newline at end of file
+}
+
+bool FileSignatureDetector::was_loaded_from_cache() const {
+    return loaded_from_cache_;
+}
@@ -0,0 +1,222 @@
+#include "footer_tracker.h"
+#include <algorithm>
+#include <cstdint>
+
+FooterTracker::FooterTracker(const FileSignatureDetector& detector, size_t search_window, size_t file_size,
+                             LengthResolver* resolver)
+    : detector_(detector)
+    , resolver_(resolver)
+    , search_window_(search_window)
+    , file_size_(file_size)
+    , first_index_(0)
+    , open_count_(0)
+    , chunk_data_(nullptr)
+    , chunk_size_(0)
+    , chunk_offset_(0)
+    , max_footer_size_(0)
+    , tail_offset_(0) {
+    for (const auto& signature : detector.get_signatures()) {
+        max_footer_size_ = std::max(max_footer_size_, signature.footer.size());
+    }
+}
+
+size_t FooterTracker::window_of(const FileSignature* signature) const {
+    // O MAX_SIZE da assinatura, quando definido, é a janela daquele tipo
+    return signature->max_size > 0 ? signature->max_size : search_window_;
+}
+
+size_t FooterTracker::find_in_chunk(FooterGroup& group, size_t position) {
+    // Consultas chegam em ordem crescente: a última ocorrência encontrada
+    // responde a todas as posições entre o cursor e ela
+    if (group.cursor != SIZE_MAX && group.cursor <= position &&
+        (group.next_hit == SIZE_MAX || group.next_hit >= position)) {
+        return group.next_hit;
+    }
+
+    size_t result = SIZE_MAX;
+    size_t relative = position - chunk_offset_;
+    if (relative < chunk_size_) {
+        size_t found = group.searcher->find(chunk_data_ + relative, chunk_size_ - relative);
+        if (found != SIZE_MAX) {
+            result = position + found;
+        }
+    }
+
+    group.cursor = position;
+    group.next_hit = result;
+    return result;
+}
+
+size_t FooterTracker::find_across_boundary(const FooterGroup& group) {
+    // Só vale quando o chunk anterior chega até o atual (buracos saltados não têm divisa)
+    const size_t tail_end = tail_offset_ + tail_.size();
+    if (tail_.empty() || tail_end < chunk_offset_ || group.footer_size < 2 || group.frontier >= chunk_offset_) {
+        return SIZE_MAX;
+    }
+
+    // Costura: fim do chunk anterior, da fronteira até o início do atual, + início do atual
+    size_t begin = std::max(group.frontier, tail_offset_);
+    if (begin >= chunk_offset_) {
+        return SIZE_MAX;
+    }
+    seam_.assign(tail_.begin() + (begin - tail_offset_), tail_.begin() + (chunk_offset_ - tail_offset_));
+    seam_.insert(seam_.end(), chunk_data_, chunk_data_ + std::min(chunk_size_, group.footer_size - 1));
+
+    size_t found = group.searcher->find(seam_.data(), seam_.size());
+    if (found == SIZE_MAX || begin + found >= chunk_offset_) {
+        return SIZE_MAX;    // Ocorrências dentro do chunk ficam com find_in_chunk
+    }
+    return begin + found;
+}
+
+void FooterTracker::close(size_t index, size_t footer_position, const FooterGroup& group) {
+    FooterCandidate& candidate = candidates_[index - first_index_];
+    candidate.end_offset = std::min(footer_position + group.footer_size, file_size_);
+    candidate.has_valid_footer = true;
+    candidate.structure_resolved = false;
+    candidate.resolved = true;
+}
+
+void FooterTracker::expire(size_t index) {
+    // Sem footer, o tamanho é estimado pela janela de busca
+    FooterCandidate& candidate = candidates_[index - first_index_];
+    candidate.end_offset = std::min(candidate.start_offset + window_of(candidate.signature), file_size_);
+    candidate.has_valid_footer = false;
+    candidate.structure_resolved = false;
+    candidate.resolved = true;
+}
+
+void FooterTracker::feed(const uint8_t* data, size_t size, size_t file_offset) {
+    chunk_data_ = data;
+    chunk_size_ = size;
+    chunk_offset_ = file_offset;
+    if (resolver_) {
+        resolver_->set_chunk(data, size, file_offset);
+    }
+
+    const size_t chunk_end = file_offset + size;
+
+    for (auto& group : groups_) {
+        group.cursor = SIZE_MAX;
+        group.next_hit = SIZE_MAX;
+
+        if (group.open.empty()) continue;
+
+        // Todos os candidatos abertos já examinaram as posições anteriores à
+        // fronteira; a primeira ocorrência após ela fecha todos de uma vez
+        size_t footer_position = find_across_boundary(group);
+        if (footer_position == SIZE_MAX) {
+            footer_position = find_in_chunk(group, std::max(group.frontier, file_offset));
+        }
+
+        size_t kept = 0;
+        for (size_t index : group.open) {
+            const FooterCandidate& candidate = candidates_[index - first_index_];
+            size_t limit = candidate.start_offset + window_of(candidate.signature);
+            if (footer_position != SIZE_MAX) {
+                if (footer_position + group.footer_size <= limit) {
+                    close(index, footer_position, group);
+                } else {
+                    expire(index);
+                }
+            } else if (limit <= chunk_end || chunk_end >= file_size_) {
+                expire(index);
+            } else {
+                group.open[kept++] = index;
+            }
+        }
+        open_count_ -= group.open.size() - kept;
+        group.open.resize(kept);
+
+        group.frontier = chunk_end >= group.footer_size ? chunk_end - group.footer_size + 1 : 0;
+    }
+
+    size_t keep = std::min(size, max_footer_size_ > 0 ? max_footer_size_ - 1 : 0);
+    tail_.assign(data + size - keep, data + size);
+    tail_offset_ = chunk_end - keep;
+}
+
+const FooterCandidate& FooterTracker::open(const FileSignature* signature, size_t start_offset, bool use_footer) {
+    size_t index = first_index_ + candidates_.size();
+    candidates_.push_back({signature, start_offset, start_offset, false, false, false, 0, 0});
+
+    StructureFormat format = detector_.get_structure_format(signature);
+    size_t end_offset;
+    if (resolver_ && format != StructureFormat::NONE) {
+        FooterCandidate& candidate = candidates_.back();
+        if (resolver_->resolve(format, start_offset, end_offset)) {
+            candidate.end_offset = end_offset;
+            candidate.has_valid_footer = true;
+            candidate.structure_resolved = true;
+            candidate.resolved = true;
+            return candidates_.back();
+        }
+
+        // Guardado para a busca do segundo fragmento (GapCarver)
+        candidate.structure_failure = resolver_->get_failure_offset();
+        candidate.structure_verified = resolver_->get_verified_offset();
+    }
+
+    if (!use_footer || !signature->has_footer || signature->footer.empty()) {
+        expire(index);
+        return candidates_.back();
+    }
+
+    const PatternSearcher* searcher = detector_.get_footer_searcher(signature);
+    if (!searcher) {
+        expire(index);
+        return candidates_.back();
+    }
+
+    auto it = group_index_.find(signature->footer);
+    if (it == group_index_.end()) {
+        it = group_index_.emplace(signature->footer, groups_.size()).first;
+        groups_.push_back({searcher, signature->footer.size(), {}, 0, SIZE_MAX, SIZE_MAX});
+    }
+    FooterGroup& group = groups_[it->second];
+
+    // Primeiro tenta resolver com os dados do próprio chunk
+    size_t limit = start_offset + window_of(signature);
+    size_t footer_position = find_in_chunk(group, start_offset);
+    if (footer_position != SIZE_MAX) {
+        if (footer_position + group.footer_size <= limit) {
+            close(index, footer_position, group);
+        } else {
+            expire(index);
+        }
+        return candidates_.back();
+    }
+
+    const size_t chunk_end = chunk_offset_ + chunk_size_;
+    if (limit <= chunk_end || chunk_end >= file_size_) {
+        expire(index);
+        return candidates_.back();
+    }
+
+    group.open.push_back(index);
+    group.frontier = chunk_end >= group.footer_size ? chunk_end - group.footer_size + 1 : 0;
+    open_count_++;
+    return candidates_.back();
+}
+
+void FooterTracker::finish() {
+    for (auto& group : groups_) {
+        for (size_t index : group.open) {
+            expire(index);
+        }
+        open_count_ -= group.open.size();
+        group.open.clear();
+    }
+}
+
+bool FooterTracker::has_open() const {
+    return open_count_ > 0;
+}
+
+void FooterTracker::take_resolved(std::vector<FooterCandidate>& resolved) {
+    while (!candidates_.empty() && candidates_.front().resolved) {
+        resolved.push_back(candidates_.front());
+        candidates_.pop_front();
+        first_index_++;
+    }
+}
@@ -0,0 +1,121 @@
+#include "gap_carver.h"
+#include "chunk_reader.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+GapCarver::GapCarver(const FileSignatureDetector& detector, ThreadPool& pool, const std::vector<ChunkReader*>& readers,
+                     size_t cluster_size, size_t cluster_base, size_t max_gap, size_t scan_limit)
+    : detector_(detector)
+    , pool_(pool)
+    , cluster_size_(std::max<size_t>(cluster_size, 1))
+    , cluster_base_(cluster_base)
+    , max_gap_(max_gap)
+    , file_size_(readers.empty() ? 0 : readers.front()->get_file_size()) {
+
+    for (ChunkReader* reader : readers) {
+        resolvers_.push_back(std::make_unique<LengthResolver>(*reader, scan_limit));
+    }
+}
+
+GapCarver::~GapCarver() = default;
+
+bool GapCarver::supports(const FileSignature* signature) const {
+    StructureFormat format = detector_.get_structure_format(signature);
+    return format == StructureFormat::JPEG || format == StructureFormat::ZIP || format == StructureFormat::PDF;
+}
+
+GapCarver::Evaluation GapCarver::evaluate(LengthResolver& resolver, StructureFormat format,
+                                          size_t start, size_t split, size_t gap) {
+    auto key = std::make_tuple(format, start, split, split + gap);
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        auto it = cache_.find(key);
+        if (it != cache_.end()) {
+            return it->second;
+        }
+    }
+
+    Evaluation result{false, 0};
+    resolver.set_gap(split, gap);
+    result.valid = resolver.resolve(format, start, result.end) && result.end > split;
+    resolver.set_gap(SIZE_MAX, 0);
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (cache_.size() >= MAX_CACHE_ENTRIES) {
+        cache_.clear();
+    }
+    cache_.emplace(key, result);
+    return result;
+}
+
+bool GapCarver::carve(const FileSignature* signature, size_t start, size_t verified, size_t failure,
+                      std::vector<std::pair<size_t, size_t>>& fragments) {
+    if (!supports(signature) || failure <= start || failure >= file_size_ || resolvers_.empty()) {
+        return false;
+    }
+    const StructureFormat format = detector_.get_structure_format(signature);
+
+    // O primeiro fragmento termina em uma fronteira de cluster entre o último
+    // ponto confirmado e a falha; as mais próximas da falha vêm primeiro
+    const size_t gap_count = std::max<size_t>(max_gap_ / cluster_size_, 1);
+    const size_t split_limit = std::max<size_t>(std::min(MAX_SPLITS, MAX_EVALUATIONS / gap_count), 1);
+    const size_t lower = std::max(start, verified);
+    const size_t phase = cluster_base_ % cluster_size_;
+
+    std::vector<size_t> splits;
+    size_t distance = (failure % cluster_size_ + cluster_size_ - phase) % cluster_size_;
+    size_t split = distance <= failure ? failure - distance : 0;
+    while (split > lower && splits.size() < split_limit) {
+        splits.push_back(split);
+        if (split < cluster_size_) break;
+        split -= cluster_size_;
+    }
+    if (splits.empty()) {
+        return false;
+    }
+
+    // Hipótese i * gap_count + j: corte splits[i], intervalo (j + 1) clusters
+    std::atomic<size_t> best(SIZE_MAX);
+    std::vector<size_t> ends(splits.size(), 0);
+
+    for (size_t i = 0; i < splits.size(); ++i) {
+        pool_.submit([this, i, gap_count, format, start, &splits, &ends, &best]() {
+            LengthResolver& resolver = *resolvers_[ThreadPool::current_worker()];
+            for (size_t j = 0; j < gap_count; ++j) {
+                size_t index = i * gap_count + j;
+                if (best.load(std::memory_order_relaxed) < index) {
+                    return;     // Já há uma hipótese anterior na ordem
+                }
+
+                size_t gap = (j + 1) * cluster_size_;
+                if (gap >= file_size_ - splits[i]) {
+                    return;
+                }
+
+                Evaluation result = evaluate(resolver, format, start, splits[i], gap);
+                if (!result.valid) continue;
+
+                ends[i] = result.end;
+                size_t current = best.load();
+                while (index < current && !best.compare_exchange_weak(current, index)) {
+                }
+                return;
+            }
+        });
+    }
+    pool_.wait();
+
+    size_t chosen = best.load();
+    if (chosen == SIZE_MAX) {
+        return false;
+    }
+
+    size_t cut = splits[chosen / gap_count];
+    size_t gap = (chosen % gap_count + 1) * cluster_size_;
+    fragments.clear();
+    fragments.emplace_back(start, cut);
+    fragments.emplace_back(cut + gap, ends[chosen / gap_count] + gap);
+    return true;
+}
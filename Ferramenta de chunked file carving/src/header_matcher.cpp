@@ -0,0 +1,255 @@
+#include "header_matcher.h"
+#include <algorithm>
+#include <queue>
+
+namespace {
+    const uint32_t NO_STATE = UINT32_MAX;
+}
+
+HeaderMatcher::HeaderMatcher()
+    : blob_(nullptr)
+    , blob_words_(0)
+    , transitions_(nullptr)
+    , depth_(nullptr)
+    , output_begin_(nullptr)
+    , outputs_(nullptr)
+    , pattern_lengths_(nullptr)
+    , state_count_(0)
+    , max_pattern_length_(0)
+    , min_pattern_length_(0) {
+    build({});
+}
+
+void HeaderMatcher::build(const std::vector<std::vector<uint8_t>>& patterns) {
+    std::vector<uint32_t> transitions(256, NO_STATE);
+    std::vector<uint32_t> depth(1, 0);
+    std::vector<uint32_t> pattern_lengths;
+    size_t max_pattern_length = 0;
+    size_t min_pattern_length = 0;
+
+    // Saídas temporárias por estado (próprias + herdadas via falha)
+    std::vector<std::vector<uint32_t>> state_outputs(1);
+
+    // Constrói a trie com as transições diretas (goto)
+    for (size_t id = 0; id < patterns.size(); ++id) {
+        const auto& pattern = patterns[id];
+        pattern_lengths.push_back(static_cast<uint32_t>(pattern.size()));
+
+        if (pattern.empty()) continue;
+
+        uint32_t state = 0;
+        for (uint8_t byte : pattern) {
+            uint32_t& next = transitions[state * 256 + byte];
+            if (next == NO_STATE) {
+                next = static_cast<uint32_t>(depth.size());
+                depth.push_back(depth[state] + 1);
+                state_outputs.emplace_back();
+                transitions.resize(transitions.size() + 256, NO_STATE);
+            }
+            state = transitions[state * 256 + byte];
+        }
+        state_outputs[state].push_back(static_cast<uint32_t>(id));
+
+        max_pattern_length = std::max(max_pattern_length, pattern.size());
+        if (min_pattern_length == 0 || pattern.size() < min_pattern_length) {
+            min_pattern_length = pattern.size();
+        }
+    }
+
+    // BFS: calcula links de falha e completa o DFA
+    std::vector<uint32_t> fail(depth.size(), 0);
+    std::queue<uint32_t> pending;
+
+    for (int byte = 0; byte < 256; ++byte) {
+        uint32_t& next = transitions[byte];
+        if (next == NO_STATE) {
+            next = 0;
+        } else {
+            fail[next] = 0;
+            pending.push(next);
+        }
+    }
+
+    while (!pending.empty()) {
+        uint32_t state = pending.front();
+        pending.pop();
+
+        const auto& inherited = state_outputs[fail[state]];
+        state_outputs[state].insert(state_outputs[state].end(), inherited.begin(), inherited.end());
+        std::sort(state_outputs[state].begin(), state_outputs[state].end());
+
+        for (int byte = 0; byte < 256; ++byte) {
+            uint32_t& next = transitions[state * 256 + byte];
+            uint32_t fallback = transitions[fail[state] * 256 + byte];
+            if (next == NO_STATE) {
+                next = fallback;
+            } else {
+                fail[next] = fallback;
+                pending.push(next);
+            }
+        }
+    }
+
+    // Achata as listas de saída para acesso contíguo durante a busca
+    std::vector<uint32_t> output_begin(depth.size() + 1, 0);
+    std::vector<uint32_t> outputs;
+    for (size_t state = 0; state < depth.size(); ++state) {
+        output_begin[state] = static_cast<uint32_t>(outputs.size());
+        outputs.insert(outputs.end(), state_outputs[state].begin(), state_outputs[state].end());
+    }
+    output_begin[depth.size()] = static_cast<uint32_t>(outputs.size());
+
+    // Monta o bloco: cabeçalho seguido dos arrays, na ordem lida por attach()
+    auto blob = std::make_shared<std::vector<uint32_t>>();
+    blob->reserve(BLOB_HEADER_WORDS + transitions.size() + depth.size() + output_begin.size() +
+                  outputs.size() + pattern_lengths.size());
+    blob->push_back(static_cast<uint32_t>(depth.size()));
+    blob->push_back(static_cast<uint32_t>(outputs.size()));
+    blob->push_back(static_cast<uint32_t>(pattern_lengths.size()));
+    blob->push_back(static_cast<uint32_t>(max_pattern_length));
+    blob->push_back(static_cast<uint32_t>(min_pattern_length));
+    blob->insert(blob->end(), transitions.begin(), transitions.end());
+    blob->insert(blob->end(), depth.begin(), depth.end());
+    blob->insert(blob->end(), output_begin.begin(), output_begin.end());
+    blob->insert(blob->end(), outputs.begin(), outputs.end());
+    blob->insert(blob->end(), pattern_lengths.begin(), pattern_lengths.end());
+
+    const uint32_t* words = blob->data();
+    size_t word_count = blob->size();
+    attach(words, word_count, std::move(blob));
+}
+
+bool HeaderMatcher::attach(const uint32_t* words, size_t word_count, std::shared_ptr<const void> owner) {
+    if (!words || word_count < BLOB_HEADER_WORDS) {
+        return false;
+    }
+
+    const uint64_t states = words[0];
+    const uint64_t output_count = words[1];
+    const uint64_t pattern_count = words[2];
+    if (states == 0 || word_count != BLOB_HEADER_WORDS + states * 256 + states + (states + 1) +
+                                     output_count + pattern_count) {
+        return false;
+    }
+
+    const uint32_t* transitions = words + BLOB_HEADER_WORDS;
+    const uint32_t* depth = transitions + states * 256;
+    const uint32_t* output_begin = depth + states;
+    const uint32_t* outputs = output_begin + states + 1;
+    const uint32_t* pattern_lengths = outputs + output_count;
+
+    // Verificação estrutural: um bloco truncado ou adulterado não pode levar
+    // a busca a ler fora das tabelas. A tabela de transições é percorrida uma
+    // vez (leitura sequencial); é o que scan() faria de qualquer forma
+    if (output_begin[0] != 0 || output_begin[states] != output_count || words[4] > words[3]) {
+        return false;
+    }
+    for (uint64_t k = 0; k < states * 256; ++k) {
+        if (transitions[k] >= states) {
+            return false;
+        }
+    }
+    for (uint64_t state = 0; state < states; ++state) {
+        if (output_begin[state] > output_begin[state + 1] || depth[state] > words[3]) {
+            return false;
+        }
+    }
+    for (uint64_t k = 0; k < output_count; ++k) {
+        if (outputs[k] >= pattern_count) {
+            return false;
+        }
+    }
+    for (uint64_t id = 0; id < pattern_count; ++id) {
+        if (pattern_lengths[id] > words[3]) {
+            return false;
+        }
+    }
+
+    storage_ = std::move(owner);
+    blob_ = words;
+    blob_words_ = word_count;
+    transitions_ = transitions;
+    depth_ = depth;
+    output_begin_ = output_begin;
+    outputs_ = outputs;
+    pattern_lengths_ = pattern_lengths;
+    state_count_ = static_cast<size_t>(states);
+    max_pattern_length_ = words[3];
+    min_pattern_length_ = words[4];
+    return true;
+}
+
+const uint32_t* HeaderMatcher::get_blob() const {
+    return blob_;
+}
+
+size_t HeaderMatcher::get_blob_words() const {
+    return blob_words_;
+}
+
+size_t HeaderMatcher::get_pattern_count() const {
+    return blob_words_ == 0 ? 0 : blob_[2];
+}
+
+void HeaderMatcher::scan(const uint8_t* data, size_t size, std::vector<HeaderMatch>& matches) const {
+    matches.clear();
+
+    const uint32_t* delta = transitions_;
+    const uint32_t* out_begin = output_begin_;
+    uint32_t state = 0;
+
+    for (size_t i = 0; i < size; ++i) {
+        state = delta[state * 256 + data[i]];
+
+        uint32_t first = out_begin[state];
+        uint32_t last = out_begin[state + 1];
+        for (uint32_t k = first; k < last; ++k) {
+            uint32_t id = outputs_[k];
+            matches.push_back({i + 1 - pattern_lengths_[id], id});
+        }
+    }
+
+    // O autômato reporta pelo fim do padrão; reordena pelo início
+    std::sort(matches.begin(), matches.end(), [](const HeaderMatch& a, const HeaderMatch& b) {
+        return a.offset != b.offset ? a.offset < b.offset : a.pattern_id < b.pattern_id;
+    });
+}
+
+void HeaderMatcher::match_at(const uint8_t* data, size_t size, std::vector<uint32_t>& pattern_ids) const {
+    pattern_ids.clear();
+
+    size_t limit = std::min(size, max_pattern_length_);
+    uint32_t state = 0;
+
+    for (size_t i = 0; i < limit; ++i) {
+        state = transitions_[state * 256 + data[i]];
+
+        // Saiu da trie: nenhum padrão mais longo pode começar nesta posição
+        if (depth_[state] != i + 1) break;
+
+        for (uint32_t k = output_begin_[state]; k < output_begin_[state + 1]; ++k) {
+            uint32_t id = outputs_[k];
+            if (pattern_lengths_[id] == i + 1) {
+                pattern_ids.push_back(id);
+            }
+        }
+    }
+
+    std::sort(pattern_ids.begin(), pattern_ids.end());
+}
+
+size_t HeaderMatcher::get_state_count() const {
+    return state_count_;
+}
+
+size_t HeaderMatcher::get_max_pattern_length() const {
+    return max_pattern_length_;
+}
+
+size_t HeaderMatcher::get_min_pattern_length() const {
+    return min_pattern_length_;
+}
+
+bool HeaderMatcher::empty() const {
+    return max_pattern_length_ == 0;
+}
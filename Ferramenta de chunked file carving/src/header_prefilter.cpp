@@ -0,0 +1,373 @@
+#include "header_prefilter.h"
+#include <algorithm>
+#include <cstring>
+
+#if CARVER_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Custo heurístico de um byte como âncora (maior = mais frequente em discos)
+ */
+unsigned byte_cost(uint8_t b) {
+    if (b == 0x00) return 64;                               // Áreas zeradas
+    if (b == 0xFF) return 16;                               // Áreas apagadas, marcadores JPEG
+    if (b == 0x20 || (b >= 'a' && b <= 'z')) return 8;      // Texto
+    if ((b >= 'A' && b <= 'Z') || (b >= '0' && b <= '9') || b < 0x20) return 4;
+    return 1;
+}
+
+/**
+ * @brief Maior número de valores distintos (primeiro ou segundo byte) para o
+ * kernel SSE2 puro; acima disso as comparações por valor perdem para o escalar
+ */
+const size_t SSE2_MAX_BYTES = 4;
+
+/**
+ * @brief Tabelas consumidas pelos kernels vetoriais
+ *
+ * As âncoras são distribuídas em 8 grupos (um bit por grupo). Para cada
+ * posição do par, duas tabelas de 16 entradas indexadas pelos nibbles
+ * baixo e alto indicam quais grupos aceitam aquele byte; o resultado pode
+ * conter falsos positivos, descartados depois pelas tabelas escalares.
+ */
+struct KernelTables {
+    alignas(64) uint8_t first_low[64];  // Tabelas de 16 bytes replicadas por faixa de 128 bits
+    alignas(64) uint8_t first_high[64];
+    alignas(64) uint8_t second_low[64];
+    alignas(64) uint8_t second_high[64];
+    const uint8_t* first_bytes;         // Valores distintos do primeiro byte (kernel SSE2 puro)
+    size_t first_count;
+    const uint8_t* second_bytes;        // Valores distintos do segundo byte (0 = qualquer byte)
+    size_t second_count;
+};
+
+#if CARVER_X86_SIMD
+
+CARVER_TARGET("sse2")
+size_t scan_sse2(const uint8_t* data, size_t size, const KernelTables& t, std::vector<size_t>& positions) {
+    // Sem pshufb no SSE2: filtra separadamente o primeiro e o segundo byte do par
+    // (combinações cruzadas entre âncoras são descartadas pelas tabelas escalares)
+    const size_t width = 16;
+    __m128i first[HeaderPrefilter::MAX_ANCHORS];
+    __m128i second[HeaderPrefilter::MAX_ANCHORS];
+    for (size_t j = 0; j < t.first_count; ++j) first[j] = _mm_set1_epi8(static_cast<char>(t.first_bytes[j]));
+    for (size_t j = 0; j < t.second_count; ++j) second[j] = _mm_set1_epi8(static_cast<char>(t.second_bytes[j]));
+
+    size_t i = 0;
+    for (; i + width + 1 <= size; i += width) {
+        __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+        __m128i hits = _mm_cmpeq_epi8(v0, first[0]);
+        for (size_t j = 1; j < t.first_count; ++j) {
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(v0, first[j]));
+        }
+
+        uint64_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hits));
+        if (mask && t.second_count > 0) {
+            __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 1));
+            __m128i next = _mm_cmpeq_epi8(v1, second[0]);
+            for (size_t j = 1; j < t.second_count; ++j) {
+                next = _mm_or_si128(next, _mm_cmpeq_epi8(v1, second[j]));
+            }
+            mask &= static_cast<uint32_t>(_mm_movemask_epi8(next));
+        }
+
+        while (mask) {
+            positions.push_back(i + count_trailing_zeros(mask));
+            mask &= mask - 1;
+        }
+    }
+    return i;
+}
+
+CARVER_TARGET("ssse3")
+size_t scan_ssse3(const uint8_t* data, size_t size, const KernelTables& t, std::vector<size_t>& positions) {
+    const size_t width = 16;
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i first_low = _mm_load_si128(reinterpret_cast<const __m128i*>(t.first_low));
+    const __m128i first_high = _mm_load_si128(reinterpret_cast<const __m128i*>(t.first_high));
+    const __m128i second_low = _mm_load_si128(reinterpret_cast<const __m128i*>(t.second_low));
+    const __m128i second_high = _mm_load_si128(reinterpret_cast<const __m128i*>(t.second_high));
+
+    size_t i = 0;
+    for (; i + width + 1 <= size; i += width) {
+        __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 1));
+
+        __m128i m0 = _mm_and_si128(
+            _mm_shuffle_epi8(first_low, _mm_and_si128(v0, nibble)),
+            _mm_shuffle_epi8(first_high, _mm_and_si128(_mm_srli_epi16(v0, 4), nibble)));
+        __m128i m1 = _mm_and_si128(
+            _mm_shuffle_epi8(second_low, _mm_and_si128(v1, nibble)),
+            _mm_shuffle_epi8(second_high, _mm_and_si128(_mm_srli_epi16(v1, 4), nibble)));
+
+        __m128i empty = _mm_cmpeq_epi8(_mm_and_si128(m0, m1), zero);
+        uint64_t mask = static_cast<uint32_t>(~_mm_movemask_epi8(empty)) & 0xFFFFu;
+        while (mask) {
+            positions.push_back(i + count_trailing_zeros(mask));
+            mask &= mask - 1;
+        }
+    }
+    return i;
+}
+
+CARVER_TARGET("avx2")
+size_t scan_avx2(const uint8_t* data, size_t size, const KernelTables& t, std::vector<size_t>& positions) {
+    const size_t width = 32;
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i first_low = _mm256_load_si256(reinterpret_cast<const __m256i*>(t.first_low));
+    const __m256i first_high = _mm256_load_si256(reinterpret_cast<const __m256i*>(t.first_high));
+    const __m256i second_low = _mm256_load_si256(reinterpret_cast<const __m256i*>(t.second_low));
+    const __m256i second_high = _mm256_load_si256(reinterpret_cast<const __m256i*>(t.second_high));
+
+    size_t i = 0;
+    for (; i + width + 1 <= size; i += width) {
+        __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 1));
+
+        __m256i m0 = _mm256_and_si256(
+            _mm256_shuffle_epi8(first_low, _mm256_and_si256(v0, nibble)),
+            _mm256_shuffle_epi8(first_high, _mm256_and_si256(_mm256_srli_epi16(v0, 4), nibble)));
+        __m256i m1 = _mm256_and_si256(
+            _mm256_shuffle_epi8(second_low, _mm256_and_si256(v1, nibble)),
+            _mm256_shuffle_epi8(second_high, _mm256_and_si256(_mm256_srli_epi16(v1, 4), nibble)));
+
+        __m256i empty = _mm256_cmpeq_epi8(_mm256_and_si256(m0, m1), zero);
+        uint64_t mask = static_cast<uint32_t>(~_mm256_movemask_epi8(empty));
+        while (mask) {
+            positions.push_back(i + count_trailing_zeros(mask));
+            mask &= mask - 1;
+        }
+    }
+    return i;
+}
+
+CARVER_TARGET("avx512f,avx512bw")
+size_t scan_avx512(const uint8_t* data, size_t size, const KernelTables& t, std::vector<size_t>& positions) {
+    const size_t width = 64;
+    const __m512i nibble = _mm512_set1_epi8(0x0F);
+    const __m512i first_low = _mm512_load_si512(t.first_low);
+    const __m512i first_high = _mm512_load_si512(t.first_high);
+    const __m512i second_low = _mm512_load_si512(t.second_low);
+    const __m512i second_high = _mm512_load_si512(t.second_high);
+
+    size_t i = 0;
+    for (; i + width + 1 <= size; i += width) {
+        __m512i v0 = _mm512_loadu_si512(data + i);
+        __m512i v1 = _mm512_loadu_si512(data + i + 1);
+
+        __m512i m0 = _mm512_and_si512(
+            _mm512_shuffle_epi8(first_low, _mm512_and_si512(v0, nibble)),
+            _mm512_shuffle_epi8(first_high, _mm512_and_si512(_mm512_srli_epi16(v0, 4), nibble)));
+        __m512i m1 = _mm512_and_si512(
+            _mm512_shuffle_epi8(second_low, _mm512_and_si512(v1, nibble)),
+            _mm512_shuffle_epi8(second_high, _mm512_and_si512(_mm512_srli_epi16(v1, 4), nibble)));
+
+        uint64_t mask = _mm512_test_epi8_mask(m0, m1);
+        while (mask) {
+            positions.push_back(i + count_trailing_zeros(mask));
+            mask &= mask - 1;
+        }
+    }
+    return i;
+}
+
+#endif
+
+} // namespace
+
+HeaderPrefilter::HeaderPrefilter()
+    : single_mask_(0)
+    , enabled_(false)
+    , simd_level_(detect_simd_level()) {
+    build({});
+}
+
+void HeaderPrefilter::build(const std::vector<std::vector<uint8_t>>& patterns) {
+    anchors_.clear();
+    first_bytes_.clear();
+    second_bytes_.clear();
+    std::memset(first_low_, 0, sizeof(first_low_));
+    std::memset(first_high_, 0, sizeof(first_high_));
+    std::memset(second_low_, 0, sizeof(second_low_));
+    std::memset(second_high_, 0, sizeof(second_high_));
+    std::memset(first_table_, 0, sizeof(first_table_));
+    std::memset(second_table_, 0, sizeof(second_table_));
+    single_mask_ = 0;
+    enabled_ = false;
+
+    // Escolhe, para cada padrão, o par de bytes de menor custo
+    for (const auto& pattern : patterns) {
+        if (pattern.empty()) continue;
+
+        Anchor candidate{pattern[0], 0, pattern.size() == 1, {}};
+        uint32_t offset = 0;
+
+        if (!candidate.single) {
+            unsigned best_cost = UINT32_MAX;
+            for (size_t k = 0; k + 1 < pattern.size(); ++k) {
+                unsigned cost = byte_cost(pattern[k]) * byte_cost(pattern[k + 1]);
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    candidate.first = pattern[k];
+                    candidate.second = pattern[k + 1];
+                    offset = static_cast<uint32_t>(k);
+                }
+            }
+        }
+
+        auto it = std::find_if(anchors_.begin(), anchors_.end(), [&](const Anchor& a) {
+            return a.first == candidate.first && a.single == candidate.single &&
+                   (a.single || a.second == candidate.second);
+        });
+        if (it == anchors_.end()) {
+            // Conjuntos grandes desabilitam o pré-filtro: não adianta continuar
+            if (anchors_.size() == MAX_ANCHORS) {
+                anchors_.clear();
+                return;
+            }
+            anchors_.push_back(candidate);
+            it = anchors_.end() - 1;
+        }
+        if (std::find(it->offsets.begin(), it->offsets.end(), offset) == it->offsets.end()) {
+            it->offsets.push_back(offset);
+        }
+    }
+
+    if (anchors_.empty()) {
+        return;
+    }
+
+    // Monta as tabelas escalares e as tabelas de nibbles dos kernels vetoriais
+    for (size_t a = 0; a < anchors_.size(); ++a) {
+        const Anchor& anchor = anchors_[a];
+        uint32_t bit = 1u << a;
+        uint8_t group = static_cast<uint8_t>(1u << (a % 8));
+
+        first_table_[anchor.first] |= bit;
+        first_low_[anchor.first & 0x0F] |= group;
+        first_high_[anchor.first >> 4] |= group;
+        if (std::find(first_bytes_.begin(), first_bytes_.end(), anchor.first) == first_bytes_.end()) {
+            first_bytes_.push_back(anchor.first);
+        }
+
+        if (anchor.single) {
+            single_mask_ |= bit;
+            for (int nib = 0; nib < 16; ++nib) {
+                second_low_[nib] |= group;
+                second_high_[nib] |= group;
+            }
+        } else {
+            second_table_[anchor.second] |= bit;
+            if (std::find(second_bytes_.begin(), second_bytes_.end(), anchor.second) == second_bytes_.end()) {
+                second_bytes_.push_back(anchor.second);
+            }
+            second_low_[anchor.second & 0x0F] |= group;
+            second_high_[anchor.second >> 4] |= group;
+        }
+    }
+
+    for (int byte = 0; byte < 256; ++byte) {
+        second_table_[byte] |= single_mask_;
+    }
+    if (single_mask_) {
+        second_bytes_.clear(); // Qualquer segundo byte é aceito
+    }
+
+    enabled_ = true;
+}
+
+void HeaderPrefilter::find_anchor_positions(const uint8_t* data, size_t size, std::vector<size_t>& positions) const {
+    size_t i = 0;
+
+#if CARVER_X86_SIMD
+    KernelTables tables;
+    for (size_t lane = 0; lane < 64; lane += 16) {
+        std::memcpy(tables.first_low + lane, first_low_, sizeof(first_low_));
+        std::memcpy(tables.first_high + lane, first_high_, sizeof(first_high_));
+        std::memcpy(tables.second_low + lane, second_low_, sizeof(second_low_));
+        std::memcpy(tables.second_high + lane, second_high_, sizeof(second_high_));
+    }
+    tables.first_bytes = first_bytes_.data();
+    tables.first_count = first_bytes_.size();
+    tables.second_bytes = second_bytes_.data();
+    tables.second_count = second_bytes_.size();
+
+    switch (simd_level_) {
+        case SimdLevel::AVX512: i = scan_avx512(data, size, tables, positions); break;
+        case SimdLevel::AVX2: i = scan_avx2(data, size, tables, positions); break;
+        case SimdLevel::SSE2:
+            // Com pshufb o kernel de nibbles vence o escalar; sem ele, as comparações
+            // por valor só compensam com poucas âncoras
+            if (cpu_supports_ssse3()) {
+                i = scan_ssse3(data, size, tables, positions);
+            } else if (tables.first_count <= SSE2_MAX_BYTES && tables.second_count <= SSE2_MAX_BYTES) {
+                i = scan_sse2(data, size, tables, positions);
+            }
+            break;
+        default: break;
+    }
+#endif
+
+    // Caminho escalar: também trata o final do buffer não coberto pelos kernels
+    for (; i < size; ++i) {
+        uint32_t second = i + 1 < size ? second_table_[data[i + 1]] : single_mask_;
+        if (first_table_[data[i]] & second) {
+            positions.push_back(i);
+        }
+    }
+}
+
+void HeaderPrefilter::find_candidates(const uint8_t* data, size_t size, std::vector<size_t>& starts) const {
+    starts.clear();
+    if (!enabled_) return;
+
+    std::vector<size_t> positions;
+    find_anchor_positions(data, size, positions);
+
+    // Confirma o par completo (os kernels admitem falsos positivos) e converte
+    // a posição de cada âncora no início do(s) padrão(ões) correspondente(s)
+    bool sorted = true;
+    for (size_t pos : positions) {
+        uint32_t second = pos + 1 < size ? second_table_[data[pos + 1]] : single_mask_;
+        uint32_t mask = first_table_[data[pos]] & second;
+
+        while (mask) {
+            const Anchor& anchor = anchors_[count_trailing_zeros(mask)];
+            mask &= mask - 1;
+
+            for (uint32_t offset : anchor.offsets) {
+                if (pos < offset) continue;
+                size_t start = pos - offset;
+                if (!starts.empty() && start <= starts.back()) sorted = false;
+                starts.push_back(start);
+            }
+        }
+    }
+
+    if (!sorted) {
+        std::sort(starts.begin(), starts.end());
+        starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+    }
+}
+
+bool HeaderPrefilter::is_enabled() const {
+    return enabled_;
+}
+
+size_t HeaderPrefilter::get_anchor_count() const {
+    return anchors_.size();
+}
+
+void HeaderPrefilter::set_simd_level(SimdLevel level) {
+    simd_level_ = clamp_simd_level(level);
+}
+
+SimdLevel HeaderPrefilter::get_simd_level() const {
+    return simd_level_;
+}
@@ -0,0 +1,88 @@
+#include "interval_index.h"
+#include <algorithm>
+#include <cstdint>
+
+void IntervalIndex::insert(size_t begin, size_t end, size_t owner) {
+    if (begin >= end) {
+        return;
+    }
+
+    // Cada arquivo mantém o próprio intervalo: a união abaixo perde os donos
+    files_.emplace(begin, Interval{end, owner});
+
+    // Intervalo anterior que passa de begin é unido a este (vizinhos apenas
+    // encostados continuam separados)
+    auto it = coverage_.upper_bound(begin);
+    if (it != coverage_.begin()) {
+        auto previous = std::prev(it);
+        if (previous->second > begin) {
+            if (previous->second >= end) {
+                return;     // Já coberto
+            }
+            begin = previous->first;
+            it = coverage_.erase(previous);
+        }
+    }
+
+    // Intervalos seguintes que começam dentro de [begin, end)
+    while (it != coverage_.end() && it->first < end) {
+        end = std::max(end, it->second);
+        it = coverage_.erase(it);
+    }
+
+    coverage_.emplace_hint(it, begin, end);
+}
+
+bool IntervalIndex::find_enclosing(size_t offset, size_t& owner) const {
+    auto region = coverage_.lower_bound(offset);
+    if (region == coverage_.begin()) {
+        return false;
+    }
+    --region;
+    if (offset >= region->second) {
+        return false;
+    }
+
+    // Do início mais próximo para trás, sem sair da região: o primeiro arquivo
+    // que contém o offset é o mais interno (empates no início ficam com o menor)
+    const Interval* innermost = nullptr;
+    size_t innermost_begin = 0;
+    for (auto it = files_.lower_bound(offset); it != files_.begin(); ) {
+        --it;
+        if (it->first < region->first || (innermost && it->first < innermost_begin)) {
+            break;
+        }
+        if (offset < it->second.end && (!innermost || it->second.end < innermost->end)) {
+            innermost = &it->second;
+            innermost_begin = it->first;
+        }
+    }
+    if (!innermost) {
+        return false;
+    }
+    owner = innermost->owner;
+    return true;
+}
+
+size_t IntervalIndex::skip_covered(size_t offset) const {
+    auto it = coverage_.lower_bound(offset);
+    if (it == coverage_.begin()) {
+        return offset;
+    }
+    --it;
+    return offset < it->second ? it->second : offset;
+}
+
+size_t IntervalIndex::next_region(size_t offset) const {
+    auto it = coverage_.upper_bound(offset);
+    return it != coverage_.end() ? it->first : SIZE_MAX;
+}
+
+size_t IntervalIndex::size() const {
+    return coverage_.size();
+}
+
+void IntervalIndex::clear() {
+    coverage_.clear();
+    files_.clear();
+}
@@ -0,0 +1,281 @@
+#include "known_hashes.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CARVER_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define CARVER_HAVE_MMAP 0
+#endif
+
+const char KnownHashSet::MAGIC[8] = {'C', 'R', 'V', 'K', 'H', 'S', '1', '\0'};
+
+namespace {
+
+const uint64_t BLOOM_BLOCK_BITS = 512;
+const uint64_t BLOOM_BLOCK_WORDS = BLOOM_BLOCK_BITS / 64;
+const uint32_t BLOOM_PROBES = 7;
+const unsigned BLOOM_PROBE_BITS = 9;            // log2(BLOOM_BLOCK_BITS)
+const uint64_t BLOOM_MIX = 0x9E3779B97F4A7C15ull;
+
+/**
+ * @brief Chave de 64 bits do hash: os 8 primeiros bytes, big-endian
+ *
+ * Preserva a ordem lexicográfica da tabela (usada na interpolação) e, como
+ * o SHA-256 é uniforme, serve também de entrada para o filtro.
+ */
+inline uint64_t hash_key(const uint8_t* hash) {
+    uint64_t key = 0;
+    for (int i = 0; i < 8; ++i) {
+        key = (key << 8) | hash[i];
+    }
+    return key;
+}
+
+/**
+ * @brief Bloco do filtro: metade alta da chave, reduzida sem divisão
+ */
+inline uint64_t bloom_block(uint64_t key, uint64_t blocks) {
+    return ((key >> 32) * blocks) >> 32;
+}
+
+/**
+ * @brief Mapeia o banco para leitura aleatória (ou lê para memória sem mmap)
+ * @param path Caminho do arquivo
+ * @param size Tamanho do arquivo
+ * @return Dono da memória (nulo em caso de erro)
+ */
+std::shared_ptr<const void> map_database(const std::string& path, size_t& size) {
+#if CARVER_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    size = static_cast<size_t>(info.st_size);
+
+    void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        return nullptr;
+    }
+
+    // Consultas saltam pela tabela: leitura antecipada só traria páginas inúteis
+    madvise(address, size, MADV_RANDOM);
+
+    size_t mapped_size = size;
+    return std::shared_ptr<const void>(address, [mapped_size](const void* pointer) {
+        munmap(const_cast<void*>(pointer), mapped_size);
+    });
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+    size = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+
+    auto buffer = std::make_shared<std::vector<uint64_t>>((size + 7) / 8);
+    if (!file.read(reinterpret_cast<char*>(buffer->data()), static_cast<std::streamsize>(size))) {
+        return nullptr;
+    }
+    return std::shared_ptr<const void>(buffer, buffer->data());
+#endif
+}
+
+} // namespace
+
+KnownHashSet::KnownHashSet()
+    : bloom_(nullptr)
+    , table_(nullptr)
+    , bloom_blocks_(0)
+    , bloom_probes_(0)
+    , count_(0) {
+}
+
+bool KnownHashSet::open(const std::string& path) {
+    size_t size = 0;
+    std::shared_ptr<const void> storage = map_database(path, size);
+    if (!storage || size < sizeof(KnownHashHeader)) {
+        std::cerr << "Erro ao abrir banco de hashes: " << path << std::endl;
+        return false;
+    }
+
+    const uint8_t* data = static_cast<const uint8_t*>(storage.get());
+    KnownHashHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == 1) {
+        std::cerr << "Banco de hashes no formato antigo (XXH64), gere novamente com carver-hashdb: "
+                  << path << std::endl;
+        return false;
+    }
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != FORMAT_VERSION || header.byte_order != BYTE_ORDER_TAG) {
+        std::cerr << "Banco de hashes inválido: " << path << std::endl;
+        return false;
+    }
+
+    const uint64_t bloom_bytes = header.bloom_blocks * (BLOOM_BLOCK_BITS / 8);
+    if (header.bloom_blocks == 0 || header.bloom_blocks > UINT32_MAX ||
+        header.bloom_probes == 0 || header.bloom_probes * BLOOM_PROBE_BITS > 64 ||
+        header.bloom_offset % 64 != 0 || header.bloom_offset < sizeof(KnownHashHeader) ||
+        header.bloom_offset > size || bloom_bytes > size - header.bloom_offset ||
+        header.table_offset != header.bloom_offset + bloom_bytes ||
+        header.hash_count > (size - header.table_offset) / sizeof(Sha256Digest)) {
+        std::cerr << "Banco de hashes corrompido: " << path << std::endl;
+        return false;
+    }
+
+    storage_ = std::move(storage);
+    bloom_ = reinterpret_cast<const uint64_t*>(data + header.bloom_offset);
+    table_ = data + header.table_offset;
+    bloom_blocks_ = header.bloom_blocks;
+    bloom_probes_ = header.bloom_probes;
+    count_ = static_cast<size_t>(header.hash_count);
+    return true;
+}
+
+bool KnownHashSet::bloom_contains(uint64_t key) const {
+    const uint64_t* block = bloom_ + bloom_block(key, bloom_blocks_) * BLOOM_BLOCK_WORDS;
+    uint64_t bits = key * BLOOM_MIX;
+    for (uint32_t probe = 0; probe < bloom_probes_; ++probe) {
+        unsigned bit = static_cast<unsigned>(bits & (BLOOM_BLOCK_BITS - 1));
+        if ((block[bit / 64] & (1ull << (bit % 64))) == 0) {
+            return false;
+        }
+        bits >>= BLOOM_PROBE_BITS;
+    }
+    return true;
+}
+
+bool KnownHashSet::contains(const Sha256Digest& hash) const {
+    const uint64_t key = hash_key(hash.data());
+    if (count_ == 0 || !bloom_contains(key)) {
+        return false;
+    }
+
+    const size_t entry = sizeof(Sha256Digest);
+    auto compare = [&](size_t position) {
+        return std::memcmp(table_ + position * entry, hash.data(), entry);
+    };
+
+    // Interpolação pela chave: com hashes uniformes a estimativa cai a poucas posições do alvo
+    size_t low = 0;
+    size_t high = count_ - 1;
+    for (int step = 0; step < 32; ++step) {
+        uint64_t low_key = hash_key(table_ + low * entry);
+        uint64_t high_key = hash_key(table_ + high * entry);
+        if (key < low_key || key > high_key) {
+            return false;
+        }
+        if (low_key == high_key) {
+            break;      // Mesma chave em todo o intervalo: decide a busca binária
+        }
+
+        double fraction = static_cast<double>(key - low_key) / static_cast<double>(high_key - low_key);
+        size_t position = low + static_cast<size_t>(fraction * static_cast<double>(high - low));
+        position = std::min(std::max(position, low), high);
+
+        int order = compare(position);
+        if (order == 0) {
+            return true;
+        }
+        if (order < 0) {
+            low = position + 1;
+        } else {
+            if (position == 0) {
+                return false;
+            }
+            high = position - 1;
+        }
+        if (low > high) {
+            return false;
+        }
+    }
+
+    // Distribuição anômala (banco montado à mão) ou chaves repetidas: termina por busca binária
+    while (low <= high) {
+        size_t middle = low + (high - low) / 2;
+        int order = compare(middle);
+        if (order == 0) {
+            return true;
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            if (middle == 0) {
+                return false;
+            }
+            high = middle - 1;
+        }
+    }
+    return false;
+}
+
+size_t KnownHashSet::size() const {
+    return count_;
+}
+
+bool KnownHashSet::build(const std::string& path, std::vector<Sha256Digest>& hashes, size_t bits_per_hash) {
+    std::sort(hashes.begin(), hashes.end());
+    hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+
+    KnownHashHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.byte_order = BYTE_ORDER_TAG;
+    header.hash_count = hashes.size();
+    header.bloom_blocks = std::max<uint64_t>(1, (hashes.size() * std::max<size_t>(bits_per_hash, 1) +
+                                                 BLOOM_BLOCK_BITS - 1) / BLOOM_BLOCK_BITS);
+    header.bloom_probes = BLOOM_PROBES;
+    header.bloom_offset = (sizeof(KnownHashHeader) + 63) / 64 * 64;
+    header.table_offset = header.bloom_offset + header.bloom_blocks * (BLOOM_BLOCK_BITS / 8);
+
+    if (header.bloom_blocks > UINT32_MAX) {
+        std::cerr << "Erro: banco de hashes grande demais para o filtro" << std::endl;
+        return false;
+    }
+
+    std::vector<uint64_t> bloom(header.bloom_blocks * BLOOM_BLOCK_WORDS, 0);
+    for (const Sha256Digest& hash : hashes) {
+        uint64_t key = hash_key(hash.data());
+        uint64_t* block = bloom.data() + bloom_block(key, header.bloom_blocks) * BLOOM_BLOCK_WORDS;
+        uint64_t bits = key * BLOOM_MIX;
+        for (uint32_t probe = 0; probe < header.bloom_probes; ++probe) {
+            unsigned bit = static_cast<unsigned>(bits & (BLOOM_BLOCK_BITS - 1));
+            block[bit / 64] |= 1ull << (bit % 64);
+            bits >>= BLOOM_PROBE_BITS;
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Erro ao criar banco de hashes: " << path << std::endl;
+        return false;
+    }
+
+    std::string padding(header.bloom_offset - sizeof(header), '\0');
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+    file.write(reinterpret_cast<const char*>(bloom.data()), static_cast<std::streamsize>(bloom.size() * sizeof(uint64_t)));
+    file.write(reinterpret_cast<const char*>(hashes.data()), static_cast<std::streamsize>(hashes.size() * sizeof(Sha256Digest)));
+    file.close();
+
+    if (!file) {
+        std::cerr << "Erro ao gravar banco de hashes: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,922 @@
+#include "length_resolver.h"
+#include "chunk_reader.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+uint16_t read_le16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t read_le32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t read_le64(const uint8_t* p) {
+    return static_cast<uint64_t>(read_le32(p)) | (static_cast<uint64_t>(read_le32(p + 4)) << 32);
+}
+
+uint16_t read_be16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint32_t read_be32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+uint64_t read_be64(const uint8_t* p) {
+    return (static_cast<uint64_t>(read_be32(p)) << 32) | read_be32(p + 4);
+}
+
+bool starts_with(const std::vector<uint8_t>& header, const char* prefix, size_t length) {
+    return header.size() >= length && std::memcmp(header.data(), prefix, length) == 0;
+}
+
+bool is_fourcc(const uint8_t* p) {
+    for (size_t k = 0; k < 4; ++k) {
+        bool letter = (p[k] >= 'A' && p[k] <= 'Z') || (p[k] >= 'a' && p[k] <= 'z');
+        bool digit = p[k] >= '0' && p[k] <= '9';
+        if (!letter && !digit && p[k] != ' ') return false;
+    }
+    return true;
+}
+
+bool is_mp4_top_level_box(const uint8_t* type) {
+    static const char* const BOXES[] = {
+        "ftyp", "styp", "moov", "mdat", "free", "skip", "wide", "uuid",
+        "moof", "mfra", "meta", "pdin", "sidx", "ssix", "prft", "emsg"
+    };
+    for (const char* box : BOXES) {
+        if (std::memcmp(type, box, 4) == 0) return true;
+    }
+    return false;
+}
+
+const uint32_t ZIP_LOCAL_HEADER = 0x04034B50;
+const uint32_t ZIP_CENTRAL_HEADER = 0x02014B50;
+const uint32_t ZIP64_END_RECORD = 0x06064B50;
+const uint32_t ZIP64_END_LOCATOR = 0x07064B50;
+const uint32_t ZIP_END_RECORD = 0x06054B50;
+
+bool is_pdf_space(uint8_t c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\0';
+}
+
+bool is_digit(uint8_t c) {
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * @brief Tabela do CRC-32 (polinômio refletido 0xEDB88320, o mesmo do ZIP)
+ */
+struct Crc32Table {
+    uint32_t entries[256];
+
+    constexpr Crc32Table() : entries() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                value = (value & 1) ? (value >> 1) ^ 0xEDB88320u : value >> 1;
+            }
+            entries[i] = value;
+        }
+    }
+};
+
+constexpr Crc32Table CRC32_TABLE;
+
+} // namespace
+
+StructureFormat detect_structure_format(const std::vector<uint8_t>& header) {
+    if (starts_with(header, "\xFF\xD8\xFF", 3)) return StructureFormat::JPEG;
+    if (starts_with(header, "\x89PNG\r\n\x1A\n", 8)) return StructureFormat::PNG;
+    if (starts_with(header, "BM", 2)) return StructureFormat::BMP;
+    if (starts_with(header, "RIFF", 4)) return StructureFormat::RIFF;
+    if (header.size() >= 8 && std::memcmp(header.data() + 4, "ftyp", 4) == 0) return StructureFormat::MP4;
+    if (starts_with(header, "SQLite format 3", 15)) return StructureFormat::SQLITE;
+    if (starts_with(header, "MZ", 2)) return StructureFormat::PE;
+    if (starts_with(header, "PK\x03\x04", 4)) return StructureFormat::ZIP;
+    if (starts_with(header, "%PDF-", 5)) return StructureFormat::PDF;
+    return StructureFormat::NONE;
+}
+
+const char* structure_format_name(StructureFormat format) {
+    switch (format) {
+        case StructureFormat::JPEG: return "JPEG";
+        case StructureFormat::PNG: return "PNG";
+        case StructureFormat::BMP: return "BMP";
+        case StructureFormat::RIFF: return "RIFF";
+        case StructureFormat::MP4: return "MP4";
+        case StructureFormat::SQLITE: return "SQLite";
+        case StructureFormat::PE: return "PE";
+        case StructureFormat::ZIP: return "ZIP";
+        case StructureFormat::PDF: return "PDF";
+        default: return "Nenhum";
+    }
+}
+
+LengthResolver::LengthResolver(ChunkReader& reader, size_t scan_limit)
+    : reader_(reader)
+    , physical_size_(reader.get_file_size())
+    , file_size_(physical_size_)
+    , scan_limit_(scan_limit)
+    , split_(SIZE_MAX)
+    , gap_(0)
+    , failure_(0)
+    , verified_(0)
+    , chunk_data_(nullptr)
+    , chunk_size_(0)
+    , chunk_offset_(0)
+    , block_offset_(0) {
+}
+
+void LengthResolver::set_chunk(const uint8_t* data, size_t size, size_t file_offset) {
+    chunk_data_ = data;
+    chunk_size_ = size;
+    chunk_offset_ = file_offset;
+}
+
+void LengthResolver::set_gap(size_t split, size_t gap) {
+    if (split == SIZE_MAX || gap == 0 || gap >= physical_size_) {
+        split_ = SIZE_MAX;
+        gap_ = 0;
+        file_size_ = physical_size_;
+        return;
+    }
+
+    split_ = split;
+    gap_ = gap;
+    file_size_ = physical_size_ - gap;
+}
+
+size_t LengthResolver::get_failure_offset() const {
+    return failure_;
+}
+
+size_t LengthResolver::get_verified_offset() const {
+    return verified_;
+}
+
+bool LengthResolver::fail(size_t position, size_t verified) {
+    failure_ = position;
+    verified_ = verified;
+    return false;
+}
+
+const uint8_t* LengthResolver::view(size_t position, size_t wanted, size_t& available) {
+    available = 0;
+    if (position >= file_size_) {
+        return nullptr;
+    }
+
+    // No modo fragmentado uma visão nunca atravessa o ponto de corte
+    size_t contiguous = SIZE_MAX;
+    if (position < split_) {
+        contiguous = split_ - position;
+    } else {
+        position += gap_;
+    }
+
+    const uint8_t* data;
+    if (chunk_data_ && position >= chunk_offset_ && position - chunk_offset_ < chunk_size_) {
+        available = chunk_size_ - (position - chunk_offset_);
+        data = chunk_data_ + (position - chunk_offset_);
+    } else {
+        if (block_.empty() || position < block_offset_ || position - block_offset_ >= block_.size()) {
+            block_offset_ = position;
+            if (reader_.read_at_position(position, std::max(std::min(wanted, contiguous), BLOCK_SIZE), block_) == 0) {
+                block_.clear();
+                return nullptr;
+            }
+        }
+        available = block_.size() - (position - block_offset_);
+        data = block_.data() + (position - block_offset_);
+    }
+
+    available = std::min(available, contiguous);
+    return data;
+}
+
+bool LengthResolver::read(size_t position, void* out, size_t size) {
+    if (position > file_size_ || size > file_size_ - position) {
+        return false;
+    }
+
+    uint8_t* target = static_cast<uint8_t*>(out);
+    while (size > 0) {
+        size_t available;
+        const uint8_t* data = view(position, size, available);
+        if (!data) {
+            return false;
+        }
+        size_t length = std::min(size, available);
+        std::memcpy(target, data, length);
+        target += length;
+        position += length;
+        size -= length;
+    }
+    return true;
+}
+
+size_t LengthResolver::find_text(size_t position, size_t limit, const char* text, size_t length) {
+    uint8_t candidate[16];
+    if (length == 0 || length > sizeof(candidate)) {
+        return SIZE_MAX;
+    }
+
+    while (position < limit && limit - position >= length) {
+        size_t available;
+        const uint8_t* data = view(position, SCAN_BLOCK_SIZE, available);
+        if (!data) {
+            return SIZE_MAX;
+        }
+        available = std::min(available, limit - position);
+
+        const uint8_t* hit = static_cast<const uint8_t*>(std::memchr(data, text[0], available));
+        if (!hit) {
+            position += available;
+            continue;
+        }
+        position += static_cast<size_t>(hit - data);
+
+        if (!read(position, candidate, length)) {
+            return SIZE_MAX;
+        }
+        if (std::memcmp(candidate, text, length) == 0) {
+            return position;
+        }
+        position++;
+    }
+    return SIZE_MAX;
+}
+
+bool LengthResolver::resolve(StructureFormat format, size_t start, size_t& end) {
+    failure_ = 0;
+    verified_ = start;
+    if (start >= file_size_) {
+        return false;
+    }
+
+    switch (format) {
+        case StructureFormat::JPEG: return resolve_jpeg(start, end);
+        case StructureFormat::PNG: return resolve_png(start, end);
+        case StructureFormat::BMP: return resolve_bmp(start, end);
+        case StructureFormat::RIFF: return resolve_riff(start, end);
+        case StructureFormat::MP4: return resolve_mp4(start, end);
+        case StructureFormat::SQLITE: return resolve_sqlite(start, end);
+        case StructureFormat::PE: return resolve_pe(start, end);
+        case StructureFormat::ZIP: return resolve_zip(start, end);
+        case StructureFormat::PDF: return resolve_pdf(start, end);
+        default: return false;
+    }
+}
+
+bool LengthResolver::skip_entropy_data(size_t& position, size_t limit, uint8_t& restart) {
+    // Dentro dos dados comprimidos 0xFF só aparece como FF00 (byte escapado),
+    // FFD0-FFD7 (reinício, em sequência módulo 8) ou preenchimento; qualquer
+    // outro par é um marcador
+    while (position < limit) {
+        size_t available;
+        const uint8_t* data = view(position, SCAN_BLOCK_SIZE, available);
+        if (!data) {
+            return false;
+        }
+        available = std::min(available, limit - position);
+
+        const uint8_t* hit = static_cast<const uint8_t*>(std::memchr(data, 0xFF, available));
+        if (!hit) {
+            position += available;
+            continue;
+        }
+        position += static_cast<size_t>(hit - data);
+
+        uint8_t next;
+        if (hit + 1 < data + available) {
+            next = hit[1];
+        } else if (!read(position + 1, &next, 1)) {
+            return false;
+        }
+
+        if (next >= 0xD0 && next <= 0xD7) {
+            if (next != 0xD0 + restart) {
+                return false;   // Reinício fora de ordem: dados de outro arquivo
+            }
+            restart = (restart + 1) & 7;
+            position += 2;
+            continue;
+        }
+        if (next == 0x00 || next == 0xFF) {
+            position++;
+            continue;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool LengthResolver::is_valid_jpeg_segment(uint8_t code, size_t position, size_t length) {
+    // Só marcadores que podem seguir um scan são aceitos, e o conteúdo precisa
+    // fechar com o comprimento declarado: um par FFxx qualquer dentro de dados
+    // de outro arquivo não passa
+    bool application = code >= 0xE0 && code <= 0xEF;
+    if (code != 0xC4 && code != 0xDB && code != 0xDD && code != 0xDA && code != 0xFE && !application) {
+        return false;
+    }
+
+    std::vector<uint8_t> payload(length - 2);
+    if (!read(position + 4, payload.data(), payload.size())) {
+        return false;
+    }
+    const uint8_t* p = payload.data();
+    const size_t size = payload.size();
+
+    switch (code) {
+        case 0xC4: {
+            // DHT: classe/destino, 16 contagens e os símbolos de cada tabela
+            if (size == 0) return false;
+            for (size_t k = 0; k < size;) {
+                if (size - k < 17 || (p[k] >> 4) > 1 || (p[k] & 0x0F) > 3) return false;
+                size_t symbols = 0;
+                for (size_t n = 1; n <= 16; ++n) symbols += p[k + n];
+                if (symbols == 0 || symbols > 256 || size - k - 17 < symbols) return false;
+                k += 17 + symbols;
+            }
+            break;
+        }
+        case 0xDB: {
+            // DQT: precisão/destino e 64 coeficientes de 8 ou 16 bits
+            if (size == 0) return false;
+            for (size_t k = 0; k < size;) {
+                if ((p[k] >> 4) > 1 || (p[k] & 0x0F) > 3) return false;
+                size_t table = 1 + 64 * ((p[k] >> 4) + 1);
+                if (size - k < table) return false;
+                k += table;
+            }
+            break;
+        }
+        case 0xDD:
+            // DRI: intervalo de reinício de 16 bits
+            if (size != 2) return false;
+            break;
+        case 0xDA: {
+            // SOS: 1 a 4 componentes e a faixa espectral (Ss <= Se <= 63)
+            if (size < 1 || p[0] < 1 || p[0] > 4 || size != 4 + 2 * static_cast<size_t>(p[0])) return false;
+            const uint8_t* spectral = p + 1 + 2 * p[0];
+            return spectral[0] <= spectral[1] && spectral[1] <= 63 &&
+                   (spectral[2] >> 4) <= 13 && (spectral[2] & 0x0F) <= 13;
+        }
+        default:
+            break;  // COM e APPn: conteúdo livre
+    }
+
+    // Fora do SOS, o segmento é seguido diretamente pelo próximo marcador
+    uint8_t next;
+    return read(position + 2 + length, &next, 1) && next == 0xFF;
+}
+
+bool LengthResolver::resolve_jpeg(size_t start, size_t& end) {
+    const size_t limit = file_size_ - start > scan_limit_ ? start + scan_limit_ : file_size_;
+    size_t position = start + 2;
+    size_t verified = position;
+    size_t segments = 0;
+    bool scanned = false;
+
+    // Depois de dois segmentos válidos a estrutura é crível: uma falha adiante
+    // indica fragmentação, não um falso positivo do cabeçalho
+    auto reject = [&]() {
+        return segments >= 2 ? fail(position, verified) : false;
+    };
+
+    for (size_t step = 0; step < MAX_STEPS && position < limit; ++step) {
+        uint8_t marker[4];
+        if (!read(position, marker, 2)) {
+            return false;
+        }
+        if (marker[0] != 0xFF) {
+            return reject();
+        }
+
+        uint8_t code = marker[1];
+        if (code == 0xFF) {
+            position++;     // Preenchimento antes do marcador
+            continue;
+        }
+        if (code == 0xD9) {
+            // EOI: a miniatura EXIF fica dentro do APP1 e não encerra a imagem
+            end = position + 2;
+            return scanned;
+        }
+        if ((code >= 0xD0 && code <= 0xD7) || code == 0x01) {
+            position += 2;
+            continue;
+        }
+        if (code < 0xC0 || code == 0xD8) {
+            return reject();    // Marcadores reservados não aparecem em um JPEG válido
+        }
+
+        if (!read(position + 2, marker + 2, 2)) {
+            return false;
+        }
+        size_t length = read_be16(marker + 2);
+        if (length < 2) {
+            return reject();
+        }
+        // Depois de um scan, o ponto confirmado fica na entrada dos dados
+        // comprimidos até que um segmento legal e consistente apareça; assim o
+        // corte do fragmento continua entre ele e a falha
+        if (scanned && !is_valid_jpeg_segment(code, position, length)) {
+            return reject();
+        }
+        position += 2 + length;
+        verified = position;
+        segments++;
+
+        if (code == 0xDA) {
+            scanned = true;
+            uint8_t restart = 0;
+            if (!skip_entropy_data(position, limit, restart)) {
+                return position < limit ? reject() : false;
+            }
+        }
+    }
+    return false;
+}
+
+bool LengthResolver::resolve_png(size_t start, size_t& end) {
+    size_t position = start + 8;
+
+    for (size_t step = 0; step < MAX_STEPS; ++step) {
+        uint8_t chunk[8];
+        if (!read(position, chunk, sizeof(chunk))) {
+            return false;
+        }
+
+        uint32_t length = read_be32(chunk);
+        if (length > 0x7FFFFFFF || !is_fourcc(chunk + 4) || chunk[4] == ' ') {
+            return false;
+        }
+        if (step == 0 && (std::memcmp(chunk + 4, "IHDR", 4) != 0 || length != 13)) {
+            return false;
+        }
+
+        // Comprimento + tipo + dados + CRC
+        size_t next = position + 12 + length;
+        if (next > file_size_) {
+            return false;
+        }
+        if (std::memcmp(chunk + 4, "IEND", 4) == 0) {
+            end = next;
+            return true;
+        }
+        position = next;
+    }
+    return false;
+}
+
+bool LengthResolver::resolve_bmp(size_t start, size_t& end) {
+    uint8_t header[30];
+    if (!read(start, header, sizeof(header))) {
+        return false;
+    }
+
+    uint32_t size = read_le32(header + 2);
+    uint32_t data_offset = read_le32(header + 10);
+    uint32_t dib_size = read_le32(header + 14);
+
+    if (read_le32(header + 6) != 0) {
+        return false;   // Campos reservados
+    }
+    if (dib_size != 12 && dib_size != 40 && dib_size != 52 && dib_size != 56 &&
+        dib_size != 64 && dib_size != 108 && dib_size != 124) {
+        return false;
+    }
+    if (data_offset < 14 + dib_size || data_offset >= size) {
+        return false;
+    }
+
+    // BITMAPCOREHEADER usa campos de 16 bits para as dimensões
+    uint16_t planes = dib_size == 12 ? read_le16(header + 22) : read_le16(header + 26);
+    uint16_t bits = dib_size == 12 ? read_le16(header + 24) : read_le16(header + 28);
+    if (planes != 1 || (bits != 1 && bits != 2 && bits != 4 && bits != 8 &&
+                        bits != 16 && bits != 24 && bits != 32 && bits != 64)) {
+        return false;
+    }
+
+    if (size > file_size_ - start) {
+        return false;
+    }
+    end = start + size;
+    return true;
+}
+
+bool LengthResolver::resolve_riff(size_t start, size_t& end) {
+    uint8_t header[12];
+    if (!read(start, header, sizeof(header))) {
+        return false;
+    }
+
+    // O campo não conta o identificador "RIFF" nem o próprio campo
+    uint64_t size = static_cast<uint64_t>(read_le32(header + 4)) + 8;
+    if (size < 12 || !is_fourcc(header + 8) || size > file_size_ - start) {
+        return false;
+    }
+    end = start + static_cast<size_t>(size);
+    return true;
+}
+
+bool LengthResolver::resolve_mp4(size_t start, size_t& end) {
+    size_t position = start;
+    bool has_movie = false;
+
+    for (size_t step = 0; step < MAX_STEPS && position < file_size_; ++step) {
+        uint8_t box[16];
+        if (!read(position, box, 8) || !is_mp4_top_level_box(box + 4)) {
+            if (step == 0) return false;
+            break;  // Fim da cadeia: dados seguintes não pertencem ao arquivo
+        }
+        if (step == 0 && std::memcmp(box + 4, "ftyp", 4) != 0) {
+            return false;
+        }
+
+        uint64_t size = read_be32(box);
+        if (size == 1) {
+            if (!read(position + 8, box + 8, 8)) return false;
+            size = read_be64(box + 8);
+            if (size < 16) return false;
+        } else if (size == 0) {
+            size = file_size_ - position;   // Box vai até o fim do arquivo
+        } else if (size < 8) {
+            return false;
+        }
+        if (size > file_size_ - position) {
+            return false;   // Arquivo truncado
+        }
+
+        if (std::memcmp(box + 4, "moov", 4) == 0 || std::memcmp(box + 4, "moof", 4) == 0) {
+            has_movie = true;
+        }
+        position += static_cast<size_t>(size);
+    }
+
+    if (!has_movie) {
+        return false;
+    }
+    end = position;
+    return true;
+}
+
+bool LengthResolver::resolve_sqlite(size_t start, size_t& end) {
+    uint8_t header[100];
+    if (!read(start, header, sizeof(header))) {
+        return false;
+    }
+
+    uint32_t page_size = read_be16(header + 16);
+    if (page_size == 1) {
+        page_size = 65536;
+    }
+    if (page_size < 512 || page_size > 65536 || (page_size & (page_size - 1)) != 0) {
+        return false;
+    }
+    if (header[21] != 64 || header[22] != 32 || header[23] != 32) {
+        return false;   // Frações de payload fixas pelo formato
+    }
+
+    // O número de páginas só é confiável se gravado pela mesma versão do contador de alterações
+    uint32_t page_count = read_be32(header + 28);
+    if (page_count == 0 || read_be32(header + 24) != read_be32(header + 92)) {
+        return false;
+    }
+
+    uint64_t size = static_cast<uint64_t>(page_size) * page_count;
+    if (size > file_size_ - start) {
+        return false;
+    }
+    end = start + static_cast<size_t>(size);
+    return true;
+}
+
+bool LengthResolver::resolve_pe(size_t start, size_t& end) {
+    uint8_t dos_header[64];
+    if (!read(start, dos_header, sizeof(dos_header))) {
+        return false;
+    }
+
+    uint32_t pe_offset = read_le32(dos_header + 0x3C);
+    if (pe_offset < sizeof(dos_header) || pe_offset > 0x10000) {
+        return false;
+    }
+
+    uint8_t file_header[24];
+    if (!read(start + pe_offset, file_header, sizeof(file_header)) ||
+        std::memcmp(file_header, "PE\0\0", 4) != 0) {
+        return false;
+    }
+
+    uint16_t section_count = read_le16(file_header + 6);
+    uint16_t optional_size = read_le16(file_header + 20);
+    if (section_count == 0 || section_count > 96 || optional_size < 64) {
+        return false;
+    }
+
+    uint8_t optional_header[240] = {};
+    if (!read(start + pe_offset + 24, optional_header, std::min<size_t>(optional_size, sizeof(optional_header)))) {
+        return false;
+    }
+
+    size_t directories;
+    switch (read_le16(optional_header)) {
+        case 0x10B: directories = 96; break;     // PE32
+        case 0x20B: directories = 112; break;    // PE32+
+        default: return false;
+    }
+
+    uint64_t image_end = read_le32(optional_header + 60);   // SizeOfHeaders
+
+    // A assinatura Authenticode fica após as seções; o diretório guarda o offset no arquivo
+    if (optional_size >= directories + 40 && read_le32(optional_header + directories - 4) > 4) {
+        uint32_t certificate_offset = read_le32(optional_header + directories + 32);
+        uint32_t certificate_size = read_le32(optional_header + directories + 36);
+        if (certificate_size > 0) {
+            image_end = std::max<uint64_t>(image_end, static_cast<uint64_t>(certificate_offset) + certificate_size);
+        }
+    }
+
+    // Tabela de seções na pilha: no máximo 96 entradas de 40 bytes
+    uint8_t sections[96 * 40];
+    if (!read(start + pe_offset + 24 + optional_size, sections, static_cast<size_t>(section_count) * 40)) {
+        return false;
+    }
+    for (size_t i = 0; i < section_count; ++i) {
+        const uint8_t* section = sections + i * 40;
+        uint32_t raw_size = read_le32(section + 16);
+        uint32_t raw_offset = read_le32(section + 20);
+        if (raw_size > 0) {
+            image_end = std::max<uint64_t>(image_end, static_cast<uint64_t>(raw_offset) + raw_size);
+        }
+    }
+
+    if (image_end < pe_offset + 24 + optional_size || image_end > file_size_ - start) {
+        return false;
+    }
+    end = start + static_cast<size_t>(image_end);
+    return true;
+}
+
+bool LengthResolver::resolve_zip(size_t start, size_t& end) {
+    size_t position = start;
+    size_t verified = start;
+    size_t step = 0;
+    uint8_t record[46];
+
+    // Entradas locais: cabeçalho + nome + extra + dados comprimidos
+    for (; step < MAX_STEPS; ++step) {
+        if (!read(position, record, 4)) return false;
+        if (read_le32(record) != ZIP_LOCAL_HEADER) break;
+        if (!read(position, record, 30)) return false;
+
+        uint16_t flags = read_le16(record + 6);
+        uint32_t compressed_size = read_le32(record + 18);
+        // Com descritor de dados (bit 3) ou ZIP64 o tamanho não está no cabeçalho local
+        if ((flags & 0x0008) != 0 || compressed_size == 0xFFFFFFFF) {
+            return false;
+        }
+        verified = position + 30;
+        size_t data_start = position + 30 + static_cast<size_t>(read_le16(record + 26)) + read_le16(record + 28);
+        position = data_start + compressed_size;
+
+        // Hipótese de fragmentação com o corte dentro de uma entrada armazenada
+        // (sem compressão): o CRC distingue o ponto de corte correto
+        if (split_ > data_start && split_ < position && read_le16(record + 8) == 0 &&
+            !crc_matches(data_start, compressed_size, read_le32(record + 14))) {
+            return false;
+        }
+    }
+    if (position == start) {
+        return false;
+    }
+
+    // A partir daqui a estrutura é crível: a falha aponta para um corte
+    // dentro dos dados da última entrada lida
+    const size_t directory_start = position;
+    for (; step < MAX_STEPS; ++step) {
+        if (!read(position, record, 4)) return false;
+        if (read_le32(record) != ZIP_CENTRAL_HEADER) break;
+        if (!read(position, record, 46)) return false;
+        verified = position;
+        position += 46 + static_cast<size_t>(read_le16(record + 28)) + read_le16(record + 30) + read_le16(record + 32);
+    }
+
+    // Registros ZIP64 opcionais antes do EOCD
+    if (!read(position, record, 4)) return false;
+    if (read_le32(record) == ZIP64_END_RECORD) {
+        if (!read(position, record, 12)) return false;
+        position += 12 + static_cast<size_t>(read_le64(record + 4));
+        if (!read(position, record, 4)) return false;
+    }
+    if (read_le32(record) == ZIP64_END_LOCATOR) {
+        position += 20;
+        if (!read(position, record, 4)) return false;
+    }
+
+    if (read_le32(record) != ZIP_END_RECORD) {
+        return fail(position, verified);
+    }
+    if (!read(position, record, 22)) {
+        return false;
+    }
+
+    uint32_t directory_offset = read_le32(record + 16);
+    if (directory_offset != 0xFFFFFFFF && directory_offset != directory_start - start) {
+        return fail(position, verified);
+    }
+
+    size_t archive_end = position + 22 + read_le16(record + 20);
+    if (archive_end > file_size_) {
+        return false;
+    }
+    end = archive_end;
+    return true;
+}
+
+bool LengthResolver::crc_matches(size_t position, size_t size, uint32_t expected) {
+    uint32_t crc = 0xFFFFFFFFu;
+    while (size > 0) {
+        size_t available;
+        const uint8_t* data = view(position, std::min(size, SCAN_BLOCK_SIZE), available);
+        if (!data) {
+            return false;
+        }
+        available = std::min(available, size);
+        for (size_t k = 0; k < available; ++k) {
+            crc = CRC32_TABLE.entries[(crc ^ data[k]) & 0xFF] ^ (crc >> 8);
+        }
+        position += available;
+        size -= available;
+    }
+    return (crc ^ 0xFFFFFFFFu) == expected;
+}
+
+bool LengthResolver::is_object_at(size_t position, size_t number) {
+    // "<número> <geração> obj"; number = SIZE_MAX aceita qualquer número
+    uint8_t text[32];
+    if (position >= file_size_) {
+        return false;
+    }
+    size_t length = std::min(sizeof(text), file_size_ - position);
+    if (length < 7 || !read(position, text, length)) {
+        return false;
+    }
+
+    size_t i = 0;
+    size_t value = 0;
+    if (!is_digit(text[0])) return false;
+    while (i < length && is_digit(text[i])) value = value * 10 + (text[i++] - '0');
+    if (number != SIZE_MAX && value != number) return false;
+
+    if (i >= length || !is_pdf_space(text[i])) return false;
+    while (i < length && is_pdf_space(text[i])) i++;
+    if (i >= length || !is_digit(text[i])) return false;
+    while (i < length && is_digit(text[i])) i++;
+    if (i >= length || !is_pdf_space(text[i])) return false;
+    while (i < length && is_pdf_space(text[i])) i++;
+
+    return length - i >= 3 && std::memcmp(text + i, "obj", 3) == 0;
+}
+
+bool LengthResolver::read_startxref(size_t start, size_t eof, size_t& xref) {
+    // "startxref <offset>" fica nas últimas linhas antes do %%EOF
+    uint8_t text[64];
+    size_t begin = eof - start > sizeof(text) ? eof - sizeof(text) : start;
+    size_t length = eof - begin;
+    if (!read(begin, text, length)) {
+        return false;
+    }
+
+    size_t keyword = SIZE_MAX;
+    for (size_t i = 0; i + 9 <= length; ++i) {
+        if (std::memcmp(text + i, "startxref", 9) == 0) keyword = i;
+    }
+    if (keyword == SIZE_MAX) {
+        return false;
+    }
+
+    size_t i = keyword + 9;
+    while (i < length && is_pdf_space(text[i])) i++;
+    if (i >= length || !is_digit(text[i])) {
+        return false;
+    }
+    xref = 0;
+    while (i < length && is_digit(text[i])) xref = xref * 10 + (text[i++] - '0');
+    return xref > 0 && xref < eof - start;
+}
+
+bool LengthResolver::validate_xref(size_t start, size_t xref) {
+    uint8_t text[32];
+    if (!read(xref, text, 4)) {
+        return fail(xref, start);
+    }
+    if (std::memcmp(text, "xref", 4) != 0) {
+        // Tabela em stream (PDF 1.5+): os offsets estão comprimidos, basta o objeto existir
+        return is_object_at(xref, SIZE_MAX) ? true : fail(xref, start);
+    }
+
+    size_t position = xref + 4;
+    size_t first_bad = SIZE_MAX;
+    std::vector<size_t> good;
+    size_t entries = 0;
+
+    // Subseções "<primeiro> <quantidade>" seguidas de entradas de 20 bytes, até o "trailer"
+    while (entries < MAX_XREF_ENTRIES) {
+        size_t length = std::min(sizeof(text), file_size_ - std::min(position, file_size_));
+        if (length < 7 || !read(position, text, length)) {
+            return fail(position, start);
+        }
+
+        size_t i = 0;
+        while (i < length && is_pdf_space(text[i])) i++;
+        if (length - i >= 7 && std::memcmp(text + i, "trailer", 7) == 0) {
+            break;
+        }
+
+        size_t first = 0, count = 0;
+        if (i >= length || !is_digit(text[i])) return fail(position + i, start);
+        while (i < length && is_digit(text[i])) first = first * 10 + (text[i++] - '0');
+        if (i >= length || text[i] != ' ') return fail(position + i, start);
+        i++;
+        if (i >= length || !is_digit(text[i])) return fail(position + i, start);
+        while (i < length && is_digit(text[i])) count = count * 10 + (text[i++] - '0');
+        while (i < length && is_pdf_space(text[i])) i++;
+        position += i;
+
+        for (size_t k = 0; k < count && entries < MAX_XREF_ENTRIES; ++k, ++entries) {
+            uint8_t entry[20];
+            if (!read(position, entry, sizeof(entry)) || (entry[17] != 'n' && entry[17] != 'f')) {
+                return fail(position, start);
+            }
+            position += sizeof(entry);
+
+            if (entry[17] != 'n') continue;
+            size_t offset = 0;
+            for (size_t d = 0; d < 10; ++d) {
+                if (!is_digit(entry[d])) return fail(position - sizeof(entry), start);
+                offset = offset * 10 + (entry[d] - '0');
+            }
+            if (offset == 0) continue;
+
+            if (start + offset < file_size_ && is_object_at(start + offset, first + k)) {
+                good.push_back(start + offset);
+            } else {
+                first_bad = std::min(first_bad, start + offset);
+            }
+        }
+    }
+
+    if (first_bad != SIZE_MAX) {
+        // O corte fica entre o último objeto válido anterior e o primeiro inválido
+        size_t verified = start;
+        for (size_t offset : good) {
+            if (offset < first_bad) verified = std::max(verified, offset);
+        }
+        return fail(first_bad, verified);
+    }
+    return true;
+}
+
+bool LengthResolver::resolve_pdf(size_t start, size_t& end) {
+    const size_t limit = file_size_ - start > scan_limit_ ? start + scan_limit_ : file_size_;
+    size_t position = start + 5;
+    bool found = false;
+
+    for (size_t step = 0; step < MAX_STEPS; ++step) {
+        size_t eof = find_text(position, limit, "%%EOF", 5);
+        if (eof == SIZE_MAX) {
+            break;
+        }
+
+        size_t xref;
+        if (!read_startxref(start, eof, xref)) {
+            position = eof + 5;     // %%EOF sem trailer (ex: dentro de um stream)
+            continue;
+        }
+        if (!validate_xref(start, start + xref)) {
+            if (!found) {
+                return false;
+            }
+            failure_ = 0;   // Dados seguintes não são uma atualização deste documento
+            break;
+        }
+
+        // Atualizações incrementais acrescentam outro trailer e outro %%EOF adiante
+        end = eof + 5;
+        uint8_t eol;
+        if (read(end, &eol, 1) && eol == '\r') end++;
+        if (read(end, &eol, 1) && eol == '\n') end++;
+        found = true;
+        position = end;
+    }
+    return found;
+}
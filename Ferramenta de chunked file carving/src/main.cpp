@@ -88,22 +88,13 @@ void display_final_statistics(const FileCarver& carver, double elapsed_time) {
  * @param carver Instância do file carver
  */
 void display_file_type_summary(const FileCarver& carver) {
-    const auto& carved_files = carver.get_carved_files();
+    const auto& type_totals = carver.get_type_totals();
     
-    if (carved_files.empty()) {
+    if (type_totals.empty()) {
         std::cout << "\nNenhum arquivo foi encontrado." << std::endl;
         return;
     }
     
-    // Conta tipos de arquivo
-    std::map<std::string, size_t> type_counts;
-    std::map<std::string, size_t> type_sizes;
-    
-    for (const auto& file : carved_files) {
-        type_counts[file.type]++;
-        type_sizes[file.type] += file.file_size;
-    }
-    
     std::cout << "\nRESUMO POR TIPO DE ARQUIVO:" << std::endl;
     std::cout << std::string(50, '-') << std::endl;
     std::cout << std::left << std::setw(10) << "Tipo" 
@@ -111,10 +102,10 @@ void display_file_type_summary(const FileCarver& carver) {
               << std::setw(15) << "Tamanho Total" << std::endl;
     std::cout << std::string(50, '-') << std::endl;
     
-    for (const auto& pair : type_counts) {
+    for (const auto& pair : type_totals) {
         std::cout << std::left << std::setw(10) << pair.first
-                  << std::setw(10) << pair.second
-                  << std::setw(15) << format_bytes(type_sizes[pair.first]) << std::endl;
+                  << std::setw(10) << pair.second.count
+                  << std::setw(15) << format_bytes(pair.second.bytes) << std::endl;
     }
     std::cout << std::string(50, '-') << std::endl;
 }
@@ -147,8 +138,38 @@ void configure_carver(FileCarver& carver, const CarverConfig& config) {
     carver.set_min_file_size(config.min_file_size);
     carver.set_max_file_size(config.max_file_size);
     carver.set_extract_files(config.extract_files);
+    carver.set_hashing(config.hash_files, config.hash_sha256);
+    if (config.dedup == "skip") {
+        carver.set_dedup(DedupMode::SKIP);
+    } else if (config.dedup == "link") {
+        carver.set_dedup(DedupMode::LINK);
+    } else {
+        carver.set_dedup(DedupMode::NONE);
+    }
     carver.set_use_footers(config.use_footers);
+    carver.set_use_structure(config.use_structure);
+    carver.set_bifragment(config.bifragment, config.max_gap);
+    carver.set_skip_carved(config.skip_carved);
     carver.set_search_window(config.search_window);
+    carver.set_chunk_size(config.chunk_size);
+    carver.set_overlap_size(config.overlap_size);
+    carver.set_simd_level(config.simd_level);
+    carver.set_num_threads(config.threads);
+    carver.set_extraction_writers(config.writers, config.write_queue);
+    if (config.use_mmap) {
+        carver.set_reader_backend(ReaderBackend::MMAP);
+    } else if (config.use_direct) {
+        carver.set_reader_backend(ReaderBackend::DIRECT);
+    } else {
+        carver.set_reader_backend(ReaderBackend::STREAM);
+    }
+    carver.set_io_depth(config.io_depth);
+    carver.set_huge_pages(config.huge_pages);
+    carver.set_block_alignment(config.block_size, config.block_offset);
+    for (const auto& region : config.unaligned_regions) {
+        carver.add_unaligned_region(region.first, region.second);
+    }
+    carver.set_block_classification(config.skip_uniform_blocks, config.skip_entropy_blocks, config.block_map_file);
     
     // Configura callback de progresso se não estiver em modo verbose
     if (!config.verbose) {
@@ -159,29 +180,35 @@ void configure_carver(FileCarver& carver, const CarverConfig& config) {
     LOG_DEBUG("Tamanho mínimo: " + std::to_string(config.min_file_size) + " bytes");
     LOG_DEBUG("Tamanho máximo: " + (config.max_file_size == 0 ? "Sem limite" : std::to_string(config.max_file_size) + " bytes"));
     LOG_DEBUG("Janela de busca: " + std::to_string(config.search_window) + " bytes");
+    LOG_DEBUG(std::string("Kernel SIMD: ") + simd_level_name(config.simd_level));
 }
 
 /**
- * @brief Gera relatórios conforme configuração
+ * @brief Abre os relatórios pedidos, gravados à medida que os arquivos são aceitos
  * @param carver Instância do file carver
  * @param config Configuração da aplicação
+ * @return false se algum relatório não pôde ser criado
  */
-void generate_reports(const FileCarver& carver, const CarverConfig& config) {
-    if (config.generate_report) {
-        if (carver.generate_report(config.report_file)) {
-            LOG_INFO("Relatório gerado: " + config.report_file);
-        } else {
-            LOG_ERROR("Erro ao gerar relatório: " + config.report_file);
-        }
-    }
+bool open_reports(FileCarver& carver, const CarverConfig& config) {
+    const std::pair<bool, std::pair<ReportFormat, std::string>> reports[] = {
+        {config.generate_report, {ReportFormat::TEXT, config.report_file}},
+        {config.generate_csv, {ReportFormat::CSV, config.csv_file}},
+        {config.generate_ndjson, {ReportFormat::NDJSON, config.ndjson_file}},
+        {config.generate_store, {ReportFormat::STORE, config.store_file}},
+    };
     
-    if (config.generate_csv) {
-        if (carver.generate_csv_report(config.csv_file)) {
-            LOG_INFO("Relatório CSV gerado: " + config.csv_file);
-        } else {
-            LOG_ERROR("Erro ao gerar relatório CSV: " + config.csv_file);
+    for (const auto& report : reports) {
+        if (!report.first) continue;
+        
+        auto sink = ResultSink::create(report.second.first, report.second.second);
+        if (!sink) {
+            LOG_ERROR("Erro ao criar relatório: " + report.second.second);
+            return false;
         }
+        LOG_DEBUG("Relatório aberto: " + report.second.second);
+        carver.add_result_sink(std::move(sink));
     }
+    return true;
 }
 
 int main(int argc, char* argv[]) {
@@ -216,6 +243,26 @@ int main(int argc, char* argv[]) {
         FileCarver carver(config.output_directory);
         configure_carver(carver, config);
         
+        if (!config.signatures_file.empty()) {
+            if (!carver.load_signatures(config.signatures_file)) {
+                LOG_ERROR("Erro ao carregar assinaturas: " + config.signatures_file);
+                return 1;
+            }
+            LOG_DEBUG("Assinaturas carregadas: " + config.signatures_file);
+        }
+        
+        if (!config.known_hashes_file.empty()) {
+            if (!carver.load_known_hashes(config.known_hashes_file)) {
+                LOG_ERROR("Erro ao carregar banco de hashes: " + config.known_hashes_file);
+                return 1;
+            }
+        }
+        
+        // Relatórios são gravados durante a varredura
+        if (!open_reports(carver, config)) {
+            return 1;
+        }
+        
         // Marca tempo de início
         auto start_time = std::chrono::high_resolution_clock::now();
         
@@ -245,9 +292,6 @@ int main(int argc, char* argv[]) {
         display_final_statistics(carver, elapsed_seconds);
         display_file_type_summary(carver);
         
-        // Gera relatórios
-        generate_reports(carver, config);
-        
         std::cout << "\nProcesso concluído com sucesso!" << std::endl;
         
     } catch (const std::exception& e) {
@@ -0,0 +1,192 @@
+#include "pattern_searcher.h"
+#include <cstring>
+#include <cstdint>
+
+#if CARVER_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace {
+
+#if CARVER_X86_SIMD
+
+/**
+ * Os kernels devolvem a primeira ocorrência confirmada ou SIZE_MAX; em
+ * resume fica a primeira posição ainda não examinada (final do buffer).
+ */
+
+CARVER_TARGET("sse2")
+size_t find_sse2(const uint8_t* data, size_t size, const uint8_t* needle, size_t length, size_t& resume) {
+    const __m128i first = _mm_set1_epi8(static_cast<char>(needle[0]));
+    const __m128i last = _mm_set1_epi8(static_cast<char>(needle[length - 1]));
+
+    size_t i = 0;
+    for (; i + length - 1 + 16 <= size; i += 16) {
+        __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + length - 1));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last))));
+
+        while (mask) {
+            size_t pos = i + count_trailing_zeros(mask);
+            if (std::memcmp(data + pos + 1, needle + 1, length - 2) == 0) return pos;
+            mask &= mask - 1;
+        }
+    }
+
+    resume = i;
+    return SIZE_MAX;
+}
+
+CARVER_TARGET("avx2")
+size_t find_avx2(const uint8_t* data, size_t size, const uint8_t* needle, size_t length, size_t& resume) {
+    const __m256i first = _mm256_set1_epi8(static_cast<char>(needle[0]));
+    const __m256i last = _mm256_set1_epi8(static_cast<char>(needle[length - 1]));
+
+    // Dois blocos por iteração: o filtro raramente dispara e o laço fica limitado pela carga
+    size_t i = 0;
+    for (; i + length - 1 + 64 <= size; i += 64) {
+        __m256i first_lo = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), first);
+        __m256i first_hi = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32)), first);
+        __m256i last_lo = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + length - 1)), last);
+        __m256i last_hi = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + length + 31)), last);
+        uint64_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(first_lo, last_lo))) |
+                        static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(first_hi, last_hi)))) << 32;
+
+        while (mask) {
+            size_t pos = i + count_trailing_zeros(mask);
+            if (std::memcmp(data + pos + 1, needle + 1, length - 2) == 0) return pos;
+            mask &= mask - 1;
+        }
+    }
+
+    resume = i;
+    return SIZE_MAX;
+}
+
+CARVER_TARGET("avx512f,avx512bw")
+size_t find_avx512(const uint8_t* data, size_t size, const uint8_t* needle, size_t length, size_t& resume) {
+    const __m512i first = _mm512_set1_epi8(static_cast<char>(needle[0]));
+    const __m512i last = _mm512_set1_epi8(static_cast<char>(needle[length - 1]));
+
+    size_t i = 0;
+    for (; i + length - 1 + 64 <= size; i += 64) {
+        __m512i block_first = _mm512_loadu_si512(data + i);
+        __m512i block_last = _mm512_loadu_si512(data + i + length - 1);
+        uint64_t mask = _mm512_mask_cmpeq_epi8_mask(_mm512_cmpeq_epi8_mask(block_first, first), block_last, last);
+
+        while (mask) {
+            size_t pos = i + count_trailing_zeros(mask);
+            if (std::memcmp(data + pos + 1, needle + 1, length - 2) == 0) return pos;
+            mask &= mask - 1;
+        }
+    }
+
+    resume = i;
+    return SIZE_MAX;
+}
+
+#endif
+
+} // namespace
+
+PatternSearcher::PatternSearcher()
+    : simd_level_(detect_simd_level()) {
+    for (auto& shift : shift_) shift = 1;
+}
+
+PatternSearcher::PatternSearcher(const std::vector<uint8_t>& pattern)
+    : simd_level_(detect_simd_level()) {
+    build(pattern);
+}
+
+void PatternSearcher::build(const std::vector<uint8_t>& pattern) {
+    pattern_ = pattern;
+    if (pattern_.empty()) {
+        return;     // find() não consulta as tabelas de um padrão vazio
+    }
+
+    // Horspool: distância do último byte do padrão até a ocorrência mais à direita do byte
+    size_t length = pattern_.size();
+    for (auto& shift : shift_) shift = length > 0 ? length : 1;
+    for (size_t k = 0; k + 1 < length; ++k) {
+        shift_[pattern_[k]] = length - 1 - k;
+    }
+}
+
+size_t PatternSearcher::find_horspool(const uint8_t* data, size_t size) const {
+    const size_t length = pattern_.size();
+    const size_t last = length - 1;
+    const uint8_t last_byte = pattern_[last];
+
+    size_t i = 0;
+    while (i + length <= size) {
+        uint8_t c = data[i + last];
+        if (c == last_byte && std::memcmp(data + i, pattern_.data(), last) == 0) {
+            return i;
+        }
+        i += shift_[c];
+    }
+    return SIZE_MAX;
+}
+
+size_t PatternSearcher::find(const uint8_t* data, size_t size) const {
+    const size_t length = pattern_.size();
+    if (length == 0 || size < length) {
+        return SIZE_MAX;
+    }
+
+    if (length == 1) {
+        const void* hit = std::memchr(data, pattern_[0], size);
+        return hit ? static_cast<size_t>(static_cast<const uint8_t*>(hit) - data) : SIZE_MAX;
+    }
+
+#if CARVER_X86_SIMD
+    if (length <= MAX_SIMD_PATTERN && simd_level_ != SimdLevel::SCALAR) {
+        size_t resume = 0;
+        size_t found;
+        switch (simd_level_) {
+            case SimdLevel::AVX512: found = find_avx512(data, size, pattern_.data(), length, resume); break;
+            case SimdLevel::AVX2: found = find_avx2(data, size, pattern_.data(), length, resume); break;
+            default: found = find_sse2(data, size, pattern_.data(), length, resume); break;
+        }
+        if (found != SIZE_MAX) {
+            return found;
+        }
+
+        // Final do buffer, menor que um bloco vetorial
+        found = find_horspool(data + resume, size - resume);
+        return found != SIZE_MAX ? resume + found : SIZE_MAX;
+    }
+#endif
+
+    // Padrões muito curtos dão saltos pequenos no Horspool: o memchr da libc
+    // (vetorizado) localiza o primeiro byte mais rápido
+    if (length <= 4) {
+        const uint8_t* cursor = data;
+        const uint8_t* end = data + size - length + 1;
+        while (cursor < end) {
+            const uint8_t* hit = static_cast<const uint8_t*>(std::memchr(cursor, pattern_[0], static_cast<size_t>(end - cursor)));
+            if (!hit) break;
+            if (std::memcmp(hit + 1, pattern_.data() + 1, length - 1) == 0) {
+                return static_cast<size_t>(hit - data);
+            }
+            cursor = hit + 1;
+        }
+        return SIZE_MAX;
+    }
+
+    return find_horspool(data, size);
+}
+
+const std::vector<uint8_t>& PatternSearcher::get_pattern() const {
+    return pattern_;
+}
+
+void PatternSearcher::set_simd_level(SimdLevel level) {
+    simd_level_ = clamp_simd_level(level);
+}
+
+SimdLevel PatternSearcher::get_simd_level() const {
+    return simd_level_;
+}
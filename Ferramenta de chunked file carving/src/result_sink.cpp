@@ -0,0 +1,465 @@
+#include "result_sink.h"
+#include "result_store.h"
+#include "file_carver.h"
+#include "content_hash.h"
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CARVER_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#define CARVER_HAVE_MMAP 0
+#endif
+
+namespace {
+
+std::string to_hex(size_t value) {
+    std::ostringstream oss;
+    oss << "0x" << std::hex << value;
+    return oss.str();
+}
+
+/**
+ * @brief Relatório de texto: cabeçalho, um bloco por arquivo e resumo no fim
+ */
+class TextReportSink : public ResultSink {
+public:
+    using ResultSink::ResultSink;
+
+protected:
+    void write_header() override {
+        std::ostringstream out;
+        out << "=== RELATÓRIO DE FILE CARVING ===\n";
+        out << "Data: " << std::chrono::system_clock::now().time_since_epoch().count() << "\n\n";
+        out << "DETALHES DOS ARQUIVOS:\n";
+        out << std::string(80, '-') << "\n";
+        append(out.str());
+    }
+
+    void write_file(const CarvedFile& file) override {
+        std::ostringstream out;
+        out << "Arquivo: " << file.filename << "\n";
+        out << "  Tipo: " << file.type << "\n";
+        out << "  Offset inicial: " << to_hex(file.start_offset) << " (" << file.start_offset << ")\n";
+        out << "  Offset final: " << to_hex(file.end_offset) << " (" << file.end_offset << ")\n";
+        out << "  Tamanho: " << file.file_size << " bytes\n";
+        out << "  Footer válido: " << (file.has_valid_footer ? "Sim" : "Não") << "\n";
+        out << "  Tamanho pela estrutura: " << (file.structure_resolved ? "Sim" : "Não") << "\n";
+        if (!file.fragments.empty()) {
+            out << "  Fragmentos:";
+            for (const auto& fragment : file.fragments) {
+                out << " " << to_hex(fragment.first) << "-" << to_hex(fragment.second);
+            }
+            out << "\n";
+        }
+        if (file.parent_offset != SIZE_MAX) {
+            out << "  Contido em: " << to_hex(file.parent_offset) << " (" << file.parent_offset << ")\n";
+        }
+        if (file.hashed) {
+            out << "  Hash XXH3: " << format_hash64(file.content_hash) << "\n";
+        }
+        if (!file.sha256.empty()) {
+            out << "  SHA-256: " << file.sha256 << "\n";
+        }
+        if (!file.duplicate_of.empty()) {
+            out << "  Duplicado de: " << file.duplicate_of << "\n";
+        }
+        out << "  Extraído: " << (file.extracted ? "Sim" : "Não") << "\n\n";
+        append(out.str());
+    }
+
+    void write_summary(const CarvingSummary& summary) override {
+        std::ostringstream out;
+        out << std::string(80, '-') << "\n";
+        out << "RESUMO:\n";
+        out << "Arquivos encontrados: " << summary.files_found << "\n";
+        out << "Arquivos extraídos: " << summary.files_extracted << "\n";
+        out << "Bytes processados: " << summary.bytes_processed << "\n";
+        for (const auto& type : summary.types) {
+            out << "  " << type.first << ": " << type.second.count << " arquivos, "
+                << type.second.bytes << " bytes\n";
+        }
+        if (summary.blocks_classified) {
+            out << "Blocos: " << summary.blocks.data << " dados, " << summary.blocks.zero << " zerados, "
+                << summary.blocks.uniform << " uniformes, " << summary.blocks.high_entropy << " alta entropia\n";
+        }
+        append(out.str());
+    }
+};
+
+/**
+ * @brief Relatório CSV: uma linha por arquivo, sem resumo
+ */
+class CsvReportSink : public ResultSink {
+public:
+    using ResultSink::ResultSink;
+
+protected:
+    static std::string escape(const std::string& value) {
+        if (value.find_first_of(",\"\r\n") == std::string::npos) {
+            return value;
+        }
+        std::string quoted = "\"";
+        for (char c : value) {
+            if (c == '"') quoted += '"';
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+
+    void write_header() override {
+        append("Arquivo,Tipo,Offset_Inicial,Offset_Final,Tamanho,Footer_Valido,Extraido,"
+               "Tamanho_Estrutura,Contido_Em,Fragmentos,Hash_XXH3,SHA256,Duplicado_De\n");
+    }
+
+    void write_file(const CarvedFile& file) override {
+        std::ostringstream out;
+        out << escape(file.filename) << ","
+            << escape(file.type) << ","
+            << file.start_offset << ","
+            << file.end_offset << ","
+            << file.file_size << ","
+            << (file.has_valid_footer ? "Sim" : "Nao") << ","
+            << (file.extracted ? "Sim" : "Nao") << ","
+            << (file.structure_resolved ? "Sim" : "Nao") << ",";
+        if (file.parent_offset != SIZE_MAX) {
+            out << file.parent_offset;
+        }
+        out << ",";
+        for (size_t i = 0; i < file.fragments.size(); ++i) {
+            out << (i > 0 ? " " : "") << file.fragments[i].first << "-" << file.fragments[i].second;
+        }
+        out << "," << (file.hashed ? format_hash64(file.content_hash) : "")
+            << "," << file.sha256
+            << "," << escape(file.duplicate_of) << "\n";
+        append(out.str());
+    }
+
+    void write_summary(const CarvingSummary& /*summary*/) override {
+        // Linhas de resumo quebrariam a tabela: o CSV só tem os arquivos
+    }
+};
+
+/**
+ * @brief Relatório NDJSON: um objeto por arquivo e um objeto "resumo" na última linha
+ */
+class NdjsonReportSink : public ResultSink {
+public:
+    using ResultSink::ResultSink;
+
+protected:
+    static std::string quote(const std::string& value) {
+        std::string out = "\"";
+        for (unsigned char c : value) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (c < 0x20) {
+                        char escaped[8];
+                        std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                        out += escaped;
+                    } else {
+                        out += static_cast<char>(c);
+                    }
+            }
+        }
+        return out + "\"";
+    }
+
+    void write_header() override {
+    }
+
+    void write_file(const CarvedFile& file) override {
+        std::ostringstream out;
+        out << "{\"arquivo\":" << quote(file.filename)
+            << ",\"tipo\":" << quote(file.type)
+            << ",\"offset_inicial\":" << file.start_offset
+            << ",\"offset_final\":" << file.end_offset
+            << ",\"tamanho\":" << file.file_size
+            << ",\"footer_valido\":" << (file.has_valid_footer ? "true" : "false")
+            << ",\"tamanho_estrutura\":" << (file.structure_resolved ? "true" : "false")
+            << ",\"extraido\":" << (file.extracted ? "true" : "false");
+        if (file.parent_offset != SIZE_MAX) {
+            out << ",\"contido_em\":" << file.parent_offset;
+        }
+        if (!file.fragments.empty()) {
+            out << ",\"fragmentos\":[";
+            for (size_t i = 0; i < file.fragments.size(); ++i) {
+                out << (i > 0 ? "," : "") << "[" << file.fragments[i].first << "," << file.fragments[i].second << "]";
+            }
+            out << "]";
+        }
+        if (file.hashed) {
+            out << ",\"hash_xxh3\":" << quote(format_hash64(file.content_hash));
+        }
+        if (!file.sha256.empty()) {
+            out << ",\"sha256\":" << quote(file.sha256);
+        }
+        if (!file.duplicate_of.empty()) {
+            out << ",\"duplicado_de\":" << quote(file.duplicate_of);
+        }
+        out << "}\n";
+        append(out.str());
+    }
+
+    void write_summary(const CarvingSummary& summary) override {
+        std::ostringstream out;
+        out << "{\"resumo\":{\"arquivos_encontrados\":" << summary.files_found
+            << ",\"arquivos_extraidos\":" << summary.files_extracted
+            << ",\"bytes_processados\":" << summary.bytes_processed
+            << ",\"tipos\":{";
+        bool first = true;
+        for (const auto& type : summary.types) {
+            out << (first ? "" : ",") << quote(type.first) << ":{\"arquivos\":" << type.second.count
+                << ",\"bytes\":" << type.second.bytes << "}";
+            first = false;
+        }
+        out << "}";
+        if (summary.blocks_classified) {
+            out << ",\"blocos\":{\"dados\":" << summary.blocks.data
+                << ",\"zerados\":" << summary.blocks.zero
+                << ",\"uniformes\":" << summary.blocks.uniform
+                << ",\"alta_entropia\":" << summary.blocks.high_entropy << "}";
+        }
+        out << "}}\n";
+        append(out.str());
+    }
+};
+
+/**
+ * @brief Arquivo de resultados binário: registros fixos gravados em fluxo
+ *
+ * A tabela de tipos é gravada depois dos registros e o índice por offset
+ * só no fechamento, ordenando o próprio arquivo mapeado (sem cópia dos
+ * registros em memória). Quando os arquivos já chegaram em ordem de
+ * offset, o índice é a identidade e nenhuma ordenação é feita.
+ */
+class StoreResultSink : public ResultSink {
+public:
+    using ResultSink::ResultSink;
+
+protected:
+    std::map<std::string, uint32_t> type_ids_;
+    std::string strings_;
+    uint64_t record_count_ = 0;
+    uint64_t dropped_count_ = 0;    // Arquivos além do limite do índice de 32 bits
+    uint64_t last_offset_ = 0;
+    bool sorted_ = true;
+    CarvingSummary summary_;
+
+    void write_header() override {
+        // Espaço do cabeçalho, preenchido só quando o arquivo estiver completo
+        append(std::string(sizeof(StoreHeader), '\0'));
+    }
+
+    void write_file(const CarvedFile& file) override {
+        if (record_count_ >= UINT32_MAX) {
+            // Limite do índice de 32 bits: o cabeçalho registra só o que foi gravado
+            if (dropped_count_++ == 0) {
+                std::cerr << "Aviso: limite de " << UINT32_MAX << " registros atingido em " << get_path()
+                          << "; os arquivos seguintes não serão gravados no resultado" << std::endl;
+            }
+            return;
+        }
+
+        auto type = type_ids_.find(file.type);
+        if (type == type_ids_.end()) {
+            type = type_ids_.emplace(file.type, static_cast<uint32_t>(type_ids_.size())).first;
+            uint32_t length = static_cast<uint32_t>(file.type.size());
+            strings_.append(reinterpret_cast<const char*>(&length), sizeof(length));
+            strings_ += file.type;
+        }
+
+        StoreRecord record{};
+        record.start_offset = file.start_offset;
+        record.end_offset = file.end_offset;
+        record.file_size = file.file_size;
+        record.hash = file.hashed ? file.content_hash : 0;
+        record.type_id = type->second;
+        record.flags = (file.has_valid_footer ? STORE_FOOTER_VALID : 0u) |
+                       (file.structure_resolved ? STORE_STRUCTURE : 0u) |
+                       (file.extracted ? STORE_EXTRACTED : 0u) |
+                       (!file.fragments.empty() ? STORE_FRAGMENTED : 0u) |
+                       (file.parent_offset != SIZE_MAX ? STORE_NESTED : 0u) |
+                       (file.hashed ? STORE_HASH : 0u) |
+                       (!file.duplicate_of.empty() ? STORE_DUPLICATE : 0u);
+        append(std::string(reinterpret_cast<const char*>(&record), sizeof(record)));
+
+        sorted_ = sorted_ && record.start_offset >= last_offset_;
+        last_offset_ = record.start_offset;
+        record_count_++;
+    }
+
+    void write_summary(const CarvingSummary& summary) override {
+        summary_ = summary;
+        append(strings_);
+    }
+
+    bool complete() override {
+        if (dropped_count_ > 0) {
+            std::cerr << "Aviso: " << dropped_count_ << " arquivos não couberam em " << get_path()
+                      << " (gravados: " << record_count_ << ")" << std::endl;
+        }
+
+        StoreHeader header{};
+        std::memcpy(header.magic, ResultStore::MAGIC, sizeof(header.magic));
+        header.version = ResultStore::FORMAT_VERSION;
+        header.byte_order = ResultStore::BYTE_ORDER_TAG;
+        header.record_count = record_count_;
+        header.record_size = sizeof(StoreRecord);
+        header.type_count = static_cast<uint32_t>(type_ids_.size());
+        header.strings_offset = sizeof(StoreHeader) + record_count_ * sizeof(StoreRecord);
+        header.strings_size = strings_.size();
+        header.index_offset = (header.strings_offset + header.strings_size + 7) / 8 * 8;
+        header.files_found = summary_.files_found;
+        header.files_extracted = summary_.files_extracted;
+        header.bytes_processed = summary_.bytes_processed;
+
+        const size_t count = static_cast<size_t>(record_count_);
+
+#if CARVER_HAVE_MMAP
+        const size_t total = static_cast<size_t>(header.index_offset) + count * sizeof(uint32_t);
+        int fd = ::open(get_path().c_str(), O_RDWR);
+        if (fd < 0) {
+            return false;
+        }
+        if (ftruncate(fd, static_cast<off_t>(total)) != 0) {
+            ::close(fd);
+            return false;
+        }
+        void* address = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (address == MAP_FAILED) {
+            return false;
+        }
+
+        uint8_t* data = static_cast<uint8_t*>(address);
+        const StoreRecord* records = reinterpret_cast<const StoreRecord*>(data + sizeof(StoreHeader));
+        uint32_t* index = reinterpret_cast<uint32_t*>(data + header.index_offset);
+        for (size_t i = 0; i < count; ++i) {
+            index[i] = static_cast<uint32_t>(i);
+        }
+        if (!sorted_) {
+            std::stable_sort(index, index + count, [records](uint32_t a, uint32_t b) {
+                return records[a].start_offset < records[b].start_offset;
+            });
+        }
+        std::memcpy(data, &header, sizeof(header));
+        return munmap(address, total) == 0;
+#else
+        std::fstream file(get_path(), std::ios::binary | std::ios::in | std::ios::out);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::vector<uint64_t> offsets(count);
+        for (size_t i = 0; i < count; ++i) {
+            file.seekg(static_cast<std::streamoff>(sizeof(StoreHeader) + i * sizeof(StoreRecord)));
+            file.read(reinterpret_cast<char*>(&offsets[i]), sizeof(uint64_t));
+        }
+        std::vector<uint32_t> index(count);
+        for (size_t i = 0; i < count; ++i) {
+            index[i] = static_cast<uint32_t>(i);
+        }
+        if (!sorted_) {
+            std::stable_sort(index.begin(), index.end(), [&offsets](uint32_t a, uint32_t b) {
+                return offsets[a] < offsets[b];
+            });
+        }
+
+        const char padding[8] = {};
+        file.seekp(0, std::ios::end);
+        file.write(padding, static_cast<std::streamsize>(header.index_offset - header.strings_offset - header.strings_size));
+        file.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(count * sizeof(uint32_t)));
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        return static_cast<bool>(file);
+#endif
+    }
+};
+
+} // namespace
+
+ResultSink::ResultSink(const std::string& path)
+    : file_(path, std::ios::binary | std::ios::trunc)
+    , path_(path)
+    , failed_(!file_.is_open()) {
+    buffer_.reserve(BUFFER_SIZE);
+}
+
+ResultSink::~ResultSink() {
+    // Execução interrompida sem finish(): grava o que já foi aceito
+    if (file_.is_open()) {
+        flush();
+    }
+}
+
+std::unique_ptr<ResultSink> ResultSink::create(ReportFormat format, const std::string& path) {
+    std::unique_ptr<ResultSink> sink;
+    switch (format) {
+        case ReportFormat::TEXT: sink = std::make_unique<TextReportSink>(path); break;
+        case ReportFormat::CSV: sink = std::make_unique<CsvReportSink>(path); break;
+        case ReportFormat::NDJSON: sink = std::make_unique<NdjsonReportSink>(path); break;
+        case ReportFormat::STORE: sink = std::make_unique<StoreResultSink>(path); break;
+    }
+
+    if (sink->failed_) {
+        std::cerr << "Erro ao criar relatório: " << path << std::endl;
+        return nullptr;
+    }
+    sink->write_header();
+    return sink;
+}
+
+void ResultSink::append(const std::string& text) {
+    buffer_ += text;
+    if (buffer_.size() >= BUFFER_SIZE) {
+        flush();
+    }
+}
+
+void ResultSink::add(const CarvedFile& file) {
+    write_file(file);
+}
+
+bool ResultSink::flush() {
+    if (!buffer_.empty() && !failed_) {
+        file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        file_.flush();
+        failed_ = !file_;
+    }
+    buffer_.clear();
+    return !failed_;
+}
+
+bool ResultSink::finish(const CarvingSummary& summary) {
+    write_summary(summary);
+    flush();
+    file_.close();
+    if (failed_ || !file_ || !complete()) {
+        std::cerr << "Erro ao gravar relatório: " << path_ << std::endl;
+        return false;
+    }
+    std::cout << "Relatório salvo em: " << path_ << std::endl;
+    return true;
+}
+
+bool ResultSink::complete() {
+    return true;
+}
+
+const std::string& ResultSink::get_path() const {
+    return path_;
+}
@@ -0,0 +1,168 @@
+#include "result_store.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CARVER_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define CARVER_HAVE_MMAP 0
+#endif
+
+const char ResultStore::MAGIC[8] = {'C', 'R', 'V', 'R', 'E', 'S', '1', '\0'};
+
+namespace {
+
+/**
+ * @brief Mapeia o arquivo inteiro para leitura (ou lê para memória sem mmap)
+ * @param path Caminho do arquivo
+ * @param size Tamanho do arquivo
+ * @return Dono da memória (nulo em caso de erro); os dados começam em get()
+ */
+std::shared_ptr<const void> map_file(const std::string& path, size_t& size) {
+#if CARVER_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    size = static_cast<size_t>(info.st_size);
+
+    void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        return nullptr;
+    }
+
+    size_t mapped_size = size;
+    return std::shared_ptr<const void>(address, [mapped_size](const void* pointer) {
+        munmap(const_cast<void*>(pointer), mapped_size);
+    });
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+    size = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+
+    // uint64_t garante o alinhamento dos registros
+    auto buffer = std::make_shared<std::vector<uint64_t>>((size + 7) / 8);
+    if (!file.read(reinterpret_cast<char*>(buffer->data()), static_cast<std::streamsize>(size))) {
+        return nullptr;
+    }
+    return std::shared_ptr<const void>(buffer, buffer->data());
+#endif
+}
+
+} // namespace
+
+ResultStore::ResultStore()
+    : header_()
+    , records_(nullptr)
+    , index_(nullptr) {
+}
+
+bool ResultStore::open(const std::string& path) {
+    size_t size = 0;
+    std::shared_ptr<const void> storage = map_file(path, size);
+    if (!storage || size < sizeof(StoreHeader)) {
+        std::cerr << "Erro ao abrir arquivo de resultados: " << path << std::endl;
+        return false;
+    }
+
+    const uint8_t* data = static_cast<const uint8_t*>(storage.get());
+    StoreHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != FORMAT_VERSION || header.byte_order != BYTE_ORDER_TAG ||
+        header.record_size != sizeof(StoreRecord)) {
+        std::cerr << "Arquivo de resultados inválido ou incompleto: " << path << std::endl;
+        return false;
+    }
+
+    const uint64_t count = header.record_count;
+    if (count > (size - sizeof(StoreHeader)) / sizeof(StoreRecord) ||
+        header.strings_offset != sizeof(StoreHeader) + count * sizeof(StoreRecord) ||
+        header.strings_size > size - header.strings_offset ||
+        header.index_offset % 8 != 0 || header.index_offset > size ||
+        header.index_offset < header.strings_offset + header.strings_size ||
+        count > (size - header.index_offset) / sizeof(uint32_t)) {
+        std::cerr << "Arquivo de resultados corrompido: " << path << std::endl;
+        return false;
+    }
+
+    // Tabela de tipos
+    std::vector<std::string> names;
+    const uint8_t* strings = data + header.strings_offset;
+    size_t position = 0;
+    for (uint32_t i = 0; i < header.type_count; ++i) {
+        uint32_t length;
+        if (header.strings_size - position < sizeof(length)) break;
+        std::memcpy(&length, strings + position, sizeof(length));
+        position += sizeof(length);
+        if (header.strings_size - position < length) break;
+        names.emplace_back(reinterpret_cast<const char*>(strings + position), length);
+        position += length;
+    }
+
+    const StoreRecord* records = reinterpret_cast<const StoreRecord*>(data + sizeof(StoreHeader));
+    const uint32_t* index = reinterpret_cast<const uint32_t*>(data + header.index_offset);
+    if (names.size() != header.type_count) {
+        std::cerr << "Arquivo de resultados corrompido: " << path << std::endl;
+        return false;
+    }
+
+    storage_ = std::move(storage);
+    header_ = header;
+    records_ = records;
+    index_ = index;
+    type_names_ = std::move(names);
+    return true;
+}
+
+size_t ResultStore::size() const {
+    return static_cast<size_t>(header_.record_count);
+}
+
+const StoreRecord& ResultStore::get(size_t position) const {
+    return records_[index_[position]];
+}
+
+size_t ResultStore::lower_bound(uint64_t offset) const {
+    const uint32_t* end = index_ + size();
+    const uint32_t* it = std::lower_bound(index_, end, offset, [this](uint32_t record, uint64_t value) {
+        return records_[record].start_offset < value;
+    });
+    return static_cast<size_t>(it - index_);
+}
+
+const std::string& ResultStore::get_type_name(uint32_t type_id) const {
+    static const std::string unknown = "?";
+    return type_id < type_names_.size() ? type_names_[type_id] : unknown;
+}
+
+bool ResultStore::find_type(const std::string& name, uint32_t& type_id) const {
+    for (size_t i = 0; i < type_names_.size(); ++i) {
+        if (type_names_[i] == name) {
+            type_id = static_cast<uint32_t>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const StoreHeader& ResultStore::get_header() const {
+    return header_;
+}
@@ -0,0 +1,96 @@
+#include "ring_buffer.h"
+#include <iostream>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+#define CARVER_HAVE_MEMFD 1
+#endif
+#endif
+
+namespace {
+    const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+}
+
+RingBuffer::RingBuffer()
+    : base_(nullptr)
+    , capacity_(0)
+    , huge_pages_(false) {
+}
+
+RingBuffer::~RingBuffer() {
+    release();
+}
+
+bool RingBuffer::allocate(size_t min_capacity, bool huge_pages) {
+    release();
+
+#ifdef CARVER_HAVE_MEMFD
+    size_t page = huge_pages ? HUGE_PAGE_SIZE : static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t capacity = (std::max<size_t>(min_capacity, 1) + page - 1) / page * page;
+
+    int fd = memfd_create("carver-ring", MFD_CLOEXEC | (huge_pages ? MFD_HUGETLB : 0u));
+    if (fd >= 0 && ftruncate(fd, static_cast<off_t>(capacity)) != 0) {
+        ::close(fd);
+        fd = -1;
+    }
+
+    // Reserva o dobro do espaço e mapeia as mesmas páginas nas duas metades
+    uint8_t* base = nullptr;
+    if (fd >= 0) {
+        void* reserved = mmap(nullptr, capacity * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (reserved != MAP_FAILED) {
+            base = static_cast<uint8_t*>(reserved);
+            if (mmap(base, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+                mmap(base + capacity, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+                munmap(base, capacity * 2);
+                base = nullptr;
+            }
+        }
+        ::close(fd);
+    }
+
+    if (!base) {
+        if (huge_pages) {
+            std::cerr << "Aviso: páginas enormes indisponíveis para o buffer de leitura, usando páginas normais"
+                      << std::endl;
+            return allocate(min_capacity, false);
+        }
+        return false;
+    }
+
+    base_ = base;
+    capacity_ = capacity;
+    huge_pages_ = huge_pages;
+    return true;
+#else
+    (void)min_capacity;
+    (void)huge_pages;
+    return false;
+#endif
+}
+
+void RingBuffer::release() {
+#ifdef CARVER_HAVE_MEMFD
+    if (base_) {
+        munmap(base_, capacity_ * 2);
+    }
+#endif
+    base_ = nullptr;
+    capacity_ = 0;
+    huge_pages_ = false;
+}
+
+bool RingBuffer::is_ready() const {
+    return base_ != nullptr;
+}
+
+size_t RingBuffer::capacity() const {
+    return capacity_;
+}
+
+bool RingBuffer::uses_huge_pages() const {
+    return huge_pages_;
+}
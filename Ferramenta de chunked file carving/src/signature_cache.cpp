@@ -0,0 +1,314 @@
+#include "signature_cache.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CARVER_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define CARVER_HAVE_MMAP 0
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char CACHE_MAGIC[8] = {'C', 'R', 'V', 'S', 'I', 'G', 'C', '\0'};
+const uint32_t BYTE_ORDER_TAG = 0x01020304;
+
+/**
+ * @brief Cabeçalho do arquivo de cache (seguido dos registros e do bloco do autômato)
+ */
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;        // Cache só é válido na mesma ordem de bytes
+    uint64_t key;
+    uint64_t signature_count;
+    uint64_t builtin_count;
+    uint64_t records_size;      // Registros logo após o cabeçalho
+    uint64_t matcher_offset;    // Alinhado a 8 bytes
+    uint64_t matcher_words;
+};
+
+/**
+ * @brief Cabeçalho fixo de cada registro de assinatura (seguido dos bytes)
+ */
+struct RecordHeader {
+    uint32_t name_length;
+    uint32_t extension_length;
+    uint32_t header_length;
+    uint32_t footer_length;
+    uint64_t max_size;
+    uint64_t has_footer;
+};
+
+void append_bytes(std::string& out, const void* data, size_t size) {
+    out.append(static_cast<const char*>(data), size);
+}
+
+void append_records(std::string& out, const std::vector<FileSignature>& signatures) {
+    for (const auto& sig : signatures) {
+        RecordHeader record{
+            static_cast<uint32_t>(sig.name.size()),
+            static_cast<uint32_t>(sig.extension.size()),
+            static_cast<uint32_t>(sig.header.size()),
+            static_cast<uint32_t>(sig.footer.size()),
+            static_cast<uint64_t>(sig.max_size),
+            sig.has_footer ? 1u : 0u
+        };
+        append_bytes(out, &record, sizeof(record));
+        append_bytes(out, sig.name.data(), sig.name.size());
+        append_bytes(out, sig.extension.data(), sig.extension.size());
+        append_bytes(out, sig.header.data(), sig.header.size());
+        append_bytes(out, sig.footer.data(), sig.footer.size());
+    }
+}
+
+/**
+ * @brief Grava o conteúdo em um arquivo temporário de nome único ao lado de path
+ * @param path Caminho final (o temporário fica no mesmo diretório, para o rename ser atômico)
+ * @param contents Bytes a gravar
+ * @param temp_path Nome do temporário (preenchido se foi criado)
+ * @return true se o arquivo foi criado e gravado por inteiro
+ *
+ * Execuções simultâneas com o mesmo arquivo de assinaturas não gravam no
+ * mesmo temporário. Sem mkstemp, usa <path>.tmp.
+ */
+bool write_temp_file(const std::string& path, const std::string& contents, std::string& temp_path) {
+#if CARVER_HAVE_MMAP
+    std::vector<char> name(path.begin(), path.end());
+    const char suffix[] = ".XXXXXX";
+    name.insert(name.end(), suffix, suffix + sizeof(suffix));
+    int fd = mkstemp(name.data());
+    if (fd < 0) {
+        return false;
+    }
+    temp_path = name.data();
+    fchmod(fd, 0644);   // mkstemp cria com 0600; o cache pode ser lido por outros usuários
+
+    size_t written = 0;
+    while (written < contents.size()) {
+        ssize_t result = ::write(fd, contents.data() + written, contents.size() - written);
+        if (result < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        written += static_cast<size_t>(result);
+    }
+    bool closed = ::close(fd) == 0;
+    return written == contents.size() && closed;
+#else
+    temp_path = path + ".tmp";
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        temp_path.clear();
+        return false;
+    }
+    file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    file.close();
+    return static_cast<bool>(file);
+#endif
+}
+
+bool parse_records(const uint8_t* data, size_t size, size_t count, std::vector<FileSignature>& signatures) {
+    if (count > size / sizeof(RecordHeader)) {
+        return false;
+    }
+    signatures.clear();
+    signatures.reserve(count);
+
+    size_t position = 0;
+    for (size_t i = 0; i < count; ++i) {
+        RecordHeader record;
+        if (size - position < sizeof(record)) return false;
+        std::memcpy(&record, data + position, sizeof(record));
+        position += sizeof(record);
+
+        uint64_t payload = static_cast<uint64_t>(record.name_length) + record.extension_length +
+                           record.header_length + record.footer_length;
+        if (size - position < payload) return false;
+
+        const char* text = reinterpret_cast<const char*>(data + position);
+        FileSignature sig;
+        sig.name.assign(text, record.name_length);
+        text += record.name_length;
+        sig.extension.assign(text, record.extension_length);
+        text += record.extension_length;
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(text);
+        sig.header.assign(bytes, bytes + record.header_length);
+        bytes += record.header_length;
+        sig.footer.assign(bytes, bytes + record.footer_length);
+        sig.max_size = static_cast<size_t>(record.max_size);
+        sig.has_footer = record.has_footer != 0;
+
+        position += static_cast<size_t>(payload);
+        signatures.push_back(std::move(sig));
+    }
+    return position == size;
+}
+
+/**
+ * @brief Mapeia o arquivo inteiro para leitura (ou lê para memória sem mmap)
+ * @param path Caminho do arquivo
+ * @param size Tamanho do arquivo
+ * @return Dono da memória (nulo em caso de erro); os dados começam em get()
+ */
+std::shared_ptr<const void> map_file(const std::string& path, size_t& size) {
+#if CARVER_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    size = static_cast<size_t>(info.st_size);
+
+    void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        return nullptr;
+    }
+
+    size_t mapped_size = size;
+    return std::shared_ptr<const void>(address, [mapped_size](const void* pointer) {
+        munmap(const_cast<void*>(pointer), mapped_size);
+    });
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+    size = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+
+    // uint64_t garante o alinhamento do bloco do autômato
+    auto buffer = std::make_shared<std::vector<uint64_t>>((size + 7) / 8);
+    if (!file.read(reinterpret_cast<char*>(buffer->data()), static_cast<std::streamsize>(size))) {
+        return nullptr;
+    }
+    return std::shared_ptr<const void>(buffer, buffer->data());
+#endif
+}
+
+} // namespace
+
+uint64_t SignatureCache::compute_key(const std::vector<FileSignature>& base, const std::string& config_text) {
+    const uint32_t version = FORMAT_VERSION;
+    std::string input;
+    append_bytes(input, &version, sizeof(version));
+    append_records(input, base);
+    input += config_text;
+
+    // FNV-1a
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (unsigned char c : input) {
+        hash ^= c;
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+std::string SignatureCache::default_path(const std::string& config_file) {
+    return config_file + ".cache";
+}
+
+bool SignatureCache::load(const std::string& path, uint64_t key, std::vector<FileSignature>& signatures,
+                          size_t& builtin_count, HeaderMatcher& matcher) {
+    size_t size = 0;
+    std::shared_ptr<const void> storage = map_file(path, size);
+    if (!storage || size < sizeof(CacheHeader)) {
+        return false;
+    }
+
+    const uint8_t* data = static_cast<const uint8_t*>(storage.get());
+    CacheHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.version != FORMAT_VERSION || header.byte_order != BYTE_ORDER_TAG || header.key != key) {
+        return false;
+    }
+
+    if (header.records_size > size - sizeof(CacheHeader) ||
+        header.matcher_offset % 8 != 0 || header.matcher_offset > size ||
+        header.matcher_offset < sizeof(CacheHeader) + header.records_size ||
+        header.matcher_words > (size - header.matcher_offset) / sizeof(uint32_t) ||
+        header.builtin_count > header.signature_count) {
+        return false;
+    }
+
+    std::vector<FileSignature> loaded;
+    if (!parse_records(data + sizeof(CacheHeader), static_cast<size_t>(header.records_size),
+                       static_cast<size_t>(header.signature_count), loaded)) {
+        return false;
+    }
+
+    // O bloco aponta para dentro do mapeamento, que fica vivo junto com o autômato
+    HeaderMatcher attached;
+    const uint32_t* words = reinterpret_cast<const uint32_t*>(data + header.matcher_offset);
+    if (!attached.attach(words, static_cast<size_t>(header.matcher_words), storage) ||
+        attached.get_pattern_count() != loaded.size()) {
+        return false;
+    }
+
+    signatures = std::move(loaded);
+    builtin_count = static_cast<size_t>(header.builtin_count);
+    matcher = std::move(attached);
+    return true;
+}
+
+bool SignatureCache::save(const std::string& path, uint64_t key, const std::vector<FileSignature>& signatures,
+                          size_t builtin_count, const HeaderMatcher& matcher) {
+    std::string records;
+    append_records(records, signatures);
+
+    CacheHeader header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = FORMAT_VERSION;
+    header.byte_order = BYTE_ORDER_TAG;
+    header.key = key;
+    header.signature_count = signatures.size();
+    header.builtin_count = builtin_count;
+    header.records_size = records.size();
+    header.matcher_offset = (sizeof(CacheHeader) + records.size() + 7) / 8 * 8;
+    header.matcher_words = matcher.get_blob_words();
+
+    std::string contents;
+    append_bytes(contents, &header, sizeof(header));
+    contents += records;
+    contents.append(header.matcher_offset - sizeof(header) - records.size(), '\0');
+    append_bytes(contents, matcher.get_blob(), header.matcher_words * sizeof(uint32_t));
+
+    std::string temp_path;
+    if (!write_temp_file(path, contents, temp_path)) {
+        if (temp_path.empty()) {
+            std::cerr << "Aviso: não foi possível criar o cache de assinaturas: " << path << std::endl;
+            return false;
+        }
+        std::cerr << "Aviso: erro ao gravar o cache de assinaturas: " << path << std::endl;
+        std::error_code error;
+        fs::remove(temp_path, error);
+        return false;
+    }
+
+    std::error_code error;
+    fs::rename(temp_path, path, error);
+    if (error) {
+        std::cerr << "Aviso: erro ao gravar o cache de assinaturas: " << path << std::endl;
+        fs::remove(temp_path, error);
+        return false;
+    }
+    return true;
+}
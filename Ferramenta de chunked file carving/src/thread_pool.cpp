@@ -0,0 +1,165 @@
+#include "thread_pool.h"
+#include <cstdint>
+
+namespace {
+    thread_local size_t current_worker_index = SIZE_MAX;
+    thread_local const void* current_worker_pool = nullptr;
+}
+
+ThreadPool::ThreadPool(size_t num_threads)
+    : pending_tasks_(0)
+    , queued_tasks_(0)
+    , next_queue_(0)
+    , stopping_(false) {
+
+    size_t count = resolve_thread_count(num_threads);
+    for (size_t i = 0; i < count; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < count; ++i) {
+        workers_.emplace_back(&ThreadPool::worker_loop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::unique_lock<std::mutex> lock(state_mutex_);
+        all_done_.wait(lock, [this] { return pending_tasks_ == 0; });
+        stopping_ = true;
+    }
+    work_available_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    size_t target;
+    if (current_worker_pool == this) {
+        target = current_worker_index;
+    } else {
+        target = next_queue_++ % queues_.size();
+    }
+
+    pending_tasks_++;
+    {
+        std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+        queues_[target]->tasks.push_back(std::move(task));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        queued_tasks_++;
+    }
+    work_available_.notify_one();
+}
+
+bool ThreadPool::try_pop(size_t index, std::function<void()>& task) {
+    // Primeiro a própria fila (LIFO, melhor localidade de cache)
+    {
+        WorkerQueue& own = *queues_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Depois rouba do início das filas vizinhas (FIFO, tarefas mais antigas)
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+        WorkerQueue& victim = *queues_[(index + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::worker_loop(size_t index) {
+    current_worker_index = index;
+    current_worker_pool = this;
+
+    while (true) {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(state_mutex_);
+            work_available_.wait(lock, [this] { return stopping_ || queued_tasks_ > 0; });
+            if (stopping_ && queued_tasks_ == 0) {
+                return;
+            }
+        }
+
+        if (!try_pop(index, task)) {
+            continue; // Outro worker pegou a tarefa primeiro
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            queued_tasks_--;
+        }
+
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            if (!first_error_) {
+                first_error_ = std::current_exception();
+            }
+        }
+
+        if (--pending_tasks_ == 0) {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            all_done_.notify_all();
+        }
+    }
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    all_done_.wait(lock, [this] { return pending_tasks_ == 0; });
+
+    if (first_error_) {
+        std::exception_ptr error = first_error_;
+        first_error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+bool ThreadPool::wait_for(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    if (!all_done_.wait_for(lock, timeout, [this] { return pending_tasks_ == 0; })) {
+        return false;
+    }
+
+    if (first_error_) {
+        std::exception_ptr error = first_error_;
+        first_error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+    return true;
+}
+
+size_t ThreadPool::size() const {
+    return workers_.size();
+}
+
+size_t ThreadPool::current_worker() {
+    return current_worker_index;
+}
+
+size_t ThreadPool::resolve_thread_count(size_t requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    size_t hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? hardware : 1;
+}
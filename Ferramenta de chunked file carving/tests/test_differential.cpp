@@ -0,0 +1,399 @@
+#include "test_support.h"
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdint>
+#include <cstdlib>
+
+/**
+ * Teste diferencial do executável: a mesma imagem sintética é processada com
+ * cada forma de leitura (STREAM, MMAP, DIRECT, com e sem leitura antecipada),
+ * número de threads e tamanho de chunk, e o relatório CSV e os arquivos
+ * extraídos têm de ser idênticos em todas as combinações.
+ *
+ * Uso: test_differential <caminho do chunked_carver>
+ */
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+class ImageBuilder {
+private:
+    Bytes data_;
+    std::mt19937& random_;
+
+public:
+    explicit ImageBuilder(std::mt19937& random) : random_(random) {}
+
+    void random_bytes(size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            data_.push_back(static_cast<uint8_t>(random_()));
+        }
+    }
+
+    void zeros_to(size_t offset) {
+        if (data_.size() < offset) {
+            data_.resize(offset, 0);
+        }
+    }
+
+    size_t place(const Bytes& content) {
+        size_t offset = data_.size();
+        data_.insert(data_.end(), content.begin(), content.end());
+        return offset;
+    }
+
+    size_t place_at(size_t offset, const Bytes& content) {
+        zeros_to(offset);
+        return place(content);
+    }
+
+    const Bytes& data() const {
+        return data_;
+    }
+};
+
+void put_be16(Bytes& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void put_be32(Bytes& out, uint32_t value) {
+    put_be16(out, value >> 16);
+    put_be16(out, value & 0xFFFF);
+}
+
+void put_le16(Bytes& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void put_le32(Bytes& out, uint32_t value) {
+    put_le16(out, value & 0xFFFF);
+    put_le16(out, value >> 16);
+}
+
+// Bytes aleatórios sem 0xFF (conteúdo de segmento sem marcadores falsos)
+void put_payload(Bytes& out, std::mt19937& random, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        out.push_back(static_cast<uint8_t>(random() % 255));
+    }
+}
+
+void put_jpeg_segment(Bytes& out, uint8_t marker, const Bytes& payload) {
+    out.push_back(0xFF);
+    out.push_back(marker);
+    put_be16(out, static_cast<uint32_t>(payload.size() + 2));
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+/**
+ * @brief JPEG baseline com dados de entropia aleatórios (0xFF com byte de enchimento)
+ * @param thumbnail Miniatura embutida no segmento Exif (opcional)
+ */
+Bytes make_jpeg(std::mt19937& random, size_t entropy_size, const Bytes* thumbnail = nullptr) {
+    Bytes out = {0xFF, 0xD8};
+    if (thumbnail) {
+        Bytes exif = {'E', 'x', 'i', 'f', 0, 0};
+        put_payload(exif, random, 20);
+        exif.insert(exif.end(), thumbnail->begin(), thumbnail->end());
+        put_jpeg_segment(out, 0xE1, exif);
+    }
+    Bytes payload;
+    put_payload(payload, random, 65);
+    put_jpeg_segment(out, 0xDB, payload);
+    payload.clear();
+    put_payload(payload, random, 15);
+    put_jpeg_segment(out, 0xC0, payload);
+    payload.clear();
+    put_payload(payload, random, 30);
+    put_jpeg_segment(out, 0xC4, payload);
+    payload.clear();
+    put_payload(payload, random, 10);
+    put_jpeg_segment(out, 0xDA, payload);
+
+    for (size_t i = 0; i < entropy_size; ++i) {
+        uint8_t value = static_cast<uint8_t>(random());
+        out.push_back(value);
+        if (value == 0xFF) {
+            out.push_back(0x00);
+        }
+        if (i % 4000 == 3999) {
+            out.push_back(0xFF);
+            out.push_back(static_cast<uint8_t>(0xD0 + (i / 4000) % 8));    // RSTn
+        }
+    }
+    out.push_back(0xFF);
+    out.push_back(0xD9);
+    return out;
+}
+
+uint32_t crc32(const uint8_t* data, size_t size) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+void put_png_chunk(Bytes& out, const char* type, const Bytes& payload) {
+    put_be32(out, static_cast<uint32_t>(payload.size()));
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), payload.begin(), payload.end());
+    put_be32(out, crc32(out.data() + start, out.size() - start));
+}
+
+Bytes make_png(std::mt19937& random, size_t data_size) {
+    Bytes out = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    Bytes header;
+    put_be32(header, 64);
+    put_be32(header, 64);
+    header.insert(header.end(), {8, 2, 0, 0, 0});
+    put_png_chunk(out, "IHDR", header);
+    Bytes pixels;
+    put_payload(pixels, random, data_size);
+    put_png_chunk(out, "IDAT", pixels);
+    put_png_chunk(out, "IEND", Bytes());
+    return out;
+}
+
+Bytes make_bmp(std::mt19937& random, uint32_t width, uint32_t height) {
+    uint32_t row = (width * 3 + 3) / 4 * 4;
+    uint32_t data_size = row * height;
+    Bytes out = {'B', 'M'};
+    put_le32(out, 54 + data_size);
+    put_le32(out, 0);
+    put_le32(out, 54);
+    put_le32(out, 40);
+    put_le32(out, width);
+    put_le32(out, height);
+    put_le16(out, 1);
+    put_le16(out, 24);
+    put_le32(out, 0);
+    put_le32(out, data_size);
+    put_le32(out, 2835);
+    put_le32(out, 2835);
+    put_le32(out, 0);
+    put_le32(out, 0);
+    put_payload(out, random, data_size);
+    return out;
+}
+
+/**
+ * @brief Imagem com arquivos cruzando as fronteiras dos chunks testados,
+ *        miniaturas embutidas, duplicatas, lixo aleatório e um JPEG truncado
+ * @param planted Recebe o conteúdo dos arquivos de primeiro nível
+ * @param thumbnail Recebe o conteúdo da miniatura embutida
+ */
+Bytes build_image(std::vector<Bytes>& planted, Bytes& thumbnail) {
+    std::mt19937 random(424242);
+    ImageBuilder image(random);
+
+    thumbnail = make_jpeg(random, 2500);
+    Bytes photo = make_jpeg(random, 30000, &thumbnail);
+    Bytes picture = make_png(random, 9000);
+
+    planted.push_back(photo);
+    image.place_at(8192, photo);
+    planted.push_back(picture);
+    image.place_at(image.data().size() + 777, picture);
+    planted.push_back(make_jpeg(random, 20000));
+    image.place_at(16384 * 3 - 2, planted.back());          // Cabeçalho dividido entre chunks de 16KB
+    planted.push_back(make_bmp(random, 40, 30));
+    image.place_at(65536 - 1, planted.back());             // ... e entre chunks de 64KB
+    image.random_bytes(150000);
+    image.place(photo);                                      // Duplicata (conteúdo idêntico)
+    image.random_bytes(3000);
+
+    for (int i = 0; i < 10; ++i) {
+        Bytes file;
+        switch (i % 3) {
+            case 0: file = make_jpeg(random, 5000 + random() % 40000, i % 2 ? &thumbnail : nullptr); break;
+            case 1: file = make_png(random, 2000 + random() % 20000); break;
+            default: file = make_bmp(random, 16 + random() % 64, 16 + random() % 64); break;
+        }
+        planted.push_back(file);
+        image.place_at(image.data().size() + 1 + random() % 6000, file);
+    }
+
+    planted.push_back(make_jpeg(random, 80000));
+    image.place_at(1048576 - 3, planted.back());            // Atravessa a fronteira de 1MB
+    image.random_bytes(50000);
+    planted.push_back(make_png(random, 30000));
+    image.place_at(2 * 1048576 - 40, planted.back());
+    image.random_bytes(20000);
+
+    // JPEG sem EOI no meio de dados aleatórios
+    Bytes truncated = make_jpeg(random, 12000);
+    truncated.resize(truncated.size() - 2000);
+    image.place(truncated);
+    image.random_bytes(40000);
+    image.zeros_to(image.data().size() + 8192);
+    return image.data();
+}
+
+bool write_file(const fs::path& path, const Bytes& data) {
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file);
+}
+
+std::string read_file(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+/**
+ * @brief Saída de uma execução: relatório CSV e arquivos extraídos (nome -> conteúdo)
+ */
+struct RunResult {
+    bool ok = false;
+    std::string csv;
+    std::map<std::string, std::string> files;
+};
+
+RunResult run_carver(const std::string& carver, const fs::path& image, const fs::path& work,
+                     const std::string& name, const std::string& options) {
+    fs::path output = work / name;
+    fs::path csv = work / (name + ".csv");
+    fs::path log = work / (name + ".log");
+    std::string command = "\"" + carver + "\" -i \"" + image.string() + "\" -o \"" + output.string() +
+                          "\" --hash --no-report --csv --csv-file \"" + csv.string() + "\" " + options +
+                          " > \"" + log.string() + "\" 2>&1";
+
+    RunResult result;
+    if (std::system(command.c_str()) != 0) {
+        std::cerr << "Falha ao executar (" << options << "):\n" << read_file(log) << std::endl;
+        return result;
+    }
+    result.ok = true;
+    result.csv = read_file(csv);
+    for (const auto& entry : fs::directory_iterator(output)) {
+        result.files[entry.path().filename().string()] = read_file(entry.path());
+    }
+    return result;
+}
+
+/**
+ * @brief Exibe a primeira linha em que dois relatórios diferem
+ */
+void report_difference(const std::string& expected, const std::string& actual) {
+    std::istringstream left(expected);
+    std::istringstream right(actual);
+    std::string left_line;
+    std::string right_line;
+    for (size_t line = 1; ; ++line) {
+        bool has_left = static_cast<bool>(std::getline(left, left_line));
+        bool has_right = static_cast<bool>(std::getline(right, right_line));
+        if (!has_left && !has_right) {
+            return;
+        }
+        if (!has_left || !has_right || left_line != right_line) {
+            std::cerr << "  linha " << line << "\n  esperado: " << (has_left ? left_line : "(fim)")
+                      << "\n  obtido:   " << (has_right ? right_line : "(fim)") << std::endl;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Executa todas as combinações de um modo e compara com a primeira
+ * @return Resultado de referência
+ */
+RunResult check_combinations(const std::string& carver, const fs::path& image, const fs::path& work,
+                             const std::string& tag, const std::string& mode) {
+    const std::vector<std::string> backends = {"", "--mmap", "--direct --io-depth 4", "--io-depth 4"};
+    const std::vector<std::string> threads = {"--threads 1", "--threads 3"};
+    const std::vector<std::string> chunks = {"--chunk-size 16384", "--chunk-size 65536", "--chunk-size 1048576"};
+
+    std::vector<std::string> combinations;
+    for (const auto& backend : backends) {
+        for (const auto& thread : threads) {
+            for (const auto& chunk : chunks) {
+                combinations.push_back(mode + " " + backend + " " + thread + " " + chunk);
+            }
+        }
+    }
+    combinations.push_back(mode + " --writers 0");
+
+    RunResult reference;
+    for (size_t i = 0; i < combinations.size(); ++i) {
+        RunResult result = run_carver(carver, image, work, tag + std::to_string(i), combinations[i]);
+        CHECK(result.ok);
+        if (!result.ok) {
+            continue;
+        }
+        if (!reference.ok) {
+            reference = result;
+            continue;
+        }
+        if (result.csv != reference.csv) {
+            std::cerr << "Relatório diferente com [" << combinations[i] << "] (referência: ["
+                      << combinations[0] << "])" << std::endl;
+            report_difference(reference.csv, result.csv);
+            test_failures()++;
+        }
+        if (result.files != reference.files) {
+            std::cerr << "Arquivos extraídos diferentes com [" << combinations[i] << "]" << std::endl;
+            test_failures()++;
+        }
+        fs::remove_all(work / (tag + std::to_string(i)));
+    }
+    return reference;
+}
+
+bool contains_content(const RunResult& result, const Bytes& content) {
+    std::string expected(content.begin(), content.end());
+    for (const auto& file : result.files) {
+        if (file.second == expected) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Uso: " << argv[0] << " <chunked_carver>" << std::endl;
+        return 2;
+    }
+    const std::string carver = argv[1];
+
+    TempDirectory work("carver_differential");
+    std::vector<Bytes> planted;
+    Bytes thumbnail;
+    fs::path image = work.path() / "image.dd";
+    CHECK(write_file(image, build_image(planted, thumbnail)));
+
+    // Varredura completa: miniaturas também são recuperadas
+    RunResult full = check_combinations(carver, image, work.path(), "full", "");
+    CHECK(full.ok);
+    for (const auto& content : planted) {
+        CHECK(contains_content(full, content));
+    }
+    CHECK(contains_content(full, thumbnail));
+
+    // Sem procurar dentro do que já foi delimitado
+    RunResult outer = check_combinations(carver, image, work.path(), "outer", "--skip-carved");
+    CHECK(outer.ok);
+    for (const auto& content : planted) {
+        CHECK(contains_content(outer, content));
+    }
+    CHECK(!contains_content(outer, thumbnail));
+
+    return test_result("differential");
+}
@@ -0,0 +1,198 @@
+#include "interval_index.h"
+#include "test_support.h"
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+
+namespace {
+
+struct FileRange {
+    size_t begin;
+    size_t end;
+};
+
+/**
+ * @brief Arquivo mais interno por força bruta: início mais próximo, depois o menor fim
+ */
+bool brute_enclosing(const std::vector<FileRange>& files, size_t offset, size_t& owner) {
+    const FileRange* best = nullptr;
+    for (const auto& file : files) {
+        if (file.begin < offset && offset < file.end &&
+            (!best || file.begin > best->begin || (file.begin == best->begin && file.end < best->end))) {
+            best = &file;
+        }
+    }
+    if (best) {
+        owner = best->begin;
+    }
+    return best != nullptr;
+}
+
+/**
+ * @brief União por força bruta (só intervalos que se sobrepõem são unidos)
+ */
+std::vector<FileRange> brute_union(std::vector<FileRange> files) {
+    std::sort(files.begin(), files.end(), [](const FileRange& a, const FileRange& b) { return a.begin < b.begin; });
+    std::vector<FileRange> regions;
+    for (const auto& file : files) {
+        if (!regions.empty() && file.begin < regions.back().end) {
+            regions.back().end = std::max(regions.back().end, file.end);
+        } else {
+            regions.push_back(file);
+        }
+    }
+    return regions;
+}
+
+size_t brute_skip(const std::vector<FileRange>& regions, size_t offset) {
+    for (const auto& region : regions) {
+        if (region.begin < offset && offset < region.end) {
+            return region.end;
+        }
+    }
+    return offset;
+}
+
+size_t brute_next(const std::vector<FileRange>& regions, size_t offset) {
+    for (const auto& region : regions) {
+        if (region.begin > offset) {
+            return region.begin;
+        }
+    }
+    return SIZE_MAX;
+}
+
+void test_empty() {
+    IntervalIndex index;
+    size_t owner = 0;
+    CHECK(!index.find_enclosing(10, owner));
+    CHECK(index.skip_covered(10) == 10);
+    CHECK(index.next_region(0) == SIZE_MAX);
+    CHECK(index.size() == 0);
+
+    // Intervalo vazio não é registrado
+    index.insert(50, 50, 50);
+    CHECK(index.size() == 0);
+    CHECK(!index.find_enclosing(50, owner));
+}
+
+void test_single_region() {
+    IntervalIndex index;
+    index.insert(100, 200, 100);
+    size_t owner = 0;
+
+    CHECK(index.skip_covered(99) == 99);
+    CHECK(index.skip_covered(100) == 100);      // Outro formato pode começar no mesmo offset
+    CHECK(index.skip_covered(101) == 200);
+    CHECK(index.skip_covered(199) == 200);
+    CHECK(index.skip_covered(200) == 200);
+    CHECK(index.next_region(0) == 100);
+    CHECK(index.next_region(100) == SIZE_MAX);
+
+    // O próprio cabeçalho não está contido no arquivo
+    CHECK(!index.find_enclosing(100, owner));
+    CHECK(index.find_enclosing(150, owner) && owner == 100);
+    CHECK(!index.find_enclosing(200, owner));
+}
+
+void test_merging() {
+    IntervalIndex index;
+    index.insert(100, 200, 100);
+    index.insert(200, 300, 200);
+    CHECK(index.size() == 2);                   // Apenas encostados: continuam separados
+    CHECK(index.skip_covered(150) == 200);
+
+    index.insert(250, 400, 250);
+    CHECK(index.size() == 2);
+    CHECK(index.skip_covered(210) == 400);
+
+    index.insert(150, 260, 150);
+    CHECK(index.size() == 1);
+    CHECK(index.skip_covered(101) == 400);
+
+    // Região já coberta: a união não muda, mas o arquivo é registrado
+    index.insert(120, 130, 120);
+    CHECK(index.size() == 1);
+    size_t owner = 0;
+    CHECK(index.find_enclosing(125, owner) && owner == 120);
+
+    index.clear();
+    CHECK(index.size() == 0);
+    CHECK(!index.find_enclosing(125, owner));
+}
+
+void test_nested_owner(bool outer_first) {
+    // Contêiner, miniatura dentro dele, um nível a mais e um irmão
+    std::vector<FileRange> files = {{1000, 5000}, {1500, 2000}, {1600, 1700}, {3000, 3500}};
+    if (!outer_first) {
+        std::reverse(files.begin(), files.end());
+    }
+    IntervalIndex index;
+    for (const auto& file : files) {
+        index.insert(file.begin, file.end, file.begin);
+    }
+
+    size_t owner = 0;
+    CHECK(index.find_enclosing(1650, owner) && owner == 1600);
+    CHECK(index.find_enclosing(1600, owner) && owner == 1500);
+    CHECK(index.find_enclosing(1800, owner) && owner == 1500);
+    CHECK(index.find_enclosing(1500, owner) && owner == 1000);
+    CHECK(index.find_enclosing(2500, owner) && owner == 1000);
+    CHECK(index.find_enclosing(3200, owner) && owner == 3000);
+    CHECK(index.find_enclosing(4999, owner) && owner == 1000);
+    CHECK(!index.find_enclosing(5000, owner));
+    CHECK(index.size() == 1);
+}
+
+void test_random_against_brute_force() {
+    std::mt19937_64 random(20240611);
+    for (int round = 0; round < 200; ++round) {
+        std::vector<FileRange> files;
+        std::vector<size_t> starts;
+        size_t count = 1 + random() % 40;
+        while (files.size() < count) {
+            size_t begin = random() % 4000;
+            if (std::find(starts.begin(), starts.end(), begin) != starts.end()) {
+                continue;               // Um cabeçalho por offset
+            }
+            starts.push_back(begin);
+            files.push_back({begin, begin + 1 + random() % 600});
+        }
+
+        IntervalIndex index;
+        for (const auto& file : files) {
+            index.insert(file.begin, file.end, file.begin);
+        }
+        std::vector<FileRange> regions = brute_union(files);
+        CHECK(index.size() == regions.size());
+
+        for (size_t offset = 0; offset < 4700; ++offset) {
+            size_t expected_owner = SIZE_MAX;
+            size_t owner = SIZE_MAX;
+            bool expected = brute_enclosing(files, offset, expected_owner);
+            bool found = index.find_enclosing(offset, owner);
+            CHECK(found == expected);
+            if (found && expected) {
+                CHECK(owner == expected_owner);
+            }
+            CHECK(index.skip_covered(offset) == brute_skip(regions, offset));
+            CHECK(index.next_region(offset) == brute_next(regions, offset));
+            if (test_failures() > 0) {
+                return;                 // Uma divergência basta para o diagnóstico
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    test_empty();
+    test_single_region();
+    test_merging();
+    test_nested_owner(true);
+    test_nested_owner(false);
+    test_random_against_brute_force();
+    return test_result("interval_index");
+}
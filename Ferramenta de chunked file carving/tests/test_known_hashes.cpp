@@ -0,0 +1,166 @@
+#include "known_hashes.h"
+#include "content_hash.h"
+#include "test_support.h"
+#include <fstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+Sha256Digest random_digest(std::mt19937_64& random) {
+    Sha256Digest digest;
+    for (size_t i = 0; i < digest.size(); i += 8) {
+        uint64_t value = random();
+        std::memcpy(digest.data() + i, &value, 8);
+    }
+    return digest;
+}
+
+Sha256Digest sha256_of(const std::string& text) {
+    Sha256 sha;
+    sha.update(text.data(), text.size());
+    return sha.digest();
+}
+
+void test_sha256_reference() {
+    // Vetores do FIPS 180-2
+    CHECK(format_sha256(sha256_of("abc")) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    CHECK(format_sha256(sha256_of("")) == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+
+    Sha256Digest parsed;
+    CHECK(parse_sha256("BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD", parsed));
+    CHECK(parsed == sha256_of("abc"));
+    CHECK(!parse_sha256("ba7816bf", parsed));
+}
+
+void test_empty(const fs::path& directory) {
+    std::string path = (directory / "empty.khs").string();
+    std::vector<Sha256Digest> hashes;
+    CHECK(KnownHashSet::build(path, hashes));
+
+    KnownHashSet set;
+    CHECK(set.open(path));
+    CHECK(set.size() == 0);
+    CHECK(!set.contains(sha256_of("abc")));
+}
+
+void test_large_random(const fs::path& directory) {
+    std::mt19937_64 random(77);
+    std::vector<Sha256Digest> present;
+    for (int i = 0; i < 200000; ++i) {
+        present.push_back(random_digest(random));
+    }
+
+    // Repetições e ordem arbitrária são normalizadas por build
+    std::vector<Sha256Digest> input = present;
+    input.insert(input.end(), present.begin(), present.begin() + 1000);
+    std::shuffle(input.begin(), input.end(), random);
+
+    std::string path = (directory / "large.khs").string();
+    CHECK(KnownHashSet::build(path, input));
+    CHECK(std::is_sorted(input.begin(), input.end()));
+    CHECK(input.size() == present.size());
+
+    KnownHashSet set;
+    CHECK(set.open(path));
+    CHECK(set.size() == present.size());
+
+    size_t missing = 0;
+    for (const auto& hash : present) {
+        missing += set.contains(hash) ? 0 : 1;
+    }
+    CHECK(missing == 0);
+
+    // Ausentes: aleatórios e vizinhos de presentes (só o último byte muda)
+    size_t false_hits = 0;
+    for (int i = 0; i < 200000; ++i) {
+        false_hits += set.contains(random_digest(random)) ? 1 : 0;
+    }
+    for (size_t i = 0; i < present.size(); i += 7) {
+        Sha256Digest neighbour = present[i];
+        neighbour[31] ^= 0x01;
+        if (!std::binary_search(input.begin(), input.end(), neighbour)) {
+            false_hits += set.contains(neighbour) ? 1 : 0;
+        }
+    }
+    CHECK(false_hits == 0);
+}
+
+void test_repeated_keys(const fs::path& directory) {
+    // Chaves (8 primeiros bytes) repetidas e nos extremos: a interpolação não
+    // tem o que estimar e a busca termina pela busca binária
+    std::mt19937_64 random(5);
+    std::vector<Sha256Digest> present;
+    std::vector<Sha256Digest> absent;
+    for (int i = 0; i < 3000; ++i) {
+        Sha256Digest digest = random_digest(random);
+        std::memset(digest.data(), i % 3 == 0 ? 0x00 : i % 3 == 1 ? 0x5A : 0xFF, 8);
+        (i % 2 ? absent : present).push_back(digest);
+    }
+    std::vector<Sha256Digest> input = present;
+
+    std::string path = (directory / "repeated.khs").string();
+    CHECK(KnownHashSet::build(path, input));
+
+    KnownHashSet set;
+    CHECK(set.open(path));
+    for (const auto& hash : present) {
+        CHECK(set.contains(hash));
+    }
+    for (const auto& hash : absent) {
+        CHECK(!set.contains(hash));
+    }
+}
+
+void test_invalid_files(const fs::path& directory) {
+    std::vector<Sha256Digest> hashes = {sha256_of("a"), sha256_of("b"), sha256_of("c")};
+    std::string path = (directory / "valid.khs").string();
+    CHECK(KnownHashSet::build(path, hashes));
+
+    std::ifstream source(path, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>());
+    auto write = [&](const std::string& name, const std::string& data) {
+        std::string target = (directory / name).string();
+        std::ofstream file(target, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        return target;
+    };
+
+    KnownHashSet set;
+    CHECK(!set.open((directory / "missing.khs").string()));
+    CHECK(!set.open(write("truncated.khs", content.substr(0, content.size() - 1))));
+    CHECK(!set.open(write("header.khs", content.substr(0, sizeof(KnownHashHeader) - 1))));
+
+    std::string bad_magic = content;
+    bad_magic[0] = 'X';
+    CHECK(!set.open(write("magic.khs", bad_magic)));
+
+    // Formato 1 guardava XXH64: recusado em vez de comparar hashes de outro tipo
+    std::string old_version = content;
+    uint32_t version = 1;
+    std::memcpy(&old_version[offsetof(KnownHashHeader, version)], &version, sizeof(version));
+    CHECK(!set.open(write("version.khs", old_version)));
+
+    CHECK(set.open(path));
+    CHECK(set.size() == 3);
+    CHECK(set.contains(sha256_of("b")));
+    CHECK(!set.contains(sha256_of("d")));
+}
+
+} // namespace
+
+int main() {
+    TempDirectory directory("carver_known_hashes");
+    test_sha256_reference();
+    test_empty(directory.path());
+    test_large_random(directory.path());
+    test_repeated_keys(directory.path());
+    test_invalid_files(directory.path());
+    return test_result("known_hashes");
+}
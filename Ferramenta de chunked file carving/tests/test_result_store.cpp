@@ -0,0 +1,189 @@
+#include "result_store.h"
+#include "result_sink.h"
+#include "file_carver.h"
+#include "test_support.h"
+#include <fstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* const TYPES[] = {"JPEG", "PNG", "PDF"};
+
+CarvedFile make_file(const std::string& type, size_t start, size_t size) {
+    CarvedFile file;
+    file.filename = type + "_" + std::to_string(start);
+    file.type = type;
+    file.start_offset = start;
+    file.end_offset = start + size;
+    file.file_size = size;
+    file.has_valid_footer = true;
+    file.structure_resolved = false;
+    file.extracted = true;
+    file.parent_offset = SIZE_MAX;
+    return file;
+}
+
+bool write_store(const std::string& path, const std::vector<CarvedFile>& files, const CarvingSummary& summary) {
+    std::unique_ptr<ResultSink> sink = ResultSink::create(ReportFormat::STORE, path);
+    if (!sink) {
+        return false;
+    }
+    for (const auto& file : files) {
+        sink->add(file);
+    }
+    return sink->finish(summary);
+}
+
+/**
+ * @brief Arquivos fora de ordem (com offsets repetidos): o índice ordena de forma estável
+ */
+void test_unsorted(const fs::path& directory) {
+    std::mt19937_64 random(19);
+    std::vector<CarvedFile> files;
+    for (int i = 0; i < 5000; ++i) {
+        size_t start = (random() % 2000) * 512;
+        files.push_back(make_file(TYPES[random() % 3], start, 512 + random() % 100000));
+        files.back().extracted = (i % 5) != 0;
+    }
+    CarvingSummary summary;
+    summary.files_found = files.size();
+    summary.files_extracted = 4000;
+    summary.bytes_processed = 123456789;
+
+    std::string path = (directory / "unsorted.crv").string();
+    CHECK(write_store(path, files, summary));
+
+    ResultStore store;
+    CHECK(store.open(path));
+    CHECK(store.size() == files.size());
+    CHECK(store.get_header().files_found == files.size());
+    CHECK(store.get_header().files_extracted == 4000);
+    CHECK(store.get_header().bytes_processed == 123456789);
+
+    std::vector<CarvedFile> expected = files;
+    std::stable_sort(expected.begin(), expected.end(), [](const CarvedFile& a, const CarvedFile& b) {
+        return a.start_offset < b.start_offset;
+    });
+    for (size_t i = 0; i < expected.size() && i < store.size(); ++i) {
+        const StoreRecord& record = store.get(i);
+        CHECK(record.start_offset == expected[i].start_offset);
+        CHECK(record.end_offset == expected[i].end_offset);
+        CHECK(record.file_size == expected[i].file_size);
+        CHECK(store.get_type_name(record.type_id) == expected[i].type);
+        CHECK(((record.flags & STORE_EXTRACTED) != 0) == expected[i].extracted);
+        if (test_failures() > 0) {
+            return;
+        }
+    }
+
+    // lower_bound contra a busca na lista ordenada, incluindo offsets fora da faixa
+    for (int probe = 0; probe < 3000; ++probe) {
+        uint64_t offset = random() % (2100 * 512);
+        auto it = std::lower_bound(expected.begin(), expected.end(), offset, [](const CarvedFile& file, uint64_t value) {
+            return file.start_offset < value;
+        });
+        CHECK(store.lower_bound(offset) == static_cast<size_t>(it - expected.begin()));
+    }
+    CHECK(store.lower_bound(0) == 0);
+    CHECK(store.lower_bound(UINT64_MAX) == store.size());
+
+    uint32_t type_id = 0;
+    CHECK(store.find_type("PNG", type_id) && store.get_type_name(type_id) == "PNG");
+    CHECK(!store.find_type("ZIP", type_id));
+    CHECK(store.get_type_name(1000) == "?");
+}
+
+void test_sorted_and_flags(const fs::path& directory) {
+    std::vector<CarvedFile> files;
+    files.push_back(make_file("JPEG", 0, 4000));
+    files.push_back(make_file("JPEG", 100, 500));          // Miniatura dentro do anterior
+    files.back().parent_offset = 0;
+    files.back().structure_resolved = true;
+    files.push_back(make_file("ZIP", 8192, 3000));
+    files.back().fragments = {{8192, 9192}, {20000, 22000}};
+    files.back().has_valid_footer = false;
+    files.push_back(make_file("JPEG", 30000, 4000));
+    files.back().hashed = true;
+    files.back().content_hash = 0x0123456789ABCDEFull;
+    files.back().duplicate_of = "JPEG_0";
+    files.back().extracted = false;
+
+    std::string path = (directory / "sorted.crv").string();
+    CHECK(write_store(path, files, CarvingSummary()));
+
+    ResultStore store;
+    CHECK(store.open(path));
+    CHECK(store.size() == 4);
+    if (store.size() != 4) {
+        return;
+    }
+    CHECK(store.get(0).flags == (STORE_FOOTER_VALID | STORE_EXTRACTED));
+    CHECK(store.get(1).flags == (STORE_FOOTER_VALID | STORE_STRUCTURE | STORE_EXTRACTED | STORE_NESTED));
+    CHECK(store.get(2).flags == (STORE_EXTRACTED | STORE_FRAGMENTED));
+    CHECK(store.get(3).flags == (STORE_FOOTER_VALID | STORE_HASH | STORE_DUPLICATE));
+    CHECK(store.get(3).hash == 0x0123456789ABCDEFull);
+    CHECK(store.get(0).hash == 0);
+    CHECK(store.lower_bound(101) == 2);
+    CHECK(store.get_type_name(store.get(2).type_id) == "ZIP");
+}
+
+void test_empty(const fs::path& directory) {
+    std::string path = (directory / "empty.crv").string();
+    CHECK(write_store(path, {}, CarvingSummary()));
+
+    ResultStore store;
+    CHECK(store.open(path));
+    CHECK(store.size() == 0);
+    CHECK(store.lower_bound(0) == 0);
+    uint32_t type_id = 0;
+    CHECK(!store.find_type("JPEG", type_id));
+}
+
+void test_incomplete(const fs::path& directory) {
+    std::vector<CarvedFile> files = {make_file("PDF", 4096, 10000), make_file("PNG", 512, 2000)};
+
+    // Execução interrompida: os registros chegam ao disco, mas sem a assinatura do cabeçalho
+    std::string interrupted = (directory / "interrupted.crv").string();
+    {
+        std::unique_ptr<ResultSink> sink = ResultSink::create(ReportFormat::STORE, interrupted);
+        CHECK(sink != nullptr);
+        for (const auto& file : files) {
+            sink->add(file);
+        }
+    }
+    ResultStore store;
+    CHECK(!store.open(interrupted));
+
+    std::string complete = (directory / "complete.crv").string();
+    CHECK(write_store(complete, files, CarvingSummary()));
+    std::ifstream source(complete, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>());
+
+    std::string truncated = (directory / "truncated.crv").string();
+    {
+        std::ofstream file(truncated, std::ios::binary | std::ios::trunc);
+        file.write(content.data(), static_cast<std::streamsize>(content.size() - 4));
+    }
+    CHECK(!store.open(truncated));
+    CHECK(!store.open((directory / "missing.crv").string()));
+
+    CHECK(store.open(complete));
+    CHECK(store.size() == 2 && store.get(0).start_offset == 512 && store.get(1).start_offset == 4096);
+}
+
+} // namespace
+
+int main() {
+    TempDirectory directory("carver_result_store");
+    test_unsorted(directory.path());
+    test_sorted_and_flags(directory.path());
+    test_empty(directory.path());
+    test_incomplete(directory.path());
+    return test_result("result_store");
+}
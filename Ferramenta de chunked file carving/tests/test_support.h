@@ -0,0 +1,66 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <random>
+#include <filesystem>
+
+/**
+ * @brief Número de verificações que falharam no teste atual
+ */
+inline int& test_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+/**
+ * @brief Verifica uma condição; em caso de falha exibe o local e segue o teste
+ */
+#define CHECK(condition)                                                                          \
+    do {                                                                                          \
+        if (!(condition)) {                                                                       \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": falhou: " << #condition << std::endl;  \
+            test_failures()++;                                                                    \
+        }                                                                                         \
+    } while (0)
+
+/**
+ * @brief Resultado do teste para o main (0 = sucesso)
+ * @param name Nome do teste, exibido no resumo
+ */
+inline int test_result(const std::string& name) {
+    if (test_failures() == 0) {
+        std::cout << name << ": OK" << std::endl;
+        return 0;
+    }
+    std::cout << name << ": " << test_failures() << " falha(s)" << std::endl;
+    return 1;
+}
+
+/**
+ * @brief Diretório temporário exclusivo, removido com todo o conteúdo no fim do escopo
+ */
+class TempDirectory {
+private:
+    std::filesystem::path path_;
+
+public:
+    explicit TempDirectory(const std::string& prefix) {
+        std::random_device random;
+        do {
+            path_ = std::filesystem::temp_directory_path() / (prefix + "_" + std::to_string(random()));
+        } while (!std::filesystem::create_directory(path_));
+    }
+
+    ~TempDirectory() {
+        std::error_code error;
+        std::filesystem::remove_all(path_, error);
+    }
+
+    TempDirectory(const TempDirectory&) = delete;
+    TempDirectory& operator=(const TempDirectory&) = delete;
+
+    const std::filesystem::path& path() const {
+        return path_;
+    }
+};
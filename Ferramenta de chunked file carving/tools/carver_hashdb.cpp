@@ -0,0 +1,152 @@
+#include "known_hashes.h"
+#include "content_hash.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cctype>
+#include <cstdint>
+
+namespace fs = std::filesystem;
+
+void print_usage(const char* program) {
+    std::cout << "Uso: " << program << " <saída.khs> [opções]" << std::endl;
+    std::cout << "  --list <arquivo>      Lista de SHA-256: a primeira sequência de 64 dígitos hexadecimais" << std::endl;
+    std::cout << "                        de cada linha (saída de sha256sum, exportações do NSRL RDS com a" << std::endl;
+    std::cout << "                        coluna SHA-256, relatórios CSV/NDJSON de --sha256); '-' lê da" << std::endl;
+    std::cout << "                        entrada padrão. Linhas só com MD5/SHA-1 são ignoradas" << std::endl;
+    std::cout << "  --scan <diretório>    Calcula o SHA-256 de todos os arquivos (recursivo)" << std::endl;
+    std::cout << "  --bits <n>            Bits do filtro de Bloom por hash (padrão: 10)" << std::endl;
+}
+
+/**
+ * @brief Procura, na linha, uma sequência de exatamente 64 dígitos hexadecimais
+ *
+ * Sequências de outro tamanho (MD5, SHA-1, CRC32 de uma linha do NSRL) são
+ * puladas, de modo que a coluna SHA-256 é encontrada em qualquer posição.
+ */
+bool parse_hash_line(const std::string& line, Sha256Digest& hash) {
+    size_t position = 0;
+    while (position < line.size()) {
+        size_t begin = position;
+        while (position < line.size() && std::isxdigit(static_cast<unsigned char>(line[position]))) {
+            position++;
+        }
+        if (position - begin == 64) {
+            return parse_sha256(line.substr(begin, 64), hash);
+        }
+        position++;
+    }
+    return false;
+}
+
+bool load_list(const std::string& path, std::vector<Sha256Digest>& hashes) {
+    std::ifstream file;
+    if (path != "-") {
+        file.open(path);
+        if (!file.is_open()) {
+            std::cerr << "Erro ao abrir lista de hashes: " << path << std::endl;
+            return false;
+        }
+    }
+    std::istream& input = path == "-" ? std::cin : file;
+
+    std::string line;
+    Sha256Digest hash;
+    size_t ignored = 0;
+    while (std::getline(input, line)) {
+        if (parse_hash_line(line, hash)) {
+            hashes.push_back(hash);
+        } else if (line.find_first_not_of(" \t\r") != std::string::npos) {
+            ignored++;
+        }
+    }
+    if (ignored > 0) {
+        std::cout << path << ": " << ignored << " linhas sem SHA-256 ignoradas" << std::endl;
+    }
+    return true;
+}
+
+bool scan_directory(const std::string& path, std::vector<Sha256Digest>& hashes) {
+    std::error_code error;
+    fs::recursive_directory_iterator it(path, fs::directory_options::skip_permission_denied, error);
+    if (error) {
+        std::cerr << "Erro ao abrir diretório: " << path << " (" << error.message() << ")" << std::endl;
+        return false;
+    }
+
+    std::vector<char> buffer(1024 * 1024);
+    for (; it != fs::recursive_directory_iterator(); it.increment(error)) {
+        if (error) {
+            break;
+        }
+        if (!it->is_regular_file(error) || it->file_size(error) == 0) {
+            continue;
+        }
+
+        std::ifstream file(it->path(), std::ios::binary);
+        if (!file.is_open()) {
+            continue;
+        }
+        Sha256 sha;
+        while (file.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || file.gcount() > 0) {
+            sha.update(buffer.data(), static_cast<size_t>(file.gcount()));
+        }
+        hashes.push_back(sha.digest());
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::string output;
+    std::vector<Sha256Digest> hashes;
+    size_t bits_per_hash = 10;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (arg == "--list" && has_value) {
+            if (!load_list(argv[++i], hashes)) return 1;
+        } else if (arg == "--scan" && has_value) {
+            if (!scan_directory(argv[++i], hashes)) return 1;
+        } else if (arg == "--bits" && has_value) {
+            try {
+                bits_per_hash = std::stoul(argv[++i]);
+            } catch (const std::exception&) {
+                bits_per_hash = 0;
+            }
+            if (bits_per_hash == 0 || bits_per_hash > 64) {
+                std::cerr << "Erro: valor inválido para --bits" << std::endl;
+                return 1;
+            }
+        } else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg[0] != '-' && output.empty()) {
+            output = arg;
+        } else {
+            std::cerr << "Erro: argumento inválido: " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (output.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+    size_t read = hashes.size();
+    if (!KnownHashSet::build(output, hashes, bits_per_hash)) {
+        return 1;
+    }
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time);
+    std::cout << output << ": " << hashes.size() << " hashes (" << read - hashes.size() << " repetidos, "
+              << elapsed.count() << " ms)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,186 @@
+#include "result_store.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Filtros de uma consulta
+ */
+struct QueryConfig {
+    std::string store_file;
+    uint64_t range_begin = 0;
+    uint64_t range_end = UINT64_MAX;        // Exclusivo
+    std::vector<std::string> types;         // Vazio = todos
+    uint64_t min_size = 0;
+    uint64_t max_size = UINT64_MAX;
+    uint64_t limit = UINT64_MAX;
+    bool count_only = false;
+    bool summary = false;
+};
+
+void print_usage(const char* program) {
+    std::cout << "Uso: " << program << " <resultados.crv> [opções]" << std::endl;
+    std::cout << "  --range <início-fim>  Arquivos com offset inicial em [início, fim) (aceita 0x...)" << std::endl;
+    std::cout << "  --type <T1,T2>        Só os tipos indicados (ex: JPEG,PNG)" << std::endl;
+    std::cout << "  --min-size <bytes>    Tamanho mínimo" << std::endl;
+    std::cout << "  --max-size <bytes>    Tamanho máximo" << std::endl;
+    std::cout << "  --limit <n>           Exibe no máximo n arquivos" << std::endl;
+    std::cout << "  --count               Exibe só o número de arquivos encontrados" << std::endl;
+    std::cout << "  --summary             Exibe os totais gravados e a contagem por tipo" << std::endl;
+}
+
+/**
+ * @brief Lê um argumento numérico (decimal ou 0x...)
+ */
+bool parse_number(const std::string& text, uint64_t& value) {
+    try {
+        size_t used = 0;
+        unsigned long long parsed = std::stoull(text, &used, 0);
+        if (used != text.size()) return false;
+        value = static_cast<uint64_t>(parsed);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+/**
+ * @brief Lê uma faixa <início-fim>
+ */
+bool parse_range(const std::string& text, uint64_t& begin, uint64_t& end) {
+    size_t dash = text.find('-');
+    return dash != std::string::npos &&
+           parse_number(text.substr(0, dash), begin) &&
+           parse_number(text.substr(dash + 1), end) && begin < end;
+}
+
+std::string describe_flags(uint32_t flags) {
+    std::string out;
+    if (flags & STORE_FOOTER_VALID) out += 'F';
+    if (flags & STORE_STRUCTURE) out += 'S';
+    if (flags & STORE_EXTRACTED) out += 'E';
+    if (flags & STORE_FRAGMENTED) out += 'G';
+    if (flags & STORE_NESTED) out += 'N';
+    if (flags & STORE_DUPLICATE) out += 'D';
+    return out.empty() ? "-" : out;
+}
+
+int main(int argc, char* argv[]) {
+    QueryConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        uint64_t value = 0;
+        uint64_t end = 0;
+        bool has_value = i + 1 < argc;
+
+        if (arg == "--range" && has_value && parse_range(argv[++i], value, end)) {
+            config.range_begin = value;
+            config.range_end = end;
+        } else if (arg == "--type" && has_value) {
+            std::stringstream list(argv[++i]);
+            std::string type;
+            while (std::getline(list, type, ',')) {
+                if (!type.empty()) config.types.push_back(type);
+            }
+        } else if (arg == "--min-size" && has_value && parse_number(argv[++i], value)) {
+            config.min_size = value;
+        } else if (arg == "--max-size" && has_value && parse_number(argv[++i], value)) {
+            config.max_size = value;
+        } else if (arg == "--limit" && has_value && parse_number(argv[++i], value)) {
+            config.limit = value;
+        } else if (arg == "--count") {
+            config.count_only = true;
+        } else if (arg == "--summary") {
+            config.summary = true;
+        } else if (arg == "-h" || arg == "--help") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg[0] != '-' && config.store_file.empty()) {
+            config.store_file = arg;
+        } else {
+            std::cerr << "Erro: argumento inválido: " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (config.store_file.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+
+    ResultStore store;
+    if (!store.open(config.store_file)) {
+        return 1;
+    }
+
+    // Tipos pedidos que não aparecem no arquivo não têm resultados
+    std::vector<bool> wanted_types;
+    if (!config.types.empty()) {
+        for (const auto& type : config.types) {
+            uint32_t type_id;
+            if (!store.find_type(type, type_id)) continue;
+            if (wanted_types.size() <= type_id) wanted_types.resize(type_id + 1, false);
+            wanted_types[type_id] = true;
+        }
+    }
+
+    if (config.summary) {
+        const StoreHeader& header = store.get_header();
+        std::vector<uint64_t> counts;
+        for (size_t i = 0; i < store.size(); ++i) {
+            uint32_t type_id = store.get(i).type_id;
+            if (counts.size() <= type_id) counts.resize(type_id + 1, 0);
+            counts[type_id]++;
+        }
+        std::cout << "Arquivos encontrados: " << header.files_found << std::endl;
+        if (header.record_count < header.files_found) {
+            std::cout << "Registros gravados: " << header.record_count << " (limite do índice atingido)" << std::endl;
+        }
+        std::cout << "Arquivos extraídos: " << header.files_extracted << std::endl;
+        std::cout << "Bytes processados: " << header.bytes_processed << std::endl;
+        for (size_t type_id = 0; type_id < counts.size(); ++type_id) {
+            std::cout << "  " << store.get_type_name(static_cast<uint32_t>(type_id)) << ": "
+                      << counts[type_id] << std::endl;
+        }
+        return 0;
+    }
+
+    uint64_t matches = 0;
+    for (size_t position = store.lower_bound(config.range_begin); position < store.size(); ++position) {
+        const StoreRecord& record = store.get(position);
+        if (record.start_offset >= config.range_end) break;
+
+        if (!config.types.empty() &&
+            (record.type_id >= wanted_types.size() || !wanted_types[record.type_id])) continue;
+        if (record.file_size < config.min_size || record.file_size > config.max_size) continue;
+
+        if (!config.count_only) {
+            if (matches >= config.limit) break;
+            std::cout << "0x" << std::hex << record.start_offset << "\t0x" << record.end_offset << std::dec
+                      << "\t" << record.file_size
+                      << "\t" << store.get_type_name(record.type_id)
+                      << "\t" << describe_flags(record.flags);
+            if (record.flags & STORE_HASH) {
+                std::cout << "\t" << std::hex << std::setw(16) << std::setfill('0') << record.hash
+                          << std::dec << std::setfill(' ');
+            }
+            std::cout << std::endl;
+        }
+        matches++;
+    }
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time);
+    if (config.count_only) {
+        std::cout << matches << std::endl;
+    }
+    std::cerr << matches << " arquivos (" << elapsed.count() << " ms)" << std::endl;
+    return 0;
+}